@@ -13,8 +13,6 @@
 //
 //------------------------------------------------------------------------------
 
-#include "fields_alloc.hpp"
-
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
@@ -88,7 +86,7 @@ public:
     }
 
 private:
-    using alloc_t = fields_alloc<char>;
+    using alloc_t = beast::arena_allocator<char>;
     //using request_body_t = http::basic_dynamic_body<beast::flat_static_buffer<1024 * 1024>>;
     using request_body_t = http::string_body;
 
@@ -104,8 +102,11 @@ private:
     // The buffer for performing reads
     beast::flat_static_buffer<8192> buffer_;
 
+    // The arena holding the fields of the request and reply.
+    beast::monotonic_arena arena_{8192};
+
     // The allocator used for the fields in the request and reply.
-    alloc_t alloc_{8192};
+    alloc_t alloc_{arena_};
 
     // The parser for reading the requests
     boost::optional<http::request_parser<request_body_t, alloc_t>> parser_;
@@ -165,6 +166,11 @@ private:
         // We construct the dynamic body with a 1MB limit
         // to prevent vulnerability to buffer attacks.
         //
+        // The previous request and reply are gone, so the
+        // arena can be reused for the next pair.
+        parser_.reset();
+        arena_.reset();
+
         parser_.emplace(
             std::piecewise_construct,
             std::make_tuple(),
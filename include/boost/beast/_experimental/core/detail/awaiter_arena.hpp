@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_AWAITER_ARENA_HPP
+#define BOOST_BEAST_CORE_DETAIL_AWAITER_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  Memory for one asynchronous operation, held by its awaiter.
+
+    The composed operation, and the operations it starts one after
+    another, allocate from a fixed block. Memory freed in reverse
+    order of allocation is reused, and the block is reused as a
+    whole once nothing is allocated. Requests which do not fit are
+    forwarded to operator new, with the alignment when it exceeds
+    that of std::max_align_t.
+*/
+template<std::size_t Capacity>
+class awaiter_arena
+{
+    alignas(std::max_align_t) unsigned char buf_[Capacity];
+    std::size_t top_ = 0;
+    std::size_t live_ = 0;
+
+public:
+    awaiter_arena() = default;
+    awaiter_arena(awaiter_arena const&) = delete;
+    awaiter_arena& operator=(awaiter_arena const&) = delete;
+
+    void*
+    allocate(std::size_t n, std::size_t align)
+    {
+        auto const pos = (top_ + align - 1) & ~(align - 1);
+        if( align <= alignof(std::max_align_t) &&
+            pos <= Capacity && n <= Capacity - pos)
+        {
+            top_ = pos + n;
+            ++live_;
+            return buf_ + pos;
+        }
+        if(align > alignof(std::max_align_t))
+            return ::operator new(n, std::align_val_t{align});
+        return ::operator new(n);
+    }
+
+    void
+    deallocate(void* p, std::size_t n, std::size_t align) noexcept
+    {
+        auto const c = static_cast<unsigned char*>(p);
+        if(c < buf_ || c >= buf_ + Capacity)
+        {
+            if(align > alignof(std::max_align_t))
+                return ::operator delete(p, std::align_val_t{align});
+            return ::operator delete(p);
+        }
+        if(c + n == buf_ + top_)
+            top_ = static_cast<std::size_t>(c - buf_);
+        if(--live_ == 0)
+            top_ = 0;
+    }
+};
+
+// An Allocator which uses an awaiter_arena
+template<class T, std::size_t Capacity>
+class awaiter_allocator
+{
+    template<class U, std::size_t>
+    friend class awaiter_allocator;
+
+    awaiter_arena<Capacity>* a_;
+
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = awaiter_allocator<U, Capacity>;
+    };
+
+    explicit
+    awaiter_allocator(awaiter_arena<Capacity>& a) noexcept
+        : a_(&a)
+    {
+    }
+
+    template<class U>
+    awaiter_allocator(
+        awaiter_allocator<U, Capacity> const& other) noexcept
+        : a_(other.a_)
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        return static_cast<T*>(
+            a_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        a_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    friend
+    bool
+    operator==(
+        awaiter_allocator const& lhs,
+        awaiter_allocator const& rhs) noexcept
+    {
+        return lhs.a_ == rhs.a_;
+    }
+
+    friend
+    bool
+    operator!=(
+        awaiter_allocator const& lhs,
+        awaiter_allocator const& rhs) noexcept
+    {
+        return lhs.a_ != rhs.a_;
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,326 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_URING_SERVICE_HPP
+#define BOOST_BEAST_CORE_DETAIL_URING_SERVICE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+
+// Linux 6.0 added the multishot receive
+#ifndef BOOST_BEAST_HAS_IO_URING
+# if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#   include <linux/io_uring.h>
+#   ifdef IORING_RECV_MULTISHOT
+#    define BOOST_BEAST_HAS_IO_URING 1
+#   endif
+#  endif
+# endif
+#endif
+#ifndef BOOST_BEAST_HAS_IO_URING
+# define BOOST_BEAST_HAS_IO_URING 0
+#endif
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/beast/core/detail/service_base.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/saved_handler.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+class uring_service;
+
+// An operation submitted to the ring
+struct uring_op
+{
+    void (*on_complete)(uring_op*, int res, unsigned flags) = nullptr;
+};
+
+// The state of one stream, shared with its pending operations
+class uring_impl
+    : public std::enable_shared_from_this<uring_impl>
+{
+public:
+    static std::size_t constexpr max_iov = 16;
+
+    // One pending read or write
+    struct slot : uring_op
+    {
+        uring_impl* impl = nullptr;
+        saved_handler h;
+        ::iovec iov[max_iov];
+        std::size_t n = 0;      // elements of iov used
+        ::msghdr msg;
+        int res = 0;            // the result, as from the syscall
+        bool in_ring = false;   // an entry is submitted
+    };
+
+    BOOST_BEAST_DECL
+    explicit
+    uring_impl(net::io_context& ioc);
+
+    BOOST_BEAST_DECL
+    ~uring_impl();
+
+    uring_service& svc;
+    int fd = -1;
+    slot rd;
+    slot wr;
+
+    bool
+    multishot() const noexcept
+    {
+        return multishot_;
+    }
+
+private:
+    friend class uring_service;
+
+    struct ms_op : uring_op
+    {
+        uring_impl* impl = nullptr;
+        bool in_ring = false;
+    };
+
+    struct chunk
+    {
+        std::uint16_t bid;
+        std::uint32_t size;
+        std::uint32_t pos;
+    };
+
+    uring_impl* prev_ = nullptr;
+    uring_impl* next_ = nullptr;
+
+    // Multishot receive
+    ms_op ms_;
+    std::shared_ptr<uring_impl> ms_self_;   // keeps *this while armed
+    std::deque<chunk> chunks_;
+    error_code ms_ec_;
+    bool multishot_ = false;
+    bool rd_waiting_ = false;   // rd.h waits for the multishot receive
+    bool rd_chunks_ = false;    // rd.h reads from chunks_
+    bool rd_aborted_ = false;
+
+    // Registered buffer
+    int buf_index_ = -1;
+    char const* buf_data_ = nullptr;
+    std::size_t buf_size_ = 0;
+};
+
+/*  Owns the io_uring instance used by the streams of one io_context.
+
+    Submissions are batched: entries are added to the submission
+    queue as operations start, and handed to the kernel with one
+    system call once the current handler returns. Completions are
+    signaled on an eventfd, which the io_context waits on while
+    any entry is outstanding.
+*/
+class uring_service
+    : public service_base<uring_service>
+{
+public:
+    BOOST_BEAST_DECL
+    explicit
+    uring_service(net::io_context& ioc);
+
+    BOOST_BEAST_DECL
+    ~uring_service();
+
+    // Start a read into impl.rd, or arrange for rd.h to
+    // be invoked with the result. rd.h must be set first.
+    BOOST_BEAST_DECL
+    void
+    read(uring_impl& impl);
+
+    // Start a write from impl.wr. wr.h must be set first.
+    BOOST_BEAST_DECL
+    void
+    write(uring_impl& impl);
+
+    // Called by the resumed read, returns its result
+    BOOST_BEAST_DECL
+    std::size_t
+    read_result(uring_impl& impl, error_code& ec);
+
+    // Cancel every operation on the stream, and submit now
+    BOOST_BEAST_DECL
+    void
+    cancel(uring_impl& impl);
+
+    BOOST_BEAST_DECL
+    void
+    multishot(uring_impl& impl, bool v);
+
+    BOOST_BEAST_DECL
+    void
+    register_buffer(uring_impl& impl,
+        void* data, std::size_t size, error_code& ec);
+
+    BOOST_BEAST_DECL
+    void
+    unregister_buffer(uring_impl& impl);
+
+private:
+    friend class uring_impl;
+
+    static std::size_t constexpr fixed_buffers = 64;
+    static unsigned constexpr pbuf_count = 128;
+    static std::size_t constexpr pbuf_size = 16384;
+
+    // A completion taken from the queue
+    struct completion
+    {
+        std::uint64_t user_data;
+        int res;
+        unsigned flags;
+    };
+
+    net::io_context& ioc_;
+    std::mutex m_;
+    int ring_fd_ = -1;
+    net::posix::stream_descriptor ev_;
+
+    // Submission queue
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* sq_array_ = nullptr;
+    ::io_uring_sqe* sqes_ = nullptr;
+    unsigned tail_ = 0;         // the next entry to fill
+
+    // Completion queue
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    ::io_uring_cqe* cqes_ = nullptr;
+
+    void* sq_ptr_ = nullptr;
+    std::size_t sq_size_ = 0;
+    void* cq_ptr_ = nullptr;
+    std::size_t cq_size_ = 0;
+    std::size_t sqes_size_ = 0;
+
+    // Provided buffers for multishot receive
+    ::io_uring_buf_ring* pbuf_ring_ = nullptr;
+    char* pbuf_data_ = nullptr;
+    std::uint16_t pbuf_tail_ = 0;
+
+    std::vector<bool> fixed_;   // registered buffer slots in use
+
+    // Completions reaped while a stream waited for its own
+    std::vector<completion> deferred_;
+
+    uring_impl* list_ = nullptr;
+    std::size_t outstanding_ = 0;
+    bool waiting_ = false;
+    bool flush_pending_ = false;
+    bool shutdown_ = false;
+
+    BOOST_BEAST_DECL
+    void
+    shutdown() override;
+
+    BOOST_BEAST_DECL
+    void
+    close_ring();
+
+    BOOST_BEAST_DECL
+    ::io_uring_sqe*
+    get_sqe();
+
+    BOOST_BEAST_DECL
+    void
+    push_sqe(::io_uring_sqe* sqe, uring_op* op);
+
+    BOOST_BEAST_DECL
+    void
+    submit();
+
+    BOOST_BEAST_DECL
+    void
+    schedule_flush();
+
+    BOOST_BEAST_DECL
+    void
+    wait();
+
+    BOOST_BEAST_DECL
+    void
+    on_event();
+
+    BOOST_BEAST_DECL
+    bool
+    reap();
+
+    BOOST_BEAST_DECL
+    void
+    drain(uring_impl& impl);
+
+    BOOST_BEAST_DECL
+    void
+    post_invoke(uring_impl::slot& s);
+
+    BOOST_BEAST_DECL
+    void
+    start_read(uring_impl& impl);
+
+    BOOST_BEAST_DECL
+    void
+    cancel_op(uring_op* op);
+
+    BOOST_BEAST_DECL
+    void
+    arm_multishot(uring_impl& impl);
+
+    BOOST_BEAST_DECL
+    void
+    setup_pbuf();
+
+    BOOST_BEAST_DECL
+    void
+    recycle(std::uint16_t bid);
+
+    BOOST_BEAST_DECL
+    static
+    void
+    on_slot(uring_op* op, int res, unsigned flags);
+
+    BOOST_BEAST_DECL
+    static
+    void
+    on_multishot(uring_op* op, int res, unsigned flags);
+};
+
+} // detail
+} // beast
+} // boost
+
+#if BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/_experimental/core/detail/uring_service.ipp>
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,922 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_URING_SERVICE_IPP
+#define BOOST_BEAST_CORE_DETAIL_URING_SERVICE_IPP
+
+#include <boost/beast/_experimental/core/detail/uring_service.hpp>
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+inline
+int
+uring_setup(unsigned entries, ::io_uring_params* p)
+{
+    return static_cast<int>(::syscall(
+        __NR_io_uring_setup, entries, p));
+}
+
+inline
+int
+uring_enter(int fd, unsigned to_submit)
+{
+    return static_cast<int>(::syscall(
+        __NR_io_uring_enter, fd, to_submit, 0, 0, nullptr, 0));
+}
+
+inline
+int
+uring_wait(int fd)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter,
+        fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+inline
+int
+uring_register(int fd, unsigned opcode, void const* arg, unsigned n)
+{
+    return static_cast<int>(::syscall(
+        __NR_io_uring_register, fd, opcode, arg, n));
+}
+
+inline
+void
+throw_uring_error(int ev)
+{
+    BOOST_THROW_EXCEPTION(system_error(
+        error_code(ev, system_category())));
+}
+
+//------------------------------------------------------------------------------
+
+uring_impl::
+uring_impl(net::io_context& ioc)
+    : svc(net::use_service<uring_service>(ioc))
+{
+    rd.impl = this;
+    rd.on_complete = &uring_service::on_slot;
+    wr.impl = this;
+    wr.on_complete = &uring_service::on_slot;
+    ms_.impl = this;
+    ms_.on_complete = &uring_service::on_multishot;
+    std::lock_guard<std::mutex> g(svc.m_);
+    next_ = svc.list_;
+    if(next_)
+        next_->prev_ = this;
+    svc.list_ = this;
+}
+
+uring_impl::
+~uring_impl()
+{
+    // The kernel may still write into the
+    // registered buffer or the chunks.
+    svc.drain(*this);
+    if(buf_index_ >= 0)
+        svc.unregister_buffer(*this);
+    std::lock_guard<std::mutex> g(svc.m_);
+    for(auto const& c : chunks_)
+        svc.recycle(c.bid);
+    if(prev_)
+        prev_->next_ = next_;
+    else
+        svc.list_ = next_;
+    if(next_)
+        next_->prev_ = prev_;
+}
+
+//------------------------------------------------------------------------------
+
+uring_service::
+uring_service(net::io_context& ioc)
+    : service_base<uring_service>(ioc)
+    , ioc_(ioc)
+    , ev_(ioc)
+{
+    ::io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    ring_fd_ = uring_setup(256, &p);
+    if(ring_fd_ < 0)
+        throw_uring_error(errno);
+
+    sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(::io_uring_cqe);
+    bool const single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if(single && cq_size_ > sq_size_)
+        sq_size_ = cq_size_;
+    sqes_size_ = p.sq_entries * sizeof(::io_uring_sqe);
+
+    auto const map =
+        [this](std::size_t size, off_t off)
+        {
+            auto const ptr = ::mmap(nullptr, size,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring_fd_, off);
+            if(ptr == MAP_FAILED)
+            {
+                auto const ev = errno;
+                close_ring();
+                throw_uring_error(ev);
+            }
+            return ptr;
+        };
+    sq_ptr_ = map(sq_size_, IORING_OFF_SQ_RING);
+    cq_ptr_ = single ? sq_ptr_ : map(cq_size_, IORING_OFF_CQ_RING);
+    sqes_ = static_cast<::io_uring_sqe*>(
+        map(sqes_size_, IORING_OFF_SQES));
+
+    auto const sq = static_cast<char*>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_entries_ = p.sq_entries;
+    sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    tail_ = *sq_tail_;
+
+    auto const cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<::io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    int const efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(efd < 0 || uring_register(ring_fd_,
+        IORING_REGISTER_EVENTFD, &efd, 1) < 0)
+    {
+        auto const ev = errno;
+        if(efd >= 0)
+            ::close(efd);
+        close_ring();
+        throw_uring_error(ev);
+    }
+    ev_.assign(efd);
+}
+
+uring_service::
+~uring_service()
+{
+    close_ring();
+}
+
+void
+uring_service::
+close_ring()
+{
+    // Closing the ring ends every operation still in it
+    if(ring_fd_ >= 0)
+        ::close(ring_fd_);
+    ring_fd_ = -1;
+    if(sqes_)
+        ::munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+    if(cq_ptr_ && cq_ptr_ != sq_ptr_)
+        ::munmap(cq_ptr_, cq_size_);
+    cq_ptr_ = nullptr;
+    if(sq_ptr_)
+        ::munmap(sq_ptr_, sq_size_);
+    sq_ptr_ = nullptr;
+    if(pbuf_ring_)
+    {
+        ::munmap(pbuf_ring_, pbuf_count * sizeof(::io_uring_buf));
+        ::munmap(pbuf_data_, pbuf_count * pbuf_size);
+    }
+    pbuf_ring_ = nullptr;
+}
+
+void
+uring_service::
+shutdown()
+{
+    // Destroy the handlers outside the lock, since
+    // destroying one may destroy a stream's state.
+    std::vector<saved_handler> hv;
+    std::vector<std::shared_ptr<uring_impl>> sv;
+    {
+        std::lock_guard<std::mutex> g(m_);
+        shutdown_ = true;
+        for(auto p = list_; p; p = p->next_)
+        {
+            hv.emplace_back(std::move(p->rd.h));
+            hv.emplace_back(std::move(p->wr.h));
+            sv.emplace_back(std::move(p->ms_self_));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void
+uring_service::
+read(uring_impl& impl)
+{
+    std::lock_guard<std::mutex> g(m_);
+    auto& s = impl.rd;
+    impl.rd_chunks_ = false;
+    if(! impl.chunks_.empty() || (impl.multishot_ && impl.ms_ec_))
+    {
+        impl.rd_chunks_ = true;
+        return post_invoke(s);
+    }
+    if(impl.multishot_ || impl.ms_self_)
+    {
+        // Wait for the multishot receive, or
+        // for its cancellation to finish.
+        impl.rd_waiting_ = true;
+        if(! impl.ms_self_)
+            arm_multishot(impl);
+        return;
+    }
+    start_read(impl);
+}
+
+void
+uring_service::
+start_read(uring_impl& impl)
+{
+    auto& s = impl.rd;
+    auto const sqe = get_sqe();
+    if(! sqe)
+    {
+        s.res = -EBUSY;
+        return post_invoke(s);
+    }
+    sqe->fd = impl.fd;
+    if(s.n == 1)
+    {
+        auto const p = static_cast<char const*>(s.iov[0].iov_base);
+        auto const n = s.iov[0].iov_len;
+        if( impl.buf_index_ >= 0 &&
+            p >= impl.buf_data_ &&
+            p <= impl.buf_data_ + impl.buf_size_ &&
+            n <= impl.buf_size_ -
+                static_cast<std::size_t>(p - impl.buf_data_))
+        {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->buf_index = static_cast<std::uint16_t>(
+                impl.buf_index_);
+        }
+        else
+        {
+            sqe->opcode = IORING_OP_RECV;
+        }
+        sqe->addr = reinterpret_cast<std::uintptr_t>(p);
+        sqe->len = static_cast<std::uint32_t>(n);
+    }
+    else
+    {
+        std::memset(&s.msg, 0, sizeof(s.msg));
+        s.msg.msg_iov = s.iov;
+        s.msg.msg_iovlen = s.n;
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(&s.msg);
+        sqe->len = 1;
+    }
+    s.in_ring = true;
+    push_sqe(sqe, &s);
+}
+
+void
+uring_service::
+write(uring_impl& impl)
+{
+    std::lock_guard<std::mutex> g(m_);
+    auto& s = impl.wr;
+    auto const sqe = get_sqe();
+    if(! sqe)
+    {
+        s.res = -EBUSY;
+        return post_invoke(s);
+    }
+    sqe->fd = impl.fd;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    if(s.n == 1)
+    {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(
+            s.iov[0].iov_base);
+        sqe->len = static_cast<std::uint32_t>(s.iov[0].iov_len);
+    }
+    else
+    {
+        std::memset(&s.msg, 0, sizeof(s.msg));
+        s.msg.msg_iov = s.iov;
+        s.msg.msg_iovlen = s.n;
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(&s.msg);
+        sqe->len = 1;
+    }
+    s.in_ring = true;
+    push_sqe(sqe, &s);
+}
+
+std::size_t
+uring_service::
+read_result(uring_impl& impl, error_code& ec)
+{
+    auto& s = impl.rd;
+    if(! impl.rd_chunks_)
+    {
+        if(s.res < 0)
+        {
+            ec.assign(-s.res, system_category());
+            return 0;
+        }
+        if(s.res == 0)
+        {
+            ec = net::error::eof;
+            return 0;
+        }
+        ec = {};
+        return static_cast<std::size_t>(s.res);
+    }
+
+    std::lock_guard<std::mutex> g(m_);
+    impl.rd_chunks_ = false;
+    if(impl.rd_aborted_)
+    {
+        impl.rd_aborted_ = false;
+        ec = net::error::operation_aborted;
+        return 0;
+    }
+    std::size_t total = 0;
+    for(std::size_t i = 0; i < s.n; ++i)
+    {
+        auto p = static_cast<char*>(s.iov[i].iov_base);
+        auto room = s.iov[i].iov_len;
+        while(room > 0 && ! impl.chunks_.empty())
+        {
+            auto& c = impl.chunks_.front();
+            std::size_t n = c.size - c.pos;
+            if(n > room)
+                n = room;
+            std::memcpy(p, pbuf_data_ +
+                c.bid * pbuf_size + c.pos, n);
+            p += n;
+            room -= n;
+            total += n;
+            c.pos += static_cast<std::uint32_t>(n);
+            if(c.pos == c.size)
+            {
+                recycle(c.bid);
+                impl.chunks_.pop_front();
+            }
+        }
+    }
+    if(total == 0)
+        ec = impl.ms_ec_;
+    else
+        ec = {};
+    return total;
+}
+
+void
+uring_service::
+cancel(uring_impl& impl)
+{
+    std::lock_guard<std::mutex> g(m_);
+    if(impl.rd.in_ring)
+        cancel_op(&impl.rd);
+    if(impl.wr.in_ring)
+        cancel_op(&impl.wr);
+    if(impl.ms_self_)
+        cancel_op(&impl.ms_);
+    if(impl.rd_waiting_)
+    {
+        impl.rd_waiting_ = false;
+        impl.rd_chunks_ = true;
+        impl.rd_aborted_ = true;
+        post_invoke(impl.rd);
+    }
+    // The file descriptor may be closed next
+    submit();
+}
+
+void
+uring_service::
+multishot(uring_impl& impl, bool v)
+{
+    std::lock_guard<std::mutex> g(m_);
+    if(v && ! pbuf_ring_)
+        setup_pbuf();
+    impl.multishot_ = v;
+    if(! v && impl.ms_self_)
+    {
+        cancel_op(&impl.ms_);
+        submit();
+    }
+}
+
+void
+uring_service::
+register_buffer(uring_impl& impl,
+    void* data, std::size_t size, error_code& ec)
+{
+    std::lock_guard<std::mutex> g(m_);
+    if(fixed_.empty())
+    {
+        ::io_uring_rsrc_register r;
+        std::memset(&r, 0, sizeof(r));
+        r.nr = fixed_buffers;
+        r.flags = IORING_RSRC_REGISTER_SPARSE;
+        if(uring_register(ring_fd_,
+            IORING_REGISTER_BUFFERS2, &r, sizeof(r)) < 0)
+        {
+            ec.assign(errno, system_category());
+            return;
+        }
+        fixed_.resize(fixed_buffers);
+    }
+    auto index = impl.buf_index_;
+    if(index < 0)
+    {
+        for(std::size_t i = 0; i < fixed_.size(); ++i)
+        {
+            if(! fixed_[i])
+            {
+                index = static_cast<int>(i);
+                break;
+            }
+        }
+        if(index < 0)
+        {
+            ec = net::error::no_buffer_space;
+            return;
+        }
+    }
+    ::iovec v;
+    v.iov_base = data;
+    v.iov_len = size;
+    ::io_uring_rsrc_update2 u;
+    std::memset(&u, 0, sizeof(u));
+    u.offset = static_cast<std::uint32_t>(index);
+    u.data = reinterpret_cast<std::uintptr_t>(&v);
+    u.nr = 1;
+    if(uring_register(ring_fd_,
+        IORING_REGISTER_BUFFERS_UPDATE, &u, sizeof(u)) < 0)
+    {
+        ec.assign(errno, system_category());
+        return;
+    }
+    fixed_[index] = true;
+    impl.buf_index_ = index;
+    impl.buf_data_ = static_cast<char const*>(data);
+    impl.buf_size_ = size;
+    ec = {};
+}
+
+void
+uring_service::
+unregister_buffer(uring_impl& impl)
+{
+    std::lock_guard<std::mutex> g(m_);
+    if(impl.buf_index_ < 0)
+        return;
+    // A read already submitted keeps its buffer
+    ::iovec v;
+    std::memset(&v, 0, sizeof(v));
+    ::io_uring_rsrc_update2 u;
+    std::memset(&u, 0, sizeof(u));
+    u.offset = static_cast<std::uint32_t>(impl.buf_index_);
+    u.data = reinterpret_cast<std::uintptr_t>(&v);
+    u.nr = 1;
+    uring_register(ring_fd_,
+        IORING_REGISTER_BUFFERS_UPDATE, &u, sizeof(u));
+    fixed_[impl.buf_index_] = false;
+    impl.buf_index_ = -1;
+    impl.buf_data_ = nullptr;
+    impl.buf_size_ = 0;
+}
+
+//------------------------------------------------------------------------------
+
+::io_uring_sqe*
+uring_service::
+get_sqe()
+{
+    if(tail_ - __atomic_load_n(
+        sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+    {
+        // Full, so hand the kernel what is there now
+        submit();
+        if(tail_ - __atomic_load_n(
+            sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+            return nullptr;
+    }
+    auto const sqe = &sqes_[tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+void
+uring_service::
+push_sqe(::io_uring_sqe* sqe, uring_op* op)
+{
+    sqe->user_data = reinterpret_cast<std::uintptr_t>(op);
+    sq_array_[tail_ & sq_mask_] = tail_ & sq_mask_;
+    ++tail_;
+    __atomic_store_n(sq_tail_, tail_, __ATOMIC_RELEASE);
+    ++outstanding_;
+    schedule_flush();
+    wait();
+}
+
+void
+uring_service::
+submit()
+{
+    for(;;)
+    {
+        auto const n = tail_ - __atomic_load_n(
+            sq_head_, __ATOMIC_ACQUIRE);
+        if(n == 0)
+            return;
+        auto const used = uring_enter(ring_fd_, n);
+        if(used < 0 && errno == EINTR)
+            continue;
+        // On failure, try again after completions are reaped
+        if(used <= 0)
+            return;
+    }
+}
+
+void
+uring_service::
+schedule_flush()
+{
+    // Entries added until the current handler
+    // returns are submitted together.
+    if(flush_pending_)
+        return;
+    flush_pending_ = true;
+    net::post(ioc_,
+        [this]
+        {
+            std::lock_guard<std::mutex> g(m_);
+            flush_pending_ = false;
+            submit();
+        });
+}
+
+void
+uring_service::
+wait()
+{
+    if(waiting_ || shutdown_ || outstanding_ == 0)
+        return;
+    waiting_ = true;
+    ev_.async_wait(net::posix::stream_descriptor::wait_read,
+        [this](error_code ec)
+        {
+            if(ec)
+                return;
+            // Reset the counter before reaping, so the next wait
+            // completes only for completions posted after this one.
+            std::uint64_t count;
+            if(::read(ev_.native_handle(),
+                    &count, sizeof(count)) < 0)
+                BOOST_ASSERT(errno == EAGAIN);
+            {
+                std::lock_guard<std::mutex> g(m_);
+                waiting_ = false;
+            }
+            on_event();
+        });
+}
+
+void
+uring_service::
+on_event()
+{
+    while(reap())
+    {
+    }
+    std::lock_guard<std::mutex> g(m_);
+    // Completion handlers usually start new operations
+    submit();
+    wait();
+    // Completions posted between reaping and starting the wait
+    // signaled the eventfd before anyone waited on it, and an
+    // edge-triggered reactor does not report that signal again.
+    if( waiting_ && *cq_head_ != __atomic_load_n(
+            cq_tail_, __ATOMIC_ACQUIRE))
+        net::post(ioc_, [this]{ on_event(); });
+}
+
+bool
+uring_service::
+reap()
+{
+    completion v[64];
+    std::size_t n = 0;
+    {
+        std::lock_guard<std::mutex> g(m_);
+        // Already counted when they were set aside
+        while(n < deferred_.size() && n < 64)
+        {
+            v[n] = deferred_[n];
+            ++n;
+        }
+        deferred_.erase(deferred_.begin(),
+            deferred_.begin() + static_cast<std::ptrdiff_t>(n));
+        auto head = *cq_head_;
+        auto const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while(head != tail && n < 64)
+        {
+            auto const& cqe = cqes_[head & cq_mask_];
+            v[n].user_data = cqe.user_data;
+            v[n].res = cqe.res;
+            v[n].flags = cqe.flags;
+            if(! (cqe.flags & IORING_CQE_F_MORE))
+                --outstanding_;
+            ++n;
+            ++head;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        // Cancellations have no operation
+        if(v[i].user_data == 0)
+            continue;
+        auto const op = reinterpret_cast<uring_op*>(
+            static_cast<std::uintptr_t>(v[i].user_data));
+        op->on_complete(op, v[i].res, v[i].flags);
+    }
+    return n > 0;
+}
+
+void
+uring_service::
+drain(uring_impl& impl)
+{
+    std::lock_guard<std::mutex> g(m_);
+    auto const busy =
+        [&impl]
+        {
+            return impl.rd.in_ring ||
+                impl.wr.in_ring || impl.ms_.in_ring;
+        };
+    if(! busy())
+        return;
+    if(impl.rd.in_ring)
+        cancel_op(&impl.rd);
+    if(impl.wr.in_ring)
+        cancel_op(&impl.wr);
+    if(impl.ms_.in_ring)
+        cancel_op(&impl.ms_);
+    submit();
+    // Completions for other streams are kept
+    // for the next reap, since their handlers
+    // must not run inside this destructor.
+    while(busy())
+    {
+        if(uring_wait(ring_fd_) < 0 && errno != EINTR)
+            break;
+        auto head = *cq_head_;
+        auto const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while(head != tail)
+        {
+            auto const& cqe = cqes_[head & cq_mask_];
+            auto const op = reinterpret_cast<uring_op*>(
+                static_cast<std::uintptr_t>(cqe.user_data));
+            if(! (cqe.flags & IORING_CQE_F_MORE))
+                --outstanding_;
+            if(op == &impl.rd)
+            {
+                impl.rd.in_ring = false;
+            }
+            else if(op == &impl.wr)
+            {
+                impl.wr.in_ring = false;
+            }
+            else if(op == &impl.ms_)
+            {
+                if(cqe.flags & IORING_CQE_F_BUFFER)
+                    recycle(static_cast<std::uint16_t>(
+                        cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                if(! (cqe.flags & IORING_CQE_F_MORE))
+                    impl.ms_.in_ring = false;
+            }
+            else if(op)
+            {
+                completion c;
+                c.user_data = cqe.user_data;
+                c.res = cqe.res;
+                c.flags = cqe.flags;
+                deferred_.push_back(c);
+            }
+            ++head;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    if(! deferred_.empty() && ! shutdown_)
+        net::post(ioc_, [this]{ on_event(); });
+}
+
+void
+uring_service::
+post_invoke(uring_impl::slot& s)
+{
+    // The handler keeps the slot alive
+    net::post(ioc_,
+        [&s]
+        {
+            s.h.invoke();
+        });
+}
+
+void
+uring_service::
+cancel_op(uring_op* op)
+{
+    auto const sqe = get_sqe();
+    if(! sqe)
+        return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<std::uintptr_t>(op);
+    push_sqe(sqe, nullptr);
+}
+
+void
+uring_service::
+arm_multishot(uring_impl& impl)
+{
+    auto const sqe = get_sqe();
+    if(! sqe)
+    {
+        if(impl.rd_waiting_)
+        {
+            impl.rd_waiting_ = false;
+            impl.rd.res = -EBUSY;
+            post_invoke(impl.rd);
+        }
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = impl.fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    impl.ms_self_ = impl.shared_from_this();
+    impl.ms_.in_ring = true;
+    push_sqe(sqe, &impl.ms_);
+}
+
+void
+uring_service::
+setup_pbuf()
+{
+    auto const ring_bytes = pbuf_count * sizeof(::io_uring_buf);
+    auto const data_bytes = pbuf_count * pbuf_size;
+    auto const ring = ::mmap(nullptr, ring_bytes,
+        PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(ring == MAP_FAILED)
+        throw_uring_error(errno);
+    auto const data = ::mmap(nullptr, data_bytes,
+        PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if(data == MAP_FAILED)
+    {
+        auto const ev = errno;
+        ::munmap(ring, ring_bytes);
+        throw_uring_error(ev);
+    }
+    ::io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<std::uintptr_t>(ring);
+    reg.ring_entries = pbuf_count;
+    reg.bgid = 0;
+    if(uring_register(ring_fd_,
+        IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        auto const ev = errno;
+        ::munmap(data, data_bytes);
+        ::munmap(ring, ring_bytes);
+        throw_uring_error(ev);
+    }
+    pbuf_ring_ = static_cast<::io_uring_buf_ring*>(ring);
+    pbuf_data_ = static_cast<char*>(data);
+    for(unsigned i = 0; i < pbuf_count; ++i)
+        recycle(static_cast<std::uint16_t>(i));
+}
+
+void
+uring_service::
+recycle(std::uint16_t bid)
+{
+    // The tail overlays the first entry's reserved
+    // field, so only the other fields are written.
+    auto& b = pbuf_ring_->bufs[pbuf_tail_ & (pbuf_count - 1)];
+    b.addr = reinterpret_cast<std::uintptr_t>(
+        pbuf_data_ + bid * pbuf_size);
+    b.len = static_cast<std::uint32_t>(pbuf_size);
+    b.bid = bid;
+    ++pbuf_tail_;
+    __atomic_store_n(&pbuf_ring_->tail,
+        pbuf_tail_, __ATOMIC_RELEASE);
+}
+
+void
+uring_service::
+on_slot(uring_op* op, int res, unsigned)
+{
+    auto& s = *static_cast<uring_impl::slot*>(op);
+    {
+        std::lock_guard<std::mutex> g(s.impl->svc.m_);
+        s.in_ring = false;
+    }
+    s.res = res;
+    s.h.invoke();
+}
+
+void
+uring_service::
+on_multishot(uring_op* op, int res, unsigned flags)
+{
+    auto& impl = *static_cast<uring_impl::ms_op*>(op)->impl;
+    auto& svc = impl.svc;
+    std::shared_ptr<uring_impl> self;
+    saved_handler h;
+    {
+        std::lock_guard<std::mutex> g(svc.m_);
+        if(res > 0)
+        {
+            BOOST_ASSERT(flags & IORING_CQE_F_BUFFER);
+            uring_impl::chunk c;
+            c.bid = static_cast<std::uint16_t>(
+                flags >> IORING_CQE_BUFFER_SHIFT);
+            c.size = static_cast<std::uint32_t>(res);
+            c.pos = 0;
+            impl.chunks_.push_back(c);
+        }
+        else if(res == 0)
+        {
+            impl.ms_ec_ = net::error::eof;
+        }
+        else if(res != -ENOBUFS && res != -ECANCELED)
+        {
+            impl.ms_ec_.assign(-res, system_category());
+        }
+        bool const more = (flags & IORING_CQE_F_MORE) != 0;
+        if(! more)
+        {
+            impl.ms_.in_ring = false;
+            self = std::move(impl.ms_self_);
+        }
+        if(impl.rd_waiting_)
+        {
+            if(! impl.chunks_.empty() || impl.ms_ec_)
+            {
+                impl.rd_waiting_ = false;
+                impl.rd_chunks_ = true;
+                h = std::move(impl.rd.h);
+            }
+            else if(! more)
+            {
+                // Out of provided buffers, or no longer
+                // multishot, so receive into the caller's.
+                if(! impl.multishot_ || res == -ENOBUFS)
+                {
+                    impl.rd_waiting_ = false;
+                    svc.start_read(impl);
+                }
+                else
+                {
+                    svc.arm_multishot(impl);
+                }
+            }
+        }
+    }
+    if(h.has_value())
+        h.invoke();
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_URING_STREAM_HPP
+#define BOOST_BEAST_CORE_IMPL_URING_STREAM_HPP
+
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/detail/get_io_context.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/beast/websocket/teardown.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+template<class Executor>
+template<bool isRead, class Buffers, class Handler>
+class basic_uring_stream<Executor>::transfer_op
+    : public async_base<Handler, Executor>
+{
+    std::shared_ptr<detail::uring_impl> impl_;
+    Buffers b_;
+
+    detail::uring_impl::slot&
+    slot() noexcept
+    {
+        return isRead ? impl_->rd : impl_->wr;
+    }
+
+public:
+    template<class Handler_>
+    transfer_op(
+        Handler_&& h,
+        basic_uring_stream& s,
+        Buffers const& b)
+        : async_base<Handler, Executor>(
+            std::forward<Handler_>(h), s.get_executor())
+        , impl_(s.impl_)
+        , b_(b)
+    {
+        auto& sl = slot();
+        sl.n = 0;
+        auto it = net::buffer_sequence_begin(b_);
+        auto const end = net::buffer_sequence_end(b_);
+        for(; it != end && sl.n < detail::uring_impl::max_iov; ++it)
+        {
+            net::const_buffer const cb = *it;
+            if(cb.size() == 0)
+                continue;
+            sl.iov[sl.n].iov_base = const_cast<void*>(cb.data());
+            sl.iov[sl.n].iov_len = cb.size();
+            ++sl.n;
+        }
+        if(sl.n == 0)
+        {
+            this->complete(false, error_code{}, 0);
+            return;
+        }
+        if(! s.socket_.is_open())
+        {
+            this->complete(false, net::error::bad_descriptor, 0);
+            return;
+        }
+        impl_->fd = s.socket_.native_handle();
+
+        // The slot owns the operation until the ring completes it
+        auto& impl = *impl_;
+        sl.h.emplace(std::move(*this));
+        if(isRead)
+            impl.svc.read(impl);
+        else
+            impl.svc.write(impl);
+    }
+
+    void
+    operator()()
+    {
+        auto const ex = this->get_executor();
+        net::dispatch(ex,
+            beast::bind_front_handler(std::move(*this), 0));
+    }
+
+    void
+    operator()(int)
+    {
+        error_code ec;
+        std::size_t bytes_transferred = 0;
+        if(isRead)
+        {
+            bytes_transferred =
+                impl_->svc.read_result(*impl_, ec);
+        }
+        else
+        {
+            auto const res = impl_->wr.res;
+            if(res < 0)
+                ec.assign(-res, system_category());
+            else
+                bytes_transferred = static_cast<std::size_t>(res);
+        }
+        this->complete_now(ec, bytes_transferred);
+    }
+};
+
+template<class Executor>
+struct basic_uring_stream<Executor>::run_read_op
+{
+    template<class ReadHandler, class Buffers>
+    void
+    operator()(
+        ReadHandler&& h,
+        basic_uring_stream* s,
+        Buffers const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            detail::is_invocable<ReadHandler,
+                void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        transfer_op<
+            true,
+            Buffers,
+            typename std::decay<ReadHandler>::type>(
+                std::forward<ReadHandler>(h), *s, b);
+    }
+};
+
+template<class Executor>
+struct basic_uring_stream<Executor>::run_write_op
+{
+    template<class WriteHandler, class Buffers>
+    void
+    operator()(
+        WriteHandler&& h,
+        basic_uring_stream* s,
+        Buffers const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        transfer_op<
+            false,
+            Buffers,
+            typename std::decay<WriteHandler>::type>(
+                std::forward<WriteHandler>(h), *s, b);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class Executor>
+net::io_context&
+basic_uring_stream<Executor>::
+context_of(executor_type const& ex)
+{
+    auto const ioc = beast::detail::get_io_context(ex);
+    if(! ioc)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "executor is not from an io_context"});
+    return *ioc;
+}
+
+template<class Executor>
+basic_uring_stream<Executor>::
+~basic_uring_stream()
+{
+    if(impl_)
+        impl_->svc.cancel(*impl_);
+}
+
+template<class Executor>
+template<class ExecutionContext, class>
+basic_uring_stream<Executor>::
+basic_uring_stream(ExecutionContext& ctx)
+    : basic_uring_stream(executor_type(ctx.get_executor()))
+{
+}
+
+template<class Executor>
+basic_uring_stream<Executor>::
+basic_uring_stream(executor_type const& ex)
+    : socket_(ex)
+    , impl_(std::make_shared<detail::uring_impl>(context_of(ex)))
+{
+}
+
+template<class Executor>
+basic_uring_stream<Executor>::
+basic_uring_stream(socket_type&& socket)
+    : socket_(std::move(socket))
+    , impl_(std::make_shared<detail::uring_impl>(
+        context_of(socket_.get_executor())))
+{
+}
+
+template<class Executor>
+void
+basic_uring_stream<Executor>::
+multishot(bool v)
+{
+    impl_->svc.multishot(*impl_, v);
+}
+
+template<class Executor>
+void
+basic_uring_stream<Executor>::
+register_buffer(net::mutable_buffer buffer)
+{
+    error_code ec;
+    impl_->svc.register_buffer(
+        *impl_, buffer.data(), buffer.size(), ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+}
+
+template<class Executor>
+void
+basic_uring_stream<Executor>::
+unregister_buffer()
+{
+    impl_->svc.unregister_buffer(*impl_);
+}
+
+template<class Executor>
+void
+basic_uring_stream<Executor>::
+cancel()
+{
+    impl_->svc.cancel(*impl_);
+}
+
+template<class Executor>
+void
+basic_uring_stream<Executor>::
+close()
+{
+    impl_->svc.cancel(*impl_);
+    error_code ec;
+    socket_.close(ec);
+}
+
+//------------------------------------------------------------------------------
+
+template<class Executor>
+template<class MutableBufferSequence, class ReadHandler>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+basic_uring_stream<Executor>::
+async_read_some(
+    MutableBufferSequence const& buffers,
+    ReadHandler&& handler)
+{
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+        "MutableBufferSequence type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            run_read_op{},
+            handler,
+            this,
+            buffers);
+}
+
+template<class Executor>
+template<class ConstBufferSequence, class WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+basic_uring_stream<Executor>::
+async_write_some(
+    ConstBufferSequence const& buffers,
+    WriteHandler&& handler)
+{
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+        "ConstBufferSequence type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_write_op{},
+            handler,
+            this,
+            buffers);
+}
+
+//------------------------------------------------------------------------------
+
+#if ! BOOST_BEAST_DOXYGEN
+
+template<class Executor>
+void
+beast_close_socket(basic_uring_stream<Executor>& stream)
+{
+    stream.close();
+}
+
+template<class Executor>
+void
+teardown(
+    role_type role,
+    basic_uring_stream<Executor>& stream,
+    error_code& ec)
+{
+    // The multishot receive would take the data
+    // the socket is read for, until the end.
+    if(stream.multishot())
+        stream.multishot(false);
+    using beast::websocket::teardown;
+    teardown(role, stream.socket(), ec);
+}
+
+template<class Executor, class TeardownHandler>
+void
+async_teardown(
+    role_type role,
+    basic_uring_stream<Executor>& stream,
+    TeardownHandler&& handler)
+{
+    if(stream.multishot())
+        stream.multishot(false);
+    using beast::websocket::async_teardown;
+    async_teardown(role, stream.socket(),
+        std::forward<TeardownHandler>(handler));
+}
+
+#endif
+
+} // beast
+} // boost
+
+#endif
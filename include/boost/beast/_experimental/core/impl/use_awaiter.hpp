@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_USE_AWAITER_HPP
+#define BOOST_BEAST_CORE_IMPL_USE_AWAITER_HPP
+
+#include <boost/throw_exception.hpp>
+#include <new>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+struct awaiter_access
+{
+    template<class Signature, class Initiation, class... Args>
+    static
+    awaiter<Signature>
+    make(
+        use_awaiter_t token,
+        Initiation&& init,
+        Args&&... args)
+    {
+        return awaiter<Signature>(token.ec_,
+            std::forward<Initiation>(init),
+            std::forward<Args>(args)...);
+    }
+};
+
+} // detail
+
+template<class... Ts>
+struct awaiter<void(error_code, Ts...)>::handler
+{
+    awaiter* self;
+
+    using allocator_type =
+        detail::awaiter_allocator<void, arena_size>;
+
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(self->arena_);
+    }
+
+    void
+    operator()(error_code ec, Ts... args)
+    {
+        self->ec_ = ec;
+        self->results_.emplace(std::move(args)...);
+        self->h_.resume();
+    }
+};
+
+template<class... Ts>
+template<class Initiation, class... Args>
+awaiter<void(error_code, Ts...)>::
+awaiter(
+    error_code* ec,
+    Initiation&& init,
+    Args&&... args)
+    : ecp_(ec)
+{
+    // The initiation and its arguments are kept
+    // until the coroutine awaits this object.
+    using launch_type = std::tuple<
+        typename std::decay<Initiation>::type,
+        typename std::decay<Args>::type...>;
+    if constexpr(
+        sizeof(launch_type) <= launch_size &&
+        alignof(launch_type) <= alignof(std::max_align_t))
+    {
+        launch_ = ::new(buf_) launch_type(
+            std::forward<Initiation>(init),
+            std::forward<Args>(args)...);
+        destroy_ =
+            [](void* p) noexcept
+            {
+                static_cast<launch_type*>(p)->~launch_type();
+            };
+    }
+    else
+    {
+        launch_ = new launch_type(
+            std::forward<Initiation>(init),
+            std::forward<Args>(args)...);
+        destroy_ =
+            [](void* p) noexcept
+            {
+                delete static_cast<launch_type*>(p);
+            };
+    }
+    start_ = &awaiter::template start<launch_type>;
+}
+
+template<class... Ts>
+awaiter<void(error_code, Ts...)>::
+~awaiter()
+{
+    if(launch_)
+        destroy_(launch_);
+}
+
+template<class... Ts>
+template<class Launch>
+void
+awaiter<void(error_code, Ts...)>::
+start(awaiter& self)
+{
+    // The operation may complete on another thread and destroy
+    // *this before the initiation returns, so nothing here may
+    // refer to *this once it is called.
+    Launch launch(std::move(*static_cast<Launch*>(self.launch_)));
+    self.destroy_(self.launch_);
+    self.launch_ = nullptr;
+    std::apply(
+        [&self](auto& init, auto&... args)
+        {
+            std::move(init)(handler{&self}, std::move(args)...);
+        },
+        launch);
+}
+
+template<class... Ts>
+void
+awaiter<void(error_code, Ts...)>::
+await_suspend(std::coroutine_handle<> h)
+{
+    h_ = h;
+    start_(*this);
+}
+
+template<class... Ts>
+auto
+awaiter<void(error_code, Ts...)>::
+await_resume() ->
+    result_type
+{
+    if(ecp_)
+        *ecp_ = ec_;
+    else if(ec_)
+        BOOST_THROW_EXCEPTION(system_error{ec_});
+    if constexpr(sizeof...(Ts) == 1)
+        return std::move(std::get<0>(*results_));
+    else if constexpr(sizeof...(Ts) > 1)
+        return std::move(*results_);
+}
+
+} // beast
+
+namespace asio {
+
+template<class... Ts>
+class async_result<
+    beast::use_awaiter_t, void(beast::error_code, Ts...)>
+{
+public:
+    using return_type =
+        beast::awaiter<void(beast::error_code, Ts...)>;
+
+    template<class Initiation, class... Args>
+    static
+    return_type
+    initiate(
+        Initiation&& init,
+        beast::use_awaiter_t token,
+        Args&&... args)
+    {
+        return beast::detail::awaiter_access::make<
+            void(beast::error_code, Ts...)>(token,
+                std::forward<Initiation>(init),
+                std::forward<Args>(args)...);
+    }
+};
+
+} // asio
+} // boost
+
+#endif
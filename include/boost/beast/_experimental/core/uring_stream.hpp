@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_URING_STREAM_HPP
+#define BOOST_BEAST_CORE_URING_STREAM_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/_experimental/core/detail/uring_service.hpp>
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/role.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/basic_stream_socket.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/executor.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <memory>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** A TCP stream whose reads and writes are performed with io_uring.
+
+    This stream owns a TCP socket, and meets the requirements of
+    <em>AsyncReadStream</em> and <em>AsyncWriteStream</em>, so it may
+    be used with the HTTP algorithms, or as the next layer of a
+    @ref websocket::stream or an SSL stream. The socket is opened,
+    connected, or accepted as usual through @ref socket. Reads and
+    writes are not performed by the reactor, but by a ring shared
+    by the streams of the same `net::io_context`:
+
+    @li Operations started while a completion handler runs are
+    submitted to the kernel together, with one system call, after
+    it returns, and their completions are collected together.
+
+    @li A buffer may be registered with the kernel, after which
+    reads into it avoid mapping its pages for every read. This
+    suits the storage of a @ref flat_buffer whose capacity was
+    reserved up front.
+
+    @li In multishot mode, one submission receives for as long as
+    the connection is open. Data is received into buffers owned by
+    the ring and copied out by each read, which then often completes
+    without any system call.
+
+    This stream requires Linux 6.0 or later. Its executor must be
+    the executor of a `net::io_context`, or a strand of one. The
+    synchronous stream operations and timeouts are not supported.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. The application must also ensure
+    that all asynchronous operations are performed within the same
+    implicit or explicit strand.
+
+    @par Example
+    @code
+    websocket::stream<uring_stream> ws(ioc);
+    net::connect(ws.next_layer().socket(), results);
+    ws.next_layer().multishot(true);
+    ws.async_handshake(host, "/", ...);
+    @endcode
+
+    @tparam Executor The type of executor used by the socket.
+*/
+template<class Executor = net::executor>
+class basic_uring_stream
+{
+public:
+    /// The type of the executor associated with the stream.
+    using executor_type = Executor;
+
+    /// The type of the underlying socket.
+    using socket_type =
+        net::basic_stream_socket<net::ip::tcp, Executor>;
+
+private:
+    socket_type socket_;
+    std::shared_ptr<detail::uring_impl> impl_;
+
+    template<bool isRead, class Buffers, class Handler>
+    class transfer_op;
+
+    struct run_read_op;
+    struct run_write_op;
+
+    static
+    net::io_context&
+    context_of(executor_type const& ex);
+
+public:
+    /** Destructor
+
+        Outstanding operations are canceled as if by
+        calling @ref cancel, and the socket is closed.
+    */
+    ~basic_uring_stream();
+
+    /** Constructor
+
+        @param ctx The `net::io_context` whose executor to use.
+    */
+#if BOOST_BEAST_DOXYGEN
+    template<class ExecutionContext>
+    explicit
+    basic_uring_stream(ExecutionContext& ctx);
+#else
+    template<class ExecutionContext, class = typename
+        std::enable_if<std::is_convertible<ExecutionContext&,
+            net::execution_context&>::value>::type>
+    explicit
+    basic_uring_stream(ExecutionContext& ctx);
+#endif
+
+    /** Constructor
+
+        @param ex The executor to use.
+    */
+    explicit
+    basic_uring_stream(executor_type const& ex);
+
+    /** Constructor
+
+        @param socket The socket to use. This may
+        already be connected or accepted.
+    */
+    explicit
+    basic_uring_stream(socket_type&& socket);
+
+    /// Move constructor
+    basic_uring_stream(basic_uring_stream&&) = default;
+
+    /// Move assignment (deleted).
+    basic_uring_stream& operator=(basic_uring_stream&&) = delete;
+
+    /// Returns the executor associated with the stream.
+    executor_type
+    get_executor() noexcept
+    {
+        return socket_.get_executor();
+    }
+
+    /// Return a reference to the underlying socket
+    socket_type&
+    socket() noexcept
+    {
+        return socket_;
+    }
+
+    /// Return a reference to the underlying socket
+    socket_type const&
+    socket() const noexcept
+    {
+        return socket_;
+    }
+
+    /// Returns `true` if multishot receive is enabled
+    bool
+    multishot() const noexcept
+    {
+        return impl_->multishot();
+    }
+
+    /** Set whether reads use a multishot receive.
+
+        When enabled, the first read submits a receive which stays
+        armed, filling buffers owned by the ring as data arrives.
+        Reads copy from those buffers, waiting only when none are
+        filled. When the ring has no free buffers, a read receives
+        into the caller's buffer instead.
+
+        This function may not be called while a read is outstanding.
+
+        @throws system_error If the kernel does not support it.
+    */
+    void
+    multishot(bool v);
+
+    /** Register a buffer with the kernel.
+
+        Reads which fall entirely within the buffer are then performed
+        using the registered pages. Only one buffer is registered for
+        each stream; registering another replaces it.
+
+        @param buffer The buffer to register. The memory must remain
+        valid until the buffer is unregistered, or the stream is
+        destroyed.
+
+        @throws system_error If the buffer could not be registered.
+    */
+    void
+    register_buffer(net::mutable_buffer buffer);
+
+    /// Unregister the buffer registered with the kernel, if any.
+    void
+    unregister_buffer();
+
+    /** Cancel all asynchronous operations associated with the stream.
+
+        The handlers of outstanding reads and writes are invoked with
+        the error `net::error::operation_aborted`.
+    */
+    void
+    cancel();
+
+    /** Close the stream.
+
+        Outstanding operations are canceled as if by
+        calling @ref cancel, and the socket is closed.
+    */
+    void
+    close();
+
+    /** Read some data asynchronously.
+
+        This function is used to asynchronously read data from the stream.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li One or more bytes are read from the stream.
+
+        @li An error occurs.
+
+        The program must ensure that no other calls to @ref async_read_some
+        are performed until this operation completes.
+
+        @param buffers The buffers into which the data will be read. If the size
+        of the buffers is zero bytes, the operation always completes immediately
+        with no error.
+        Although the buffers object may be copied as necessary, ownership of the
+        underlying memory blocks is retained by the caller, which must guarantee
+        that they remain valid until the handler is called.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code error,               // Result of operation.
+            std::size_t bytes_transferred   // Number of bytes read.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<class MutableBufferSequence, class ReadHandler>
+    BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+    async_read_some(
+        MutableBufferSequence const& buffers,
+        ReadHandler&& handler);
+
+    /** Write some data asynchronously.
+
+        This function is used to asynchronously write data to the stream.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li One or more bytes are written to the stream.
+
+        @li An error occurs.
+
+        The program must ensure that no other calls to @ref async_write_some
+        are performed until this operation completes.
+
+        @param buffers The buffers from which the data will be written. If the
+        size of the buffers is zero bytes, the operation always completes
+        immediately with no error.
+        Although the buffers object may be copied as necessary, ownership of the
+        underlying memory blocks is retained by the caller, which must guarantee
+        that they remain valid until the handler is called.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code error,               // Result of operation.
+            std::size_t bytes_transferred   // Number of bytes written.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<class ConstBufferSequence, class WriteHandler>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_write_some(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler);
+};
+
+/// A TCP stream whose reads and writes are performed with io_uring
+using uring_stream = basic_uring_stream<>;
+
+} // beast
+} // boost
+
+#include <boost/beast/_experimental/core/impl/uring_stream.hpp>
+
+#endif
+
+#endif
@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_USE_AWAITER_HPP
+#define BOOST_BEAST_CORE_USE_AWAITER_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+
+#ifndef BOOST_BEAST_HAS_CO_AWAIT
+# if defined(__cpp_impl_coroutine) && defined(__has_include)
+#  if __cpp_impl_coroutine >= 201902 && __has_include(<coroutine>)
+#   define BOOST_BEAST_HAS_CO_AWAIT 1
+#  endif
+# endif
+#endif
+#ifndef BOOST_BEAST_HAS_CO_AWAIT
+# define BOOST_BEAST_HAS_CO_AWAIT 0
+#endif
+
+#if BOOST_BEAST_HAS_CO_AWAIT
+
+#include <boost/beast/_experimental/core/detail/awaiter_arena.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/async_result.hpp>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+template<class Signature>
+class awaiter;
+
+namespace detail {
+struct awaiter_access;
+} // detail
+
+/** A completion token which makes an initiating function return an awaiter.
+
+    When this token is passed as the completion handler of an
+    asynchronous initiating function, such as @ref http::async_read,
+    @ref http::async_write, or the read and write functions of
+    @ref websocket::stream, the function returns an @ref awaiter
+    instead of starting the operation. The operation starts when
+    the awaiter is awaited by a C++20 coroutine, which resumes with
+    its result when it completes.
+
+    The awaiter becomes a temporary in the frame of the awaiting
+    coroutine, and the operation's state, including the memory
+    allocated by the operations it is composed of, is stored in
+    the awaiter. A connection served by a coroutine thus needs no
+    memory other than the coroutine frame.
+
+    By default an error is thrown as a `system_error`. To receive
+    it instead, pass the error code in brackets:
+
+    @code
+    error_code ec;
+    std::size_t n = co_await http::async_read(
+        stream, buffer, req, use_awaiter[ec]);
+    @endcode
+
+    @note Available when the compiler supports C++20 coroutines,
+    as indicated by `BOOST_BEAST_HAS_CO_AWAIT`.
+
+    @see detached_task
+*/
+class use_awaiter_t
+{
+    friend struct detail::awaiter_access;
+
+    error_code* ec_ = nullptr;
+
+public:
+    /// Constructor
+    constexpr
+    use_awaiter_t() = default;
+
+    /// Return a token which stores the error in `ec` instead of throwing it
+    constexpr
+    use_awaiter_t
+    operator[](error_code& ec) const noexcept
+    {
+        use_awaiter_t t;
+        t.ec_ = &ec;
+        return t;
+    }
+};
+
+/// A completion token which makes an initiating function return an awaiter
+inline constexpr use_awaiter_t use_awaiter{};
+
+/** The result of an initiating function given @ref use_awaiter.
+
+    Awaiting this object starts the operation, and produces the
+    values passed to its completion handler after the error code:
+    nothing, the single value, or a `std::tuple` of them.
+
+    This object is not copyable or movable. It is meant to be
+    awaited immediately: `co_await http::async_write(...)`.
+*/
+template<class... Ts>
+class awaiter<void(error_code, Ts...)>
+{
+    friend struct detail::awaiter_access;
+
+    static std::size_t constexpr arena_size = 2048;
+    static std::size_t constexpr launch_size = 128;
+
+    struct handler;
+
+    detail::awaiter_arena<arena_size> arena_;
+    alignas(std::max_align_t) unsigned char buf_[launch_size];
+    void* launch_ = nullptr;
+    void (*start_)(awaiter&) = nullptr;
+    void (*destroy_)(void*) noexcept = nullptr;
+    std::coroutine_handle<> h_;
+    error_code* ecp_;
+    error_code ec_;
+    std::optional<std::tuple<Ts...>> results_;
+
+    template<class Launch>
+    static
+    void
+    start(awaiter& self);
+
+    template<class Initiation, class... Args>
+    awaiter(
+        error_code* ec,
+        Initiation&& init,
+        Args&&... args);
+
+public:
+    /// The type of the value produced by awaiting this object
+#if BOOST_BEAST_DOXYGEN
+    using result_type = __implementation_defined__;
+#else
+    using result_type = std::conditional_t<
+        sizeof...(Ts) == 0, void, std::conditional_t<
+            sizeof...(Ts) == 1,
+            std::tuple_element_t<0, std::tuple<Ts..., void>>,
+            std::tuple<Ts...>>>;
+#endif
+
+    /// Destructor
+    ~awaiter();
+
+    awaiter(awaiter const&) = delete;
+    awaiter& operator=(awaiter const&) = delete;
+
+    /// Returns `false`, the operation has not started
+    bool
+    await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /// Start the operation, resuming `h` when it completes
+    void
+    await_suspend(std::coroutine_handle<> h);
+
+    /// Return the result of the operation
+    result_type
+    await_resume();
+};
+
+/** The return type of a coroutine which runs on its own.
+
+    A coroutine returning this type starts running when it is
+    called, and its frame is destroyed when it returns. It may
+    await any awaitable, including those returned by initiating
+    functions given @ref use_awaiter. When it awaits an
+    asynchronous operation, the call returns, and the coroutine
+    continues in the completion handler of the operation.
+
+    The coroutine must not exit with an exception, which
+    calls `std::terminate`.
+
+    @par Example
+    @code
+    detached_task
+    do_session(tcp_stream stream)
+    {
+        flat_buffer buffer;
+        for(;;)
+        {
+            error_code ec;
+            http::request<http::string_body> req;
+            co_await http::async_read(stream, buffer, req, use_awaiter[ec]);
+            if(ec)
+                co_return;
+            ...
+        }
+    }
+    @endcode
+*/
+class detached_task
+{
+public:
+    /// The coroutine promise type
+    struct promise_type
+    {
+        detached_task
+        get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never
+        initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never
+        final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void() const noexcept
+        {
+        }
+
+        void
+        unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+} // beast
+} // boost
+
+#include <boost/beast/_experimental/core/impl/use_awaiter.hpp>
+
+#endif
+
+#endif
@@ -0,0 +1,317 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_CLIENT_POOL_HPP
+#define BOOST_BEAST_HTTP_CLIENT_POOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/saved_handler.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/async_result.hpp>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A pool of keep-alive HTTP client connections.
+
+    This object sends requests on behalf of the caller, reusing
+    idle connections to the same host and port instead of opening,
+    and for TLS negotiating, a new connection for every request.
+    Connections are kept separately for each host and port. A pool
+    holds streams of one type, so a pool of @ref tcp_stream and a
+    pool of `ssl_stream<tcp_stream>` never share a connection.
+
+    @li A connection returns to the pool when its response is
+    received, unless either side asked to close it.
+
+    @li Before an idle connection is reused, it is checked for a
+    close or other unexpected data from the server. Such connections
+    are discarded. If a reused connection fails anyway, before any
+    part of the response is received, an idempotent request is sent
+    once more on a new connection.
+
+    @li At most @ref max_connections are open to each host. Further
+    requests wait for one to become available, or when pipelining is
+    enabled, are written on a busy connection behind the requests
+    already there. Responses are read in the order the requests
+    were written.
+
+    @li Idle connections older than @ref idle_timeout are closed
+    instead of reused.
+
+    New connections are made by resolving the host and port,
+    connecting the lowest layer of the stream, and then, if the
+    stream has an `async_handshake` member function taking a
+    `handshake_type`, performing a client handshake. The lowest
+    layer must be a @ref basic_stream using TCP.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+    The application must also ensure that all asynchronous
+    operations are performed within the same implicit or explicit strand.
+
+    @par Example
+    To send requests over TLS, supply a function which constructs
+    each stream, and sets the host name used for SNI:
+    @code
+    http::client_pool<ssl_stream<tcp_stream>> pool(ioc.get_executor(),
+        [&ctx](net::executor ex, string_view host)
+        {
+            ssl_stream<tcp_stream> s(ex, ctx);
+            SSL_set_tlsext_host_name(
+                s.native_handle(), std::string(host).c_str());
+            return s;
+        });
+    http::request<http::empty_body> req{http::verb::get, "/", 11};
+    req.set(http::field::host, "www.example.com");
+    http::response<http::string_body> res;
+    pool.async_request("www.example.com", "443", req, res,
+        [](error_code ec, std::size_t bytes_transferred)
+        {
+            ...
+        });
+    @endcode
+
+    @note The pool must outlive its pending operations. Destroying
+    the pool closes every connection.
+
+    @tparam Stream The type of stream used for each connection.
+*/
+template<class Stream>
+class client_pool
+{
+public:
+    /// The type of stream used for each connection
+    using stream_type = Stream;
+
+    /// The type of the executor associated with the object.
+    using executor_type = beast::executor_type<Stream>;
+
+    /// The type of duration used for the idle timeout.
+    using duration = std::chrono::steady_clock::duration;
+
+private:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    struct connection
+    {
+        Stream stream;
+        flat_buffer buffer;
+        std::deque<saved_handler> write_waiters;
+        std::deque<saved_handler> read_waiters;
+        time_point idle_since;
+        std::size_t pending = 0;    // attached operations
+        bool connected = false;
+        bool writing = false;
+        bool reading = false;
+        bool closing = false;
+
+        explicit
+        connection(Stream&& s)
+            : stream(std::move(s))
+        {
+        }
+    };
+
+    struct host
+    {
+        std::vector<std::shared_ptr<connection>> v;
+        std::deque<saved_handler> waiters;
+    };
+
+    template<class Handler,
+        class ReqBody, class ReqFields,
+        class ResBody, class ResFields>
+    class request_op;
+
+    struct run_request_op;
+
+    executor_type ex_;
+    std::function<Stream(
+        executor_type const&, string_view)> make_;
+    std::unordered_map<std::string, host> hosts_;
+    duration idle_timeout_ = std::chrono::seconds(30);
+    std::size_t max_connections_ = 6;
+    bool pipelining_ = false;
+
+    std::shared_ptr<connection>
+    acquire(host& h, string_view name, bool fresh, bool& created);
+
+    void
+    release(host& h, std::shared_ptr<connection> const& c);
+
+    static
+    void
+    close(connection& c);
+
+public:
+    /// Destructor
+    ~client_pool() = default;
+
+    /** Constructor
+
+        Each stream is constructed from the pool's executor.
+
+        @param ex The executor to use.
+    */
+    explicit
+    client_pool(executor_type const& ex);
+
+    /** Constructor
+
+        @param ex The executor to use.
+
+        @param make A function object which returns a new stream for
+        a connection to a host. It is invoked with the pool's executor
+        and the host name. The equivalent function signature must be:
+        @code
+        Stream make(
+            executor_type const& ex,
+            string_view host);
+        @endcode
+    */
+    template<class MakeStream>
+    client_pool(executor_type const& ex, MakeStream&& make);
+
+    /// Returns the executor associated with the object.
+    executor_type
+    get_executor() const noexcept
+    {
+        return ex_;
+    }
+
+    /// Returns the maximum number of connections to each host
+    std::size_t
+    max_connections() const noexcept
+    {
+        return max_connections_;
+    }
+
+    /** Set the maximum number of connections to each host
+
+        The default is 6.
+
+        @param n The new limit, which must be greater than zero.
+    */
+    void
+    max_connections(std::size_t n);
+
+    /// Returns `true` if requests may be pipelined
+    bool
+    pipelining() const noexcept
+    {
+        return pipelining_;
+    }
+
+    /** Set whether requests may be pipelined
+
+        When enabled, and all of the connections to a host are busy,
+        a request is written on the connection with the fewest
+        requests outstanding instead of waiting. The server must
+        support HTTP/1.1 pipelining. The default is `false`.
+    */
+    void
+    pipelining(bool v) noexcept
+    {
+        pipelining_ = v;
+    }
+
+    /// Returns the time after which an idle connection is closed
+    duration
+    idle_timeout() const noexcept
+    {
+        return idle_timeout_;
+    }
+
+    /** Set the time after which an idle connection is closed
+
+        This should be less than the server's keep-alive timeout.
+        The default is 30 seconds.
+    */
+    void
+    idle_timeout(duration d) noexcept
+    {
+        idle_timeout_ = d;
+    }
+
+    /// Returns the number of open connections, to all hosts
+    std::size_t
+    size() const noexcept;
+
+    /// Close every idle connection.
+    void
+    clear();
+
+    /** Send a request and receive its response asynchronously.
+
+        The request is written on a pooled connection to the host
+        and port, and the response is then read from it. When no
+        connection is available, one is opened, or the operation
+        waits as described in the class documentation.
+
+        @param host The host name or address to connect to.
+
+        @param port The port or service name to connect to.
+
+        @param req The request to send. The object must remain
+        valid until the handler is called. The Host field is not
+        set by this function.
+
+        @param res The message to store the response in. The object
+        must remain valid until the handler is called.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& error,        // result of operation
+            std::size_t bytes_transferred   // the number of bytes read from the stream
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        class ReqBody, class ReqFields,
+        class ResBody, class ResFields,
+        class ResponseHandler>
+    BOOST_BEAST_ASYNC_RESULT2(ResponseHandler)
+    async_request(
+        string_view host,
+        string_view port,
+        request<ReqBody, ReqFields>& req,
+        response<ResBody, ResFields>& res,
+        ResponseHandler&& handler);
+};
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/_experimental/http/impl/client_pool.hpp>
+
+#endif
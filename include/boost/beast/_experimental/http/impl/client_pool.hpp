@@ -0,0 +1,573 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_CLIENT_POOL_HPP
+#define BOOST_BEAST_HTTP_IMPL_CLIENT_POOL_HPP
+
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+template<class T, class = void>
+struct has_client_handshake : std::false_type
+{
+};
+
+template<class T>
+struct has_client_handshake<T, boost::void_t<
+    typename T::handshake_type>> : std::true_type
+{
+};
+
+template<class Stream, class Handler>
+void
+async_client_handshake(
+    Stream& stream, Handler&& handler, std::true_type)
+{
+    stream.async_handshake(Stream::client,
+        std::forward<Handler>(handler));
+}
+
+template<class Stream, class Handler>
+void
+async_client_handshake(
+    Stream&, Handler&&, std::false_type)
+{
+    BOOST_ASSERT(false);
+}
+
+// Returns `true` if an idle connection can't be reused
+template<class Socket>
+bool
+is_connection_closed(Socket& s)
+{
+    // An idle connection has nothing to read. Anything
+    // readable is a close, an error, or unsolicited data.
+    if(! s.is_open())
+        return true;
+    error_code ec;
+    auto const nb = s.non_blocking();
+    s.non_blocking(true, ec);
+    if(ec)
+        return true;
+    char c;
+    s.receive(net::mutable_buffer(&c, 1),
+        net::socket_base::message_peek, ec);
+    error_code ignored;
+    s.non_blocking(nb, ignored);
+    return ec != net::error::would_block;
+}
+
+inline
+bool
+is_idempotent(verb v)
+{
+    switch(v)
+    {
+    case verb::get:
+    case verb::head:
+    case verb::put:
+    case verb::delete_:
+    case verb::options:
+    case verb::trace:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns `true` if the error means the
+// connection was closed by the server.
+inline
+bool
+is_connection_lost(error_code const& ec)
+{
+    return
+        ec == http::error::end_of_stream ||
+        ec == net::error::eof ||
+        ec == net::error::connection_reset ||
+        ec == net::error::connection_aborted ||
+        ec == net::error::broken_pipe;
+}
+
+inline
+void
+wake_one(std::deque<saved_handler>& q)
+{
+    if(q.empty())
+        return;
+    auto h = std::move(q.front());
+    q.pop_front();
+    h.invoke();
+}
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<class Stream>
+template<class Handler,
+    class ReqBody, class ReqFields,
+    class ResBody, class ResFields>
+class client_pool<Stream>::request_op
+    : public beast::stable_async_base<Handler, executor_type>
+    , public net::coroutine
+{
+    using resolver_type = net::ip::basic_resolver<
+        net::ip::tcp, executor_type>;
+
+    using has_handshake =
+        detail::has_client_handshake<Stream>;
+
+    client_pool& p_;
+    host& h_;
+    std::string name_;
+    std::string port_;
+    request<ReqBody, ReqFields>& req_;
+    response<ResBody, ResFields>& res_;
+    std::shared_ptr<connection> c_;
+    std::size_t bytes_ = 0;
+    bool created_ = false;  // c_ is a new connection
+    bool sent_ = false;     // the request may have been processed
+    bool fresh_ = false;    // a new connection is required
+    bool retried_ = false;
+
+public:
+    template<class Handler_>
+    request_op(
+        Handler_&& h,
+        client_pool& p,
+        host& hs,
+        string_view name,
+        string_view port,
+        request<ReqBody, ReqFields>& req,
+        response<ResBody, ResFields>& res)
+        : stable_async_base<Handler, executor_type>(
+            std::forward<Handler_>(h), p.get_executor())
+        , p_(p)
+        , h_(hs)
+        , name_(name)
+        , port_(port)
+        , req_(req)
+        , res_(res)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(error_code ec,
+        typename resolver_type::results_type results)
+    {
+        if(ec)
+            return (*this)(ec);
+        beast::get_lowest_layer(c_->stream).async_connect(
+            results, std::move(*this));
+    }
+
+    void
+    operator()(error_code ec, net::ip::tcp::endpoint const&)
+    {
+        (*this)(ec);
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        boost::ignore_unused(cont);
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+        do_acquire:
+            for(;;)
+            {
+                c_ = p_.acquire(h_, name_, fresh_, created_);
+                if(c_)
+                    break;
+                BOOST_ASIO_CORO_YIELD
+                {
+                    auto& q = h_.waiters;
+                    q.emplace_back();
+                    q.back().emplace(std::move(*this));
+                }
+            }
+            sent_ = false;
+            bytes_ = 0;
+
+            if(created_)
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    auto& r = beast::allocate_stable<
+                        resolver_type>(*this, p_.ex_);
+                    r.async_resolve(name_, port_, std::move(*this));
+                }
+                if(! ec && has_handshake::value)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    detail::async_client_handshake(c_->stream,
+                        std::move(*this), has_handshake{});
+                }
+                if(ec)
+                {
+                    // No retry when connecting fails
+                    retried_ = true;
+                    c_->closing = true;
+                    goto do_fail;
+                }
+                c_->connected = true;
+            }
+
+            // Write the request, after any written before it
+            if(c_->writing)
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    auto& q = c_->write_waiters;
+                    q.emplace_back();
+                    q.back().emplace(std::move(*this));
+                }
+            }
+            if(c_->closing)
+            {
+                // A response before ours closed the connection
+                ec = net::error::connection_aborted;
+                goto do_fail;
+            }
+            c_->writing = true;
+            sent_ = true;
+            BOOST_ASIO_CORO_YIELD
+            http::async_write(c_->stream, req_, std::move(*this));
+            c_->writing = false;
+            if(ec)
+            {
+                c_->closing = true;
+                detail::wake_one(c_->write_waiters);
+                goto do_fail;
+            }
+
+            // Responses arrive in the order requests were written,
+            // so take a place in line before the next writer goes.
+            if(c_->reading)
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    auto const c = c_.get();
+                    c->read_waiters.emplace_back();
+                    c->read_waiters.back().emplace(std::move(*this));
+                    detail::wake_one(c->write_waiters);
+                }
+            }
+            else
+            {
+                detail::wake_one(c_->write_waiters);
+            }
+            if(c_->closing)
+            {
+                // Since a response before ours closed the connection,
+                // an idempotent request can go on any connection.
+                ec = net::error::connection_aborted;
+                if(detail::is_idempotent(req_.method()))
+                    sent_ = false;
+                goto do_fail;
+            }
+            c_->reading = true;
+            BOOST_ASIO_CORO_YIELD
+            http::async_read(c_->stream,
+                c_->buffer, res_, std::move(*this));
+            c_->reading = false;
+            bytes_ = bytes_transferred;
+            if(ec || ! req_.keep_alive() || ! res_.keep_alive())
+                c_->closing = true;
+            detail::wake_one(c_->read_waiters);
+            if(ec)
+                goto do_fail;
+            p_.release(h_, c_);
+            c_.reset();
+            return this->complete_now(ec, bytes_);
+
+        do_fail:
+            if(c_->closing)
+            {
+                // Let waiting operations fail too
+                detail::wake_one(c_->read_waiters);
+                detail::wake_one(c_->write_waiters);
+            }
+            p_.release(h_, c_);
+            c_.reset();
+            // A request which was not sent, or an idempotent one sent
+            // on a reused connection which the server closed before
+            // responding, is sent again on a new connection.
+            if(! retried_ && ! sent_)
+            {
+                retried_ = true;
+                goto do_acquire;
+            }
+            if(! retried_ && ! created_ && bytes_ == 0 &&
+                detail::is_idempotent(req_.method()) &&
+                detail::is_connection_lost(ec))
+            {
+                // Idle connections may be closing too
+                retried_ = true;
+                fresh_ = true;
+                goto do_acquire;
+            }
+            this->complete_now(ec, bytes_);
+        }
+    }
+};
+
+template<class Stream>
+struct client_pool<Stream>::run_request_op
+{
+    template<
+        class ResponseHandler,
+        class ReqBody, class ReqFields,
+        class ResBody, class ResFields>
+    void
+    operator()(
+        ResponseHandler&& h,
+        client_pool* p,
+        host* hs,
+        string_view name,
+        string_view port,
+        request<ReqBody, ReqFields>* req,
+        response<ResBody, ResFields>* res)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ResponseHandler,
+            void(error_code, std::size_t)>::value,
+            "ResponseHandler type requirements not met");
+
+        request_op<
+            typename std::decay<ResponseHandler>::type,
+            ReqBody, ReqFields, ResBody, ResFields>(
+                std::forward<ResponseHandler>(h),
+                *p, *hs, name, port, *req, *res);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class Stream>
+client_pool<Stream>::
+client_pool(executor_type const& ex)
+    : client_pool(ex,
+        [](executor_type const& ex, string_view)
+        {
+            return Stream(ex);
+        })
+{
+}
+
+template<class Stream>
+template<class MakeStream>
+client_pool<Stream>::
+client_pool(executor_type const& ex, MakeStream&& make)
+    : ex_(ex)
+    , make_(std::forward<MakeStream>(make))
+{
+}
+
+template<class Stream>
+void
+client_pool<Stream>::
+max_connections(std::size_t n)
+{
+    if(n == 0)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid limit"});
+    max_connections_ = n;
+}
+
+template<class Stream>
+std::size_t
+client_pool<Stream>::
+size() const noexcept
+{
+    std::size_t n = 0;
+    for(auto const& h : hosts_)
+        n += h.second.v.size();
+    return n;
+}
+
+template<class Stream>
+void
+client_pool<Stream>::
+clear()
+{
+    for(auto& h : hosts_)
+    {
+        auto& v = h.second.v;
+        for(auto i = v.size(); i-- > 0;)
+        {
+            if(v[i]->pending > 0)
+                continue;
+            close(*v[i]);
+            v.erase(v.begin() + i);
+        }
+    }
+}
+
+template<class Stream>
+auto
+client_pool<Stream>::
+acquire(host& h, string_view name, bool fresh, bool& created) ->
+    std::shared_ptr<connection>
+{
+    created = false;
+    auto const now = std::chrono::steady_clock::now();
+    auto& v = h.v;
+    if(! fresh)
+    {
+        // Prefer the most recently used idle connection
+        for(auto i = v.size(); i-- > 0;)
+        {
+            auto const c = v[i];
+            if(c->pending > 0)
+                continue;
+            if( now - c->idle_since < idle_timeout_ &&
+                c->buffer.size() == 0 &&
+                ! detail::is_connection_closed(
+                    beast::get_lowest_layer(c->stream).socket()))
+            {
+                c->pending = 1;
+                return c;
+            }
+            close(*c);
+            v.erase(v.begin() + i);
+        }
+    }
+    else if(v.size() >= max_connections_)
+    {
+        // Make room by closing an idle connection
+        for(auto i = v.size(); i-- > 0;)
+        {
+            if(v[i]->pending > 0)
+                continue;
+            close(*v[i]);
+            v.erase(v.begin() + i);
+            break;
+        }
+    }
+    if(v.size() < max_connections_)
+    {
+        auto c = std::make_shared<connection>(make_(ex_, name));
+        c->pending = 1;
+        v.push_back(c);
+        created = true;
+        return c;
+    }
+    if(pipelining_ && ! fresh)
+    {
+        std::shared_ptr<connection> best;
+        for(auto const& c : v)
+            if( c->connected && ! c->closing && (
+                ! best || c->pending < best->pending))
+                best = c;
+        if(best)
+        {
+            ++best->pending;
+            return best;
+        }
+    }
+    return nullptr;
+}
+
+template<class Stream>
+void
+client_pool<Stream>::
+release(host& h, std::shared_ptr<connection> const& c)
+{
+    BOOST_ASSERT(c->pending > 0);
+    if(--c->pending > 0)
+        return;
+    if(c->closing || ! c->connected)
+    {
+        close(*c);
+        auto& v = h.v;
+        for(auto it = v.begin(); it != v.end(); ++it)
+        {
+            if(*it == c)
+            {
+                v.erase(it);
+                break;
+            }
+        }
+    }
+    else
+    {
+        c->idle_since = std::chrono::steady_clock::now();
+    }
+    // A connection, or room for one, is available
+    detail::wake_one(h.waiters);
+}
+
+template<class Stream>
+void
+client_pool<Stream>::
+close(connection& c)
+{
+    beast::get_lowest_layer(c.stream).close();
+}
+
+template<class Stream>
+template<
+    class ReqBody, class ReqFields,
+    class ResBody, class ResFields,
+    class ResponseHandler>
+BOOST_BEAST_ASYNC_RESULT2(ResponseHandler)
+client_pool<Stream>::
+async_request(
+    string_view host,
+    string_view port,
+    request<ReqBody, ReqFields>& req,
+    response<ResBody, ResFields>& res,
+    ResponseHandler&& handler)
+{
+    std::string key;
+    key.reserve(host.size() + 1 + port.size());
+    key.append(host.data(), host.size());
+    key.push_back(':');
+    key.append(port.data(), port.size());
+    auto& hs = hosts_[key];
+    return net::async_initiate<
+        ResponseHandler,
+        void(error_code, std::size_t)>(
+            run_request_op{},
+                handler, this, &hs, host, port, &req, &res);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
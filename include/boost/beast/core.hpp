@@ -34,6 +34,7 @@
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/flat_stream.hpp>
 #include <boost/beast/core/make_printable.hpp>
+#include <boost/beast/core/monotonic_arena.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/rate_policy.hpp>
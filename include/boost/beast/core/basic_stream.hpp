@@ -11,6 +11,7 @@
 #define BOOST_BEAST_CORE_BASIC_STREAM_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/op_cache.hpp>
 #include <boost/beast/core/detail/stream_base.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/rate_policy.hpp>
@@ -36,6 +37,11 @@ namespace ssl {
 template<typename> class stream;
 } // ssl
 } // asio
+namespace beast {
+namespace detail {
+class op_cache_test;
+} // detail
+} // beast
 } // boost
 #endif
 
@@ -82,6 +88,14 @@ namespace beast {
     notational convenience: the strand does not need to be specified in
     each individual initiating function call.
 
+    Completion handlers with an associated allocator (such as one
+    returned by a `get_allocator` member function) have the memory for
+    intermediate operations allocated with it. Otherwise, that memory
+    comes from a small cache kept by the stream, which recycles it for
+    later operations. Handlers which only customize the deprecated
+    `asio_handler_allocate` and `asio_handler_deallocate` hooks are not
+    consulted; give them an associated allocator instead.
+
     Unlike other stream wrappers, the underlying socket is accessed
     through the @ref socket member function instead of `next_layer`.
     This causes the @ref basic_stream to be returned in calls
@@ -239,6 +253,7 @@ private:
         op_state write;
         net::steady_timer timer; // rate timer
         int waiting = 0;
+        detail::op_cache cache; // recycles op memory
 
         impl_type(impl_type&&) = default;
 
@@ -289,6 +304,8 @@ private:
     struct ops;
 
 #if ! BOOST_BEAST_DOXYGEN
+    friend class detail::op_cache_test;
+
     // boost::asio::ssl::stream needs these
     // DEPRECATED
     template<class>
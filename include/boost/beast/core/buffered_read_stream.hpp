@@ -46,6 +46,19 @@ namespace beast {
     @li "Preload" a stream with handshake input data acquired
       from other sources.
 
+    Reads which find the internal buffer empty, and which supply
+    buffers at least as large as the next fill of the internal
+    buffer, are performed directly into the caller's buffers
+    without an intermediate copy. Algorithms which accept a
+    <em>DynamicBuffer</em>, such as `http::read`, can consume
+    the buffered data without any copy at all by borrowing the
+    internal buffer with @ref lend:
+
+    @code
+    auto b = stream.lend();
+    http::read(stream, b, req);
+    @endcode
+
     Example:
     @code
     // Process the next HTTP header on the stream,
@@ -99,8 +112,16 @@ class buffered_read_stream
 
     DynamicBuffer buffer_;
     std::size_t capacity_ = 0;
+    std::size_t fill_ = 0;
+    std::size_t lent_ = 0;      // lent_buffer objects alive
     Stream next_layer_;
 
+    std::size_t
+    fill_size();
+
+    void
+    on_fill(std::size_t size, std::size_t bytes_transferred) noexcept;
+
 public:
     /// The type of the internal buffer
     using buffer_type = DynamicBuffer;
@@ -181,12 +202,149 @@ public:
         return buffer_;
     }
 
+    /** A <em>DynamicBuffer</em> which refers to the internal buffer.
+
+        Objects of this type are returned by @ref lend. While any
+        of them exists, reads from the stream go directly to the
+        next layer, so that an algorithm given both the stream
+        and this buffer reads into the internal buffer and
+        consumes the data there, without copying it.
+    */
+    class lent_buffer
+    {
+        buffered_read_stream* s_;
+
+        friend class buffered_read_stream;
+
+        explicit
+        lent_buffer(buffered_read_stream& s) noexcept
+            : s_(&s)
+        {
+            ++s_->lent_;
+        }
+
+    public:
+        /// The ConstBufferSequence used to represent the readable bytes.
+        using const_buffers_type =
+            typename DynamicBuffer::const_buffers_type;
+
+        /// The MutableBufferSequence used to represent the writable bytes.
+        using mutable_buffers_type =
+            typename DynamicBuffer::mutable_buffers_type;
+
+        /// Destructor, ending this object's part of the loan.
+        ~lent_buffer()
+        {
+            if(s_)
+                --s_->lent_;
+        }
+
+        /// Constructor
+        lent_buffer(lent_buffer&& other) noexcept
+            : s_(other.s_)
+        {
+            other.s_ = nullptr;
+        }
+
+        /// Constructor
+        lent_buffer(lent_buffer const& other) noexcept
+            : s_(other.s_)
+        {
+            if(s_)
+                ++s_->lent_;
+        }
+
+        lent_buffer& operator=(lent_buffer const&) = delete;
+
+        /// Returns the number of readable bytes.
+        std::size_t
+        size() const noexcept
+        {
+            return s_->buffer_.size();
+        }
+
+        /// Returns the maximum number of bytes, both readable and writable.
+        std::size_t
+        max_size() const noexcept
+        {
+            return s_->buffer_.max_size();
+        }
+
+        /// Returns the number of bytes that can be held without a reallocation.
+        std::size_t
+        capacity() const noexcept
+        {
+            return s_->buffer_.capacity();
+        }
+
+        /// Returns a constant buffer sequence representing the readable bytes.
+        const_buffers_type
+        data() const noexcept
+        {
+            return s_->buffer_.data();
+        }
+
+        /// Returns a mutable buffer sequence representing writable bytes.
+        mutable_buffers_type
+        prepare(std::size_t n)
+        {
+            return s_->buffer_.prepare(n);
+        }
+
+        /// Append writable bytes to the readable bytes.
+        void
+        commit(std::size_t n) noexcept
+        {
+            s_->buffer_.commit(n);
+        }
+
+        /// Remove bytes from beginning of the readable bytes.
+        void
+        consume(std::size_t n) noexcept
+        {
+            s_->buffer_.consume(n);
+        }
+    };
+
+    /** Lend the internal buffer.
+
+        This returns a <em>DynamicBuffer</em> referring to the
+        internal buffer, for use with algorithms which read from
+        this stream into a dynamic buffer, such as `http::read`,
+        `http::async_read`, or `net::read_until`:
+
+        @code
+        auto b = stream.lend();
+        http::read(stream, b, req);
+        @endcode
+
+        While the returned object or any copy of it exists, the
+        stream does not copy data out of the internal buffer:
+        reads are passed to the next layer, and data already
+        buffered is available to the borrower through the returned
+        object. Bytes the algorithm leaves in the buffer are
+        returned by ordinary reads once the loan ends.
+
+        The stream must outlive the returned object and its copies.
+    */
+    lent_buffer
+    lend() noexcept
+    {
+        return lent_buffer(*this);
+    }
+
     /** Set the maximum buffer size.
 
         This changes the maximum size of the internal buffer used
         to hold read data. No bytes are discarded by this call. If
         the buffer size is set to zero, no more data will be buffered.
 
+        Each read into the internal buffer requests at least the
+        amount suggested by @ref read_size. While reads keep filling
+        the amount requested, the request size doubles up to this
+        maximum, so that bulk transfers need fewer reads from the
+        next layer.
+
         Thread safety:
             The caller is responsible for making sure the call is
             made from the same implicit or explicit strand.
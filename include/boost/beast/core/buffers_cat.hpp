@@ -18,6 +18,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_array_builder;
+} // detail
+
 /** A buffer sequence representing a concatenation of buffer sequences.
 
     @see buffers_cat
@@ -27,6 +31,8 @@ class buffers_cat_view
 {
     detail::tuple<Buffers...> bn_;
 
+    friend struct detail::buffers_array_builder;
+
 public:
     /** The type of buffer returned when dereferencing an iterator.
 
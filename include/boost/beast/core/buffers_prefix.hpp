@@ -24,6 +24,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_array_builder;
+} // detail
+
 /** A buffer sequence adaptor that shortens the sequence size.
 
     The class adapts a buffer sequence to efficiently represent
@@ -43,6 +47,8 @@ class buffers_prefix_view
     std::size_t remain_ = 0;
     iter_type end_{};
 
+    friend struct detail::buffers_array_builder;
+
     void
     setup(std::size_t size);
 
@@ -20,6 +20,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_array_builder;
+} // detail
+
 /** Adaptor to progressively trim the front of a <em>BufferSequence</em>.
 
     This adaptor wraps a buffer sequence to create a new sequence
@@ -59,6 +63,8 @@ class buffers_suffix
     iter_type begin_{};
     std::size_t skip_ = 0;
 
+    friend struct detail::buffers_array_builder;
+
     template<class Deduced>
     buffers_suffix(Deduced&& other, std::size_t dist)
         : bs_(std::forward<Deduced>(other).bs_)
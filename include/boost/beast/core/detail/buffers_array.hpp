@@ -0,0 +1,252 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_BUFFERS_ARRAY_HPP
+#define BOOST_BEAST_CORE_DETAIL_BUFFERS_ARRAY_HPP
+
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/detail/buffers_ref.hpp>
+#include <boost/beast/core/detail/tuple.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/mp11/integer_sequence.hpp>
+#include <cstddef>
+#include <limits>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Copies buffers out of a sequence into a plain array.
+//
+// The views produced by buffers_cat, buffers_prefix and
+// buffers_suffix are walked directly through their members
+// rather than through their iterators, so nested views do
+// not pay for a variant dispatch at every element.
+//
+struct buffers_array_builder
+{
+    net::const_buffer* v;
+    std::size_t n;
+    std::size_t cap;
+    std::size_t remain;
+    bool overflow;
+
+    bool
+    done() const noexcept
+    {
+        return overflow || remain == 0;
+    }
+
+    void
+    push(net::const_buffer b)
+    {
+        if(b.size() == 0)
+            return;
+        if(n == cap)
+        {
+            overflow = true;
+            return;
+        }
+        if(b.size() > remain)
+            b = net::const_buffer(b.data(), remain);
+        v[n++] = b;
+        remain -= b.size();
+    }
+
+    void
+    append(net::const_buffer b)
+    {
+        if(! done())
+            push(b);
+    }
+
+    void
+    append(net::mutable_buffer b)
+    {
+        if(! done())
+            push(b);
+    }
+
+    template<class BufferSequence>
+    void
+    append(BufferSequence const& buffers)
+    {
+        auto it = net::buffer_sequence_begin(buffers);
+        auto const last = net::buffer_sequence_end(buffers);
+        for(; it != last && ! done(); ++it)
+            push(net::const_buffer(*it));
+    }
+
+    template<class BufferSequence>
+    void
+    append(buffers_ref<BufferSequence> const& buffers)
+    {
+        append(*buffers.buffers_);
+    }
+
+    template<class... Bn>
+    void
+    append(buffers_cat_view<Bn...> const& buffers)
+    {
+        append_each(buffers.bn_,
+            mp11::index_sequence_for<Bn...>{});
+    }
+
+    template<class BufferSequence>
+    void
+    append(buffers_prefix_view<BufferSequence> const& buffers)
+    {
+        if(buffers.size_ >= remain)
+            return append(buffers.bs_);
+        auto const remain0 = remain;
+        remain = buffers.size_;
+        append(buffers.bs_);
+        remain = remain0 - (buffers.size_ - remain);
+    }
+
+    template<class BufferSequence>
+    void
+    append(buffers_suffix<BufferSequence> const& buffers)
+    {
+        if(buffers.begin_ != net::buffer_sequence_begin(buffers.bs_))
+        {
+            // Consumed past the first buffer, use the iterators
+            for(auto it = buffers.begin(); it != buffers.end() &&
+                    ! done(); ++it)
+                push(net::const_buffer(*it));
+            return;
+        }
+        auto const skip = buffers.skip_;
+        if(skip == 0 || done())
+            return append(buffers.bs_);
+        // The skipped bytes come out of the first
+        // non-empty buffer, which is the first one
+        // pushed by the nested call.
+        auto const first = n;
+        auto const widen = remain <=
+            (std::numeric_limits<std::size_t>::max)() - skip;
+        if(widen)
+            remain += skip;
+        append(buffers.bs_);
+        if(n > first)
+        {
+            v[first] += skip;
+            if(! widen)
+                remain += skip;
+        }
+        else if(widen)
+        {
+            remain -= skip;
+        }
+    }
+
+private:
+    template<class Tuple, std::size_t... I>
+    void
+    append_each(Tuple const& t, mp11::index_sequence<I...>)
+    {
+        int const dummy[] = {0, (append(detail::get<I>(t)), 0)...};
+        (void)dummy;
+    }
+};
+
+/** A fixed-capacity array of constant buffers.
+
+    This holds at most `N` non-empty buffers copied out of
+    another constant buffer sequence. Iteration is a plain
+    pointer walk, which makes it cheaper to hand to a stream
+    than the nested views built by the HTTP serializer.
+*/
+template<std::size_t N>
+class buffers_array
+{
+    net::const_buffer v_[N];
+    std::size_t n_ = 0;
+
+public:
+    using value_type = net::const_buffer;
+    using const_iterator = value_type const*;
+
+    buffers_array() = default;
+    buffers_array(buffers_array const&) = default;
+    buffers_array& operator=(buffers_array const&) = default;
+
+    /** Construct from a buffer sequence.
+
+        If `buffers` holds more than `N` non-empty buffers,
+        only the first `N` are copied.
+    */
+    template<class ConstBufferSequence>
+    explicit
+    buffers_array(ConstBufferSequence const& buffers)
+    {
+        assign(buffers);
+    }
+
+    /** Replace the contents with a buffer sequence.
+
+        At most `limit` bytes are copied.
+
+        @return `true` if the entire sequence, up to `limit`
+        bytes, fit in the array.
+    */
+    template<class ConstBufferSequence>
+    bool
+    assign(
+        ConstBufferSequence const& buffers,
+        std::size_t limit =
+            (std::numeric_limits<std::size_t>::max)())
+    {
+        static_assert(
+            net::is_const_buffer_sequence<
+                ConstBufferSequence>::value,
+            "ConstBufferSequence type requirements not met");
+        buffers_array_builder b{v_, 0, N, limit, false};
+        b.append(buffers);
+        n_ = b.n;
+        return ! b.overflow;
+    }
+
+    /// Return the number of buffers in the array
+    std::size_t
+    size() const noexcept
+    {
+        return n_;
+    }
+
+    /// Return the maximum number of buffers in the array
+    static
+    constexpr
+    std::size_t
+    capacity() noexcept
+    {
+        return N;
+    }
+
+    const_iterator
+    begin() const noexcept
+    {
+        return v_;
+    }
+
+    const_iterator
+    end() const noexcept
+    {
+        return v_ + n_;
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -24,6 +24,8 @@ class buffers_ref
 {
     BufferSequence const* buffers_;
 
+    friend struct buffers_array_builder;
+
 public:
     using const_iterator =
         buffers_iterator_type<BufferSequence>;
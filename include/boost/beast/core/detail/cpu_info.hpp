@@ -11,6 +11,26 @@
 #define BOOST_BEAST_DETAIL_CPU_INFO_HPP
 
 #include <boost/config.hpp>
+#include <cstdint>
+
+/*  Code for a newer instruction set can be compiled for just one
+    function, with a target attribute, and called only when cpu_info
+    reports the set at runtime. This needs x86 and no -msse4.2 or
+    similar build flags; defining BOOST_BEAST_NO_INTRINSICS to 1
+    turns it off along with the other intrinsics.
+*/
+#ifndef BOOST_BEAST_CPU_DISPATCH
+# if defined(BOOST_BEAST_NO_INTRINSICS) && BOOST_BEAST_NO_INTRINSICS
+#  define BOOST_BEAST_CPU_DISPATCH 0
+# elif defined(BOOST_MSVC) && (defined(_M_X64) || defined(_M_IX86))
+#  define BOOST_BEAST_CPU_DISPATCH 1
+# elif (defined(BOOST_GCC) || defined(BOOST_CLANG)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define BOOST_BEAST_CPU_DISPATCH 1
+# else
+#  define BOOST_BEAST_CPU_DISPATCH 0
+# endif
+#endif
 
 #ifndef BOOST_BEAST_NO_INTRINSICS
 # if defined(BOOST_MSVC) || ((defined(BOOST_GCC) || defined(BOOST_CLANG)) && defined(__SSE4_2__))
@@ -20,12 +40,12 @@
 # endif
 #endif
 
-#if ! BOOST_BEAST_NO_INTRINSICS
+#if BOOST_BEAST_CPU_DISPATCH
 
 #ifdef BOOST_MSVC
-#include <intrin.h> // __cpuid
+#include <intrin.h> // __cpuidex, _xgetbv
 #else
-#include <cpuid.h>  // __get_cpuid
+#include <cpuid.h>  // __cpuid_count
 #endif
 
 namespace boost {
@@ -46,19 +66,35 @@ cpuid(
 {
 #ifdef BOOST_MSVC
     int regs[4];
-    __cpuid(regs, id);
+    __cpuidex(regs, id, 0);
     eax = regs[0];
     ebx = regs[1];
     ecx = regs[2];
     edx = regs[3];
 #else
-    __get_cpuid(id, &eax, &ebx, &ecx, &edx);
+    __cpuid_count(id, 0, eax, ebx, ecx, edx);
+#endif
+}
+
+// Returns the register state enabled by the OS, XCR0
+template<class = void>
+std::uint64_t
+xgetbv()
+{
+#ifdef BOOST_MSVC
+    return _xgetbv(0);
+#else
+    std::uint32_t eax;
+    std::uint32_t edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (std::uint64_t(edx) << 32) | eax;
 #endif
 }
 
 struct cpu_info
 {
     bool sse42 = false;
+    bool avx2 = false;
 
     cpu_info();
 };
@@ -68,6 +104,9 @@ cpu_info::
 cpu_info()
 {
     constexpr std::uint32_t SSE42 = 1 << 20;
+    constexpr std::uint32_t OSXSAVE = 1 << 27;
+    constexpr std::uint32_t AVX = 1 << 28;
+    constexpr std::uint32_t AVX2 = 1 << 5;
 
     std::uint32_t eax = 0;
     std::uint32_t ebx = 0;
@@ -75,10 +114,19 @@ cpu_info()
     std::uint32_t edx = 0;
 
     cpuid(0, eax, ebx, ecx, edx);
-    if(eax >= 1)
+    auto const max_id = eax;
+    if(max_id >= 1)
     {
         cpuid(1, eax, ebx, ecx, edx);
         sse42 = (ecx & SSE42) != 0;
+
+        // AVX2 also needs the OS to save the YMM registers
+        if( (ecx & (OSXSAVE | AVX)) == (OSXSAVE | AVX) &&
+            (xgetbv() & 6) == 6 && max_id >= 7)
+        {
+            cpuid(7, eax, ebx, ecx, edx);
+            avx2 = (ebx & AVX2) != 0;
+        }
     }
 }
 
@@ -12,7 +12,10 @@
 
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/asio/buffer.hpp>
+#include <cstdint>
 #include <cstdlib>
+#include <iterator>
+#include <limits>
 
 namespace boost {
 namespace beast {
@@ -28,9 +31,68 @@ public:
     // Largest stack we will use to flatten
     static std::size_t constexpr max_stack = 8 * 1024;
 
+    // Largest payload of a single TLS record
+    static std::size_t constexpr record_size = 16 * 1024;
+
+    // Number of consecutive writes without flattening
+    // after which an adaptive stream releases its buffer.
+    static unsigned constexpr max_idle = 16;
+
+    // The sizes of recent writes, from which an adaptive
+    // stream chooses the largest write it flattens.
+    class size_history
+    {
+        // Bucket i counts writes of up to (min_bucket << i) bytes,
+        // the last bucket counts the larger ones.
+        static std::size_t constexpr min_bucket = 1024;
+        static unsigned constexpr buckets = 8;
+
+        // Counts are halved after this many writes, so
+        // older writes weigh less than recent ones.
+        static unsigned constexpr window = 32;
+
+        std::uint16_t count_[buckets] = {};
+        unsigned writes_ = 0;
+
+    public:
+        void
+        insert(std::size_t size) noexcept
+        {
+            unsigned i = 0;
+            while(i < buckets - 1 && size > (min_bucket << i))
+                ++i;
+            ++count_[i];
+            if(++writes_ < window)
+                return;
+            writes_ = 0;
+            for(auto& n : count_)
+                n /= 2;
+        }
+
+        // Returns the smallest bucket size which holds three
+        // quarters of the recent writes, or the largest value
+        // if there are none or they are mostly larger.
+        std::size_t
+        threshold() const noexcept
+        {
+            unsigned total = 0;
+            for(auto n : count_)
+                total += n;
+            unsigned sum = 0;
+            for(unsigned i = 0; i < buckets - 1; ++i)
+            {
+                sum += count_[i];
+                if(total > 0 && 4 * sum >= 3 * total)
+                    return min_bucket << i;
+            }
+            return (std::numeric_limits<std::size_t>::max)();
+        }
+    };
+
     struct flatten_result
     {
         std::size_t size;
+        std::size_t count;
         bool flatten;
     };
 
@@ -39,27 +101,37 @@ public:
     static
     flatten_result
     flatten(
-        BufferSequence const& buffers, std::size_t limit)
+        BufferSequence const& buffers,
+        std::size_t limit,
+        bool adaptive = false)
     {
-        flatten_result result{0, false};
+        flatten_result result{0, 0, false};
         auto first = net::buffer_sequence_begin(buffers);
         auto last = net::buffer_sequence_end(buffers);
         if(first != last)
         {
             result.size = buffer_bytes(*first);
+            result.count = 1;
             if(result.size < limit)
             {
                 auto it = first;
-                auto prev = first;
                 while(++it != last)
                 {
                     auto const n = buffer_bytes(*it);
                     if(result.size + n > limit)
                         break;
                     result.size += n;
-                    prev = it;
+                    ++result.count;
                 }
-                result.flatten = prev != first;
+                result.flatten = result.count > 1;
+            }
+            else if(adaptive &&
+                result.size > record_size &&
+                std::next(first) != last)
+            {
+                // Write whole records only, the remainder
+                // is coalesced with the buffers after it.
+                result.size -= result.size % record_size;
             }
         }
         return result;
@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_OP_CACHE_HPP
+#define BOOST_BEAST_CORE_DETAIL_OP_CACHE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  Recycles the memory used by the intermediate handlers of a stream.
+
+    A stream keeps one of these and uses its allocator as the default
+    associated allocator of its composed operations, so that handlers
+    without an allocator of their own stop reaching the global heap
+    once the stream has warmed up.
+
+    Freed blocks are parked in a few slots and handed back out to the
+    next allocation which fits. Each block records the cache it came
+    from, so deallocation does not depend on the allocator instance
+    used: Asio obtains that allocator from a handler which may already
+    be destroyed. The shared state is reference counted by the owner,
+    by each allocator and by every outstanding block, since operations
+    can outlive the stream which started them and still allocate while
+    the next layer is torn down.
+
+    Completion of one operation can race with the initiation of
+    another on the same stream, so the slots are atomic.
+*/
+class op_cache
+{
+    static std::size_t constexpr slots = 4;
+
+    struct state;
+
+    struct header
+    {
+        state* s;
+        std::size_t size;
+    };
+
+    // Offset of user memory from the start of a block
+    static std::size_t constexpr offset =
+        (sizeof(header) + alignof(std::max_align_t) - 1) &
+            ~(alignof(std::max_align_t) - 1);
+
+    struct state
+    {
+        std::atomic<std::size_t> refs{1};
+        std::atomic<std::size_t> fresh{0};
+        std::atomic<header*> v[slots];
+
+        state()
+        {
+            for(auto& p : v)
+                p.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~state()
+        {
+            for(auto& p : v)
+                if(auto h = p.load(std::memory_order_relaxed))
+                    ::operator delete(h);
+        }
+
+        void
+        release() noexcept
+        {
+            if(refs.fetch_sub(1,
+                    std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        void*
+        allocate(std::size_t n)
+        {
+            header* h = nullptr;
+            for(auto& p : v)
+            {
+                if(! p.load(std::memory_order_relaxed))
+                    continue;
+                h = p.exchange(nullptr,
+                    std::memory_order_acquire);
+                if(! h)
+                    continue;
+                if(h->size >= n)
+                    break;
+                // too small, put it back
+                header* expected = nullptr;
+                if(! p.compare_exchange_strong(expected, h,
+                        std::memory_order_release,
+                        std::memory_order_relaxed))
+                    ::operator delete(h);
+                h = nullptr;
+            }
+            if(! h)
+            {
+                if(n > (std::numeric_limits<
+                        std::size_t>::max)() - offset - 63)
+                    BOOST_THROW_EXCEPTION(std::bad_alloc{});
+                // Round up so that nearby sizes share blocks
+                auto const size = (n + 63) & ~std::size_t(63);
+                h = static_cast<header*>(
+                    ::operator new(offset + size));
+                h->s = this;
+                h->size = size;
+                fresh.fetch_add(1, std::memory_order_relaxed);
+            }
+            refs.fetch_add(1, std::memory_order_relaxed);
+            return reinterpret_cast<char*>(h) + offset;
+        }
+
+        static
+        void
+        deallocate(void* p) noexcept
+        {
+            auto h = reinterpret_cast<header*>(
+                static_cast<char*>(p) - offset);
+            auto const s = h->s;
+            for(auto& slot : s->v)
+            {
+                header* expected = nullptr;
+                if(slot.compare_exchange_strong(expected, h,
+                        std::memory_order_release,
+                        std::memory_order_relaxed))
+                {
+                    h = nullptr;
+                    break;
+                }
+            }
+            if(h)
+                ::operator delete(h);
+            s->release();
+        }
+    };
+
+    state* s_;
+
+public:
+    template<class T>
+    class allocator
+    {
+        template<class>
+        friend class allocator;
+
+        state* s_;
+
+    public:
+        using value_type = T;
+        using is_always_equal = std::false_type;
+
+        template<class U>
+        struct rebind
+        {
+            using other = allocator<U>;
+        };
+
+        ~allocator()
+        {
+            if(s_)
+                s_->release();
+        }
+
+        explicit
+        allocator(state* s) noexcept
+            : s_(s)
+        {
+            if(s_)
+                s_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        allocator(allocator const& other) noexcept
+            : allocator(other.s_)
+        {
+        }
+
+        template<class U>
+        allocator(allocator<U> const& other) noexcept
+            : allocator(other.s_)
+        {
+        }
+
+        allocator&
+        operator=(allocator const& other) noexcept
+        {
+            allocator tmp(other);
+            std::swap(s_, tmp.s_);
+            return *this;
+        }
+
+        T*
+        allocate(std::size_t n)
+        {
+            static_assert(
+                alignof(T) <= alignof(std::max_align_t),
+                "Over-aligned type not supported");
+            if(n > (std::numeric_limits<
+                    std::size_t>::max)() / sizeof(T))
+                BOOST_THROW_EXCEPTION(std::bad_alloc{});
+            return static_cast<T*>(
+                s_->allocate(n * sizeof(T)));
+        }
+
+        void
+        deallocate(T* p, std::size_t) noexcept
+        {
+            state::deallocate(p);
+        }
+
+        friend
+        bool
+        operator==(
+            allocator const& lhs,
+            allocator const& rhs) noexcept
+        {
+            return lhs.s_ == rhs.s_;
+        }
+
+        friend
+        bool
+        operator!=(
+            allocator const& lhs,
+            allocator const& rhs) noexcept
+        {
+            return lhs.s_ != rhs.s_;
+        }
+    };
+
+    using allocator_type = allocator<void>;
+
+    op_cache()
+        : s_(new state)
+    {
+    }
+
+    ~op_cache()
+    {
+        s_->release();
+    }
+
+    // Outstanding blocks stay with the old state
+    op_cache(op_cache&&)
+        : op_cache()
+    {
+    }
+
+    op_cache& operator=(op_cache const&) = delete;
+
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_type(s_);
+    }
+
+    // Return the number of blocks not in use by an operation
+    std::size_t
+    idle() const noexcept
+    {
+        std::size_t n = 0;
+        for(auto const& p : s_->v)
+            if(p.load(std::memory_order_relaxed))
+                ++n;
+        return n;
+    }
+
+    // Return the number of blocks obtained from the heap
+    std::size_t
+    allocated() const noexcept
+    {
+        return s_->fresh.load(std::memory_order_relaxed);
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
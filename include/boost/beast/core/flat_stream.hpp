@@ -92,11 +92,20 @@ class flat_stream
 {
     NextLayer stream_;
     flat_buffer buffer_;
+    std::size_t limit_ = max_size;
+    std::size_t coalesced_ = 0;
+    size_history history_;
+    unsigned idle_ = 0;
+    bool adaptive_ = false;
 
     BOOST_STATIC_ASSERT(has_get_executor<NextLayer>::value);
 
     struct ops;
 
+    template<class ConstBufferSequence>
+    flatten_result
+    plan(ConstBufferSequence const& buffers);
+
     template<class ConstBufferSequence>
     std::size_t
     stack_write_some(
@@ -175,6 +184,74 @@ public:
         return stream_;
     }
 
+    /** Set the largest number of bytes flattened into a single write.
+
+        Writes of a buffer sequence whose leading buffers total no
+        more than this many bytes are copied into an internal buffer
+        and written with a single call to the next layer. The default
+        is 16KB, the largest payload of a TLS record.
+
+        @param n The new limit. A value of zero disables flattening.
+    */
+    void
+    flatten_limit(std::size_t n) noexcept
+    {
+        limit_ = n;
+    }
+
+    /// Returns the largest number of bytes flattened into a single write
+    std::size_t
+    flatten_limit() const noexcept
+    {
+        return limit_;
+    }
+
+    /** Enable or disable adaptive flattening.
+
+        When enabled, the stream records the total sizes of recent
+        writes, and flattens only writes no larger than the size
+        which holds three quarters of them, rounded up to a power
+        of two no smaller than 1KB. Streams whose writes are mostly
+        small then stop copying the occasional large write, whose
+        buffers are big enough to be written efficiently as they
+        are. The flatten limit remains an upper bound.
+
+        The stream also shapes its writes around the size of a
+        TLS record. A leading buffer larger than one record
+        which is followed by more buffers is written only up to its
+        last whole record, so the remainder is coalesced with the
+        small buffers after it instead of going out as a short
+        record of its own. The internal buffer is also kept across
+        writes while recent writes are being flattened, instead of
+        being released by every write which is not.
+
+        Adaptive flattening is disabled by default.
+    */
+    void
+    adaptive_flatten(bool value) noexcept
+    {
+        adaptive_ = value;
+    }
+
+    /// Returns `true` if adaptive flattening is enabled
+    bool
+    adaptive_flatten() const noexcept
+    {
+        return adaptive_;
+    }
+
+    /** Returns the number of buffers coalesced so far.
+
+        Each write which copies two or more buffers of the caller's
+        sequence into a single buffer adds the number of buffers
+        copied to this count.
+    */
+    std::size_t
+    coalesced() const noexcept
+    {
+        return coalesced_;
+    }
+
     //--------------------------------------------------------------------------
 
     /** Read some data from the stream.
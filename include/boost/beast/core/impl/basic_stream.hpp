@@ -167,6 +167,16 @@ struct basic_stream<Protocol, Executor, RatePolicy>::
     op_state& state;
     boost::weak_ptr<impl_type> wp;
     tick_type tick;
+    detail::op_cache::allocator_type alloc;
+
+    using allocator_type =
+        detail::op_cache::allocator_type;
+
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return alloc;
+    }
 
     void
     operator()(error_code ec)
@@ -202,7 +212,8 @@ struct basic_stream<Protocol, Executor, RatePolicy>::ops
 
 template<bool isRead, class Buffers, class Handler>
 class transfer_op
-    : public async_base<Handler, Executor>
+    : public async_base<Handler, Executor,
+        detail::op_cache::allocator_type>
     , public boost::asio::coroutine
 {
     boost::shared_ptr<impl_type> impl_;
@@ -294,8 +305,10 @@ public:
         Handler_&& h,
         basic_stream& s,
         Buffers const& b)
-        : async_base<Handler, Executor>(
-            std::forward<Handler_>(h), s.get_executor())
+        : async_base<Handler, Executor,
+            detail::op_cache::allocator_type>(
+                std::forward<Handler_>(h), s.get_executor(),
+                s.impl_->cache.get_allocator())
         , impl_(s.impl_)
         , pg_(state().pending)
         , b_(b)
@@ -334,7 +347,8 @@ public:
                         timeout_handler{
                             state(),
                             impl_,
-                            state().tick
+                            state().tick,
+                            impl_->cache.get_allocator()
                         }));
 
             // check rate limit, maybe wait
@@ -404,7 +418,8 @@ public:
 
 template<class Handler>
 class connect_op
-    : public async_base<Handler, Executor>
+    : public async_base<Handler, Executor,
+        detail::op_cache::allocator_type>
 {
     boost::shared_ptr<impl_type> impl_;
     pending_guard pg0_;
@@ -422,8 +437,10 @@ public:
         Handler_&& h,
         basic_stream& s,
         endpoint_type ep)
-        : async_base<Handler, Executor>(
-            std::forward<Handler_>(h), s.get_executor())
+        : async_base<Handler, Executor,
+            detail::op_cache::allocator_type>(
+                std::forward<Handler_>(h), s.get_executor(),
+                s.impl_->cache.get_allocator())
         , impl_(s.impl_)
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
@@ -435,7 +452,8 @@ public:
                     timeout_handler{
                         state(),
                         impl_,
-                        state().tick}));
+                        state().tick,
+                        impl_->cache.get_allocator()}));
 
         impl_->socket.async_connect(
             ep, std::move(*this));
@@ -450,8 +468,10 @@ public:
         basic_stream& s,
         Endpoints const& eps,
         Condition const& cond)
-        : async_base<Handler, Executor>(
-            std::forward<Handler_>(h), s.get_executor())
+        : async_base<Handler, Executor,
+            detail::op_cache::allocator_type>(
+                std::forward<Handler_>(h), s.get_executor(),
+                s.impl_->cache.get_allocator())
         , impl_(s.impl_)
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
@@ -463,7 +483,8 @@ public:
                     timeout_handler{
                         state(),
                         impl_,
-                        state().tick}));
+                        state().tick,
+                        impl_->cache.get_allocator()}));
 
         net::async_connect(impl_->socket,
             eps, cond, std::move(*this));
@@ -478,8 +499,10 @@ public:
         basic_stream& s,
         Iterator begin, Iterator end,
         Condition const& cond)
-        : async_base<Handler, Executor>(
-            std::forward<Handler_>(h), s.get_executor())
+        : async_base<Handler, Executor,
+            detail::op_cache::allocator_type>(
+                std::forward<Handler_>(h), s.get_executor(),
+                s.impl_->cache.get_allocator())
         , impl_(s.impl_)
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
@@ -491,7 +514,8 @@ public:
                     timeout_handler{
                         state(),
                         impl_,
-                        state().tick}));
+                        state().tick,
+                        impl_->cache.get_allocator()}));
 
         net::async_connect(impl_->socket,
             begin, end, cond, std::move(*this));
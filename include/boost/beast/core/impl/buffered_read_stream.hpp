@@ -12,12 +12,14 @@
 
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 
 namespace boost {
 namespace beast {
@@ -34,6 +36,7 @@ class read_op
 {
     buffered_read_stream& s_;
     MutableBufferSequence b_;
+    std::size_t size_ = 0;
     int step_ = 0;
 
 public:
@@ -65,7 +68,9 @@ public:
         case 0:
             if(s_.buffer_.size() == 0)
             {
-                if(s_.capacity_ == 0)
+                if(s_.capacity_ != 0)
+                    size_ = s_.fill_size();
+                if(s_.capacity_ == 0 || buffer_bytes(b_) >= size_)
                 {
                     // read (unbuffered)
                     step_ = 1;
@@ -75,9 +80,8 @@ public:
                 // read
                 step_ = 2;
                 return s_.next_layer_.async_read_some(
-                    s_.buffer_.prepare(read_size(
-                        s_.buffer_, s_.capacity_)),
-                            std::move(*this));
+                    s_.buffer_.prepare(size_),
+                        std::move(*this));
             }
             step_ = 3;
             return net::post(
@@ -91,6 +95,7 @@ public:
 
         case 2:
             s_.buffer_.commit(bytes_transferred);
+            s_.on_fill(size_, bytes_transferred);
             BOOST_FALLTHROUGH;
 
         case 3:
@@ -140,6 +145,28 @@ buffered_read_stream(Args&&... args)
 {
 }
 
+template<class Stream, class DynamicBuffer>
+std::size_t
+buffered_read_stream<Stream, DynamicBuffer>::
+fill_size()
+{
+    auto const size = read_size(buffer_, capacity_);
+    if(fill_ <= size)
+        return size;
+    return (std::min)(fill_, (std::min)(capacity_,
+        buffer_.max_size() - buffer_.size()));
+}
+
+template<class Stream, class DynamicBuffer>
+void
+buffered_read_stream<Stream, DynamicBuffer>::
+on_fill(std::size_t size, std::size_t bytes_transferred) noexcept
+{
+    // Grow the next fill while reads keep filling the request
+    if(bytes_transferred == size && size < capacity_)
+        fill_ = size < capacity_ / 2 ? 2 * size : capacity_;
+}
+
 template<class Stream, class DynamicBuffer>
 template<class ConstBufferSequence, class WriteHandler>
 BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
@@ -191,15 +218,22 @@ read_some(MutableBufferSequence const& buffers,
     static_assert(net::is_mutable_buffer_sequence<
         MutableBufferSequence>::value,
             "MutableBufferSequence type requirements not met");
+    // The borrower owns the buffered data
+    if(lent_ > 0)
+        return next_layer_.read_some(buffers, ec);
     if(buffer_.size() == 0)
     {
         if(capacity_ == 0)
             return next_layer_.read_some(buffers, ec);
-        buffer_.commit(next_layer_.read_some(
-            buffer_.prepare(read_size(buffer_,
-                capacity_)), ec));
+        auto const size = fill_size();
+        if(buffer_bytes(buffers) >= size)
+            return next_layer_.read_some(buffers, ec);
+        auto const n = next_layer_.read_some(
+            buffer_.prepare(size), ec);
+        buffer_.commit(n);
         if(ec)
             return 0;
+        on_fill(size, n);
     }
     else
     {
@@ -224,7 +258,7 @@ async_read_some(
     static_assert(net::is_mutable_buffer_sequence<
         MutableBufferSequence>::value,
             "MutableBufferSequence type requirements not met");
-    if(buffer_.size() == 0 && capacity_ == 0)
+    if(lent_ > 0 || (buffer_.size() == 0 && capacity_ == 0))
         return next_layer_.async_read_some(buffers,
             std::forward<ReadHandler>(handler));
     return net::async_initiate<
@@ -45,11 +45,9 @@ public:
                 std::forward<Handler_>(h),
                 s.get_executor())
     {
-        auto const result =
-            flatten(b, max_size);
+        auto const result = s.plan(b);
         if(result.flatten)
         {
-            s.buffer_.clear();
             s.buffer_.commit(net::buffer_copy(
                 s.buffer_.prepare(result.size),
                 b, result.size));
@@ -58,8 +56,6 @@ public:
         }
         else
         {
-            s.buffer_.clear();
-            s.buffer_.shrink_to_fit();
             s.stream_.async_write_some(
                 beast::buffers_prefix(
                     result.size, b), std::move(*this));
@@ -180,6 +176,36 @@ write_some(ConstBufferSequence const& buffers)
     return n;
 }
 
+template<class NextLayer>
+template<class ConstBufferSequence>
+auto
+flat_stream<NextLayer>::
+plan(ConstBufferSequence const& buffers) ->
+    flatten_result
+{
+    auto limit = limit_;
+    if(adaptive_)
+    {
+        auto const threshold = history_.threshold();
+        if(limit > threshold)
+            limit = threshold;
+        history_.insert(buffer_bytes(buffers));
+    }
+    auto const result = flatten(buffers, limit, adaptive_);
+    buffer_.clear();
+    if(result.flatten)
+    {
+        coalesced_ += result.count;
+        idle_ = 0;
+    }
+    else if(! adaptive_ || ++idle_ >= max_idle)
+    {
+        buffer_.shrink_to_fit();
+        idle_ = 0;
+    }
+    return result;
+}
+
 template<class NextLayer>
 template<class ConstBufferSequence>
 std::size_t
@@ -206,20 +232,17 @@ write_some(ConstBufferSequence const& buffers, error_code& ec)
     static_assert(net::is_const_buffer_sequence<
         ConstBufferSequence>::value,
         "ConstBufferSequence type requirements not met");
-    auto const result = flatten(buffers, max_size);
+    auto const result = plan(buffers);
     if(result.flatten)
     {
         if(result.size <= max_stack)
             return stack_write_some(result.size, buffers, ec);
 
-        buffer_.clear();
         buffer_.commit(net::buffer_copy(
             buffer_.prepare(result.size),
             buffers));
         return stream_.write_some(buffer_.data(), ec);
     }
-    buffer_.clear();
-    buffer_.shrink_to_fit();
     return stream_.write_some(
         boost::beast::buffers_prefix(result.size, buffers), ec);
 }
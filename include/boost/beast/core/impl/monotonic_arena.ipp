@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_MONOTONIC_ARENA_IPP
+#define BOOST_BEAST_IMPL_MONOTONIC_ARENA_IPP
+
+#include <boost/beast/core/monotonic_arena.hpp>
+#include <boost/throw_exception.hpp>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+monotonic_arena::
+~monotonic_arena()
+{
+    release(head_);
+    release(spare_);
+}
+
+void*
+monotonic_arena::
+allocate_slow(std::size_t n, std::size_t align)
+{
+    auto const max = (std::numeric_limits<std::size_t>::max)();
+    if(n > max - sizeof(block) - align)
+        BOOST_THROW_EXCEPTION(std::bad_alloc{});
+    auto const needed = n + align - 1;
+    block* b;
+    if(spare_ && spare_->size >= needed)
+    {
+        b = spare_;
+        spare_ = nullptr;
+    }
+    else
+    {
+        auto const size = needed > next_size_ ? needed : next_size_;
+        if(size > max - sizeof(block))
+            BOOST_THROW_EXCEPTION(std::bad_alloc{});
+        b = ::new(::operator new(sizeof(block) + size)) block;
+        b->size = size;
+        if(size <= max / 2)
+            next_size_ = 2 * size;
+    }
+    b->next = head_;
+    head_ = b;
+    p_ = b->data();
+    end_ = p_ + b->size;
+
+    auto const pad = padding(p_, align);
+    auto const p = p_ + pad;
+    p_ = p + n;
+    size_ += pad + n;
+    return p;
+}
+
+void
+monotonic_arena::
+release(block* b) noexcept
+{
+    while(b)
+    {
+        auto const next = b->next;
+        b->~block();
+        ::operator delete(b);
+        b = next;
+    }
+}
+
+void
+monotonic_arena::
+reset() noexcept
+{
+    // Keep the largest block for reuse
+    auto keep = spare_;
+    while(head_)
+    {
+        auto b = head_;
+        head_ = b->next;
+        b->next = nullptr;
+        if(! keep || b->size > keep->size)
+            std::swap(keep, b);
+        release(b);
+    }
+    spare_ = keep;
+    p_ = buf_;
+    end_ = buf_ + buf_size_;
+    size_ = 0;
+}
+
+void
+monotonic_arena::
+shrink_to_fit() noexcept
+{
+    release(head_);
+    release(spare_);
+    head_ = nullptr;
+    spare_ = nullptr;
+    p_ = buf_;
+    end_ = buf_ + buf_size_;
+    size_ = 0;
+}
+
+std::size_t
+monotonic_arena::
+capacity() const noexcept
+{
+    auto n = buf_size_;
+    for(auto b = head_; b; b = b->next)
+        n += b->size;
+    if(spare_)
+        n += spare_->size;
+    return n;
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,380 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_MONOTONIC_ARENA_HPP
+#define BOOST_BEAST_MONOTONIC_ARENA_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+/** A memory arena which releases everything at once.
+
+    Allocations are carved sequentially out of large blocks of
+    memory. Deallocation does nothing, except that the most recent
+    allocation may be given back so that a growing string or buffer
+    can reuse its own storage. All memory obtained from the arena
+    is reclaimed together by calling @ref reset, or when the arena
+    is destroyed.
+
+    The intended use is to hold everything belonging to a single
+    HTTP request and its response: the fields, the bodies and the
+    buffers used to read and write them. Declare one arena per
+    connection, construct those objects with an @ref arena_allocator
+    referring to it, and call @ref reset after they have been
+    destroyed, before the next request on the same connection is
+    read. Once the arena has grown to fit the largest message pair
+    seen, subsequent requests perform no dynamic allocation at all.
+
+    @par Example
+    @code
+    monotonic_arena arena(16384);
+    for(;;)
+    {
+        {
+            http::request<http::string_body,
+                http::basic_fields<arena_allocator<char>>> req(
+                    std::piecewise_construct,
+                    std::make_tuple(),
+                    std::make_tuple(arena_allocator<char>(arena)));
+            http::read(stream, buffer, req);
+            ...
+        }
+        arena.reset();
+    }
+    @endcode
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+
+    @see arena_allocator
+*/
+class monotonic_arena
+{
+    struct block
+    {
+        block* next;
+        std::size_t size;
+
+        char*
+        data() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    block* head_ = nullptr;
+    block* spare_ = nullptr;
+    char* buf_ = nullptr;
+    std::size_t buf_size_ = 0;
+    char* p_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t next_size_;
+    std::size_t size_ = 0;
+
+    BOOST_BEAST_DECL
+    void*
+    allocate_slow(std::size_t n, std::size_t align);
+
+    BOOST_BEAST_DECL
+    void
+    release(block* b) noexcept;
+
+    static
+    std::size_t
+    padding(char const* p, std::size_t align) noexcept
+    {
+        return static_cast<std::size_t>(
+            (0 - reinterpret_cast<std::uintptr_t>(p)) & (align - 1));
+    }
+
+public:
+    /// The alignment used when none is specified
+    static std::size_t constexpr default_alignment =
+        alignof(std::max_align_t);
+
+    /// The default size of the first block allocated
+    static std::size_t constexpr default_block_size = 4096;
+
+    /// Destructor
+    BOOST_BEAST_DECL
+    ~monotonic_arena();
+
+    monotonic_arena(monotonic_arena const&) = delete;
+    monotonic_arena& operator=(monotonic_arena const&) = delete;
+
+    /** Constructor
+
+        No memory is allocated until the first allocation.
+
+        @param block_size The size of the first block obtained
+        from the global heap. Each following block is twice the
+        size of the one before it.
+    */
+    explicit
+    monotonic_arena(
+        std::size_t block_size = default_block_size) noexcept
+        : next_size_(block_size)
+    {
+        if(next_size_ == 0)
+            next_size_ = 1;
+    }
+
+    /** Constructor
+
+        Allocations are made from the caller provided storage
+        first. Blocks are obtained from the global heap only
+        after it is exhausted.
+
+        @param buffer The storage to use. Ownership is not
+        transferred, and the storage must remain valid until the
+        arena is destroyed.
+
+        @param size The size of the storage in bytes.
+    */
+    monotonic_arena(void* buffer, std::size_t size) noexcept
+        : buf_(static_cast<char*>(buffer))
+        , buf_size_(size)
+        , p_(buf_)
+        , end_(buf_ + size)
+        , next_size_(size)
+    {
+        if(next_size_ == 0)
+            next_size_ = default_block_size;
+    }
+
+    /** Allocate memory.
+
+        @param n The number of bytes to allocate.
+
+        @param align The alignment of the returned pointer,
+        which must be a power of two.
+
+        @throws std::bad_alloc if the memory cannot be obtained.
+    */
+    void*
+    allocate(
+        std::size_t n,
+        std::size_t align = default_alignment)
+    {
+        BOOST_ASSERT(align > 0 && (align & (align - 1)) == 0);
+        auto const pad = padding(p_, align);
+        auto const avail =
+            static_cast<std::size_t>(end_ - p_);
+        if(pad > avail || n > avail - pad)
+            return allocate_slow(n, align);
+        auto const p = p_ + pad;
+        p_ = p + n;
+        size_ += pad + n;
+        return p;
+    }
+
+    /** Deallocate memory.
+
+        Storage is only reclaimed if `p` is the most recent
+        allocation. Otherwise this does nothing, and the memory
+        becomes available again after the next call to @ref reset.
+    */
+    void
+    deallocate(void* p, std::size_t n) noexcept
+    {
+        if(static_cast<char*>(p) + n == p_)
+        {
+            p_ = static_cast<char*>(p);
+            size_ -= n;
+        }
+    }
+
+    /** Release all allocations.
+
+        Every pointer previously returned by @ref allocate becomes
+        invalid. The largest block obtained from the heap is kept
+        for reuse, so that an arena which has reached its working
+        size stops allocating.
+    */
+    BOOST_BEAST_DECL
+    void
+    reset() noexcept;
+
+    /** Release all memory back to the heap.
+
+        Every pointer previously returned by @ref allocate becomes
+        invalid, and no block is kept for reuse.
+    */
+    BOOST_BEAST_DECL
+    void
+    shrink_to_fit() noexcept;
+
+    /// Return the number of bytes allocated since the last reset
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Return the number of bytes of storage held by the arena
+    BOOST_BEAST_DECL
+    std::size_t
+    capacity() const noexcept;
+};
+
+//------------------------------------------------------------------------------
+
+/** An allocator which obtains memory from a @ref monotonic_arena.
+
+    This meets the requirements of <em>Allocator</em>, and may be
+    used with @ref http::basic_fields, @ref http::basic_string_body,
+    @ref http::basic_dynamic_body, @ref basic_flat_buffer,
+    @ref basic_multi_buffer, and the standard containers. Copies
+    refer to the same arena, and compare equal. The arena must
+    outlive every container using the allocator.
+
+    @par Example
+    @code
+    monotonic_arena arena;
+    using alloc_type = arena_allocator<char>;
+    http::request<
+        http::basic_string_body<char,
+            std::char_traits<char>, alloc_type>,
+        http::basic_fields<alloc_type>> req(
+            std::piecewise_construct,
+            std::make_tuple(alloc_type(arena)),
+            std::make_tuple(alloc_type(arena)));
+    @endcode
+*/
+template<class T>
+class arena_allocator
+{
+    template<class>
+    friend class arena_allocator;
+
+    monotonic_arena* arena_;
+
+public:
+    using value_type = T;
+    using is_always_equal = std::false_type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template<class U>
+    struct rebind
+    {
+        using other = arena_allocator<U>;
+    };
+
+#if defined(_GLIBCXX_USE_CXX11_ABI) && (_GLIBCXX_USE_CXX11_ABI == 0)
+    // Workaround for g++
+    // basic_string assumes that allocators are default-constructible
+    // See: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=56437
+    arena_allocator() noexcept
+        : arena_(nullptr)
+    {
+    }
+#endif
+
+    /// Constructor
+    explicit
+    arena_allocator(monotonic_arena& arena) noexcept
+        : arena_(&arena)
+    {
+    }
+
+    /// Constructor
+    template<class U>
+    arena_allocator(arena_allocator<U> const& other) noexcept
+        : arena_(other.arena_)
+    {
+    }
+
+    /// Return the arena used by this allocator
+    monotonic_arena&
+    arena() const noexcept
+    {
+        return *arena_;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return static_cast<std::size_t>((std::numeric_limits<
+            std::ptrdiff_t>::max)()) / sizeof(T);
+    }
+
+    value_type*
+    allocate(std::size_t n)
+    {
+        if(n > max_size())
+            BOOST_THROW_EXCEPTION(std::bad_alloc{});
+        return static_cast<value_type*>(
+            arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void
+    deallocate(value_type* p, std::size_t n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+#if defined(BOOST_LIBSTDCXX_VERSION) && BOOST_LIBSTDCXX_VERSION < 60000
+    template<class U, class... Args>
+    void
+    construct(U* ptr, Args&&... args)
+    {
+        ::new(static_cast<void*>(ptr)) U(
+            std::forward<Args>(args)...);
+    }
+
+    template<class U>
+    void
+    destroy(U* ptr)
+    {
+        ptr->~U();
+    }
+#endif
+
+    template<class U>
+    friend
+    bool
+    operator==(
+        arena_allocator const& lhs,
+        arena_allocator<U> const& rhs) noexcept
+    {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+    template<class U>
+    friend
+    bool
+    operator!=(
+        arena_allocator const& lhs,
+        arena_allocator<U> const& rhs) noexcept
+    {
+        return ! (lhs == rhs);
+    }
+};
+
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/monotonic_arena.ipp>
+#endif
+
+#endif
@@ -24,9 +24,13 @@
 #include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/file_body.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/beast/http/multipart_body.hpp>
 #include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/prepared_message.hpp>
 #include <boost/beast/http/read.hpp>
+#include <boost/beast/http/relay.hpp>
 #include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/http/serialize.hpp>
 #include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/span_body.hpp>
 #include <boost/beast/http/status.hpp>
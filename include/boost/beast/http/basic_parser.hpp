@@ -19,6 +19,7 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/optional.hpp>
 #include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <limits>
 #include <memory>
 #include <type_traits>
@@ -53,7 +54,7 @@ namespace http {
     or more calls to virtual functions, which the derived class must
     implement.
 
-    Every virtual function must be provided by the derived class,
+    Every pure virtual function must be provided by the derived class,
     or else a compilation error will be generated. The implementation
     will make sure that `ec` is clear before each virtual function
     is invoked. If a virtual function sets an error, it is propagated
@@ -75,6 +76,13 @@ class basic_parser
     std::uint64_t len0_ = 0;                // content length if known
     std::unique_ptr<char[]> buf_;           // temp storage
     std::size_t buf_len_ = 0;               // size of buf_
+    std::unique_ptr<char[]> run_;           // coalesced chunk bodies
+    char const* run_data_ = nullptr;        // chunk bodies held back
+    std::size_t run_len_ = 0;               // size of run_data_
+    char const* run_start_ = nullptr;       // first held back chunk body
+    std::size_t run_first_ = 0;             // size of first held back body
+    std::size_t run_hdrs_ = 0;              // chunk headers parsed in run
+    std::size_t hdr_skip_ = 0;              // chunk headers not to report
     std::size_t skip_ = 0;                  // resume search here
     std::uint32_t header_limit_ = 8192;     // max header size
     unsigned short status_ = 0;             // response status
@@ -84,6 +92,9 @@ class basic_parser
     // limit on the size of the stack flat buffer
     static std::size_t constexpr max_stack_buffer = 8192;
 
+    // limit on the size of coalesced chunk bodies
+    static std::size_t constexpr max_chunk_run = 4096;
+
     // Message will be complete after reading header
     static unsigned constexpr flagSkipBody              = 1<<  0;
 
@@ -109,6 +120,9 @@ class basic_parser
     static unsigned constexpr flagUpgrade               = 1<< 12;
     static unsigned constexpr flagFinalChunk            = 1<< 13;
 
+    // Deliver consecutive chunk bodies together
+    static unsigned constexpr flagCoalesceChunks        = 1<< 14;
+
     static constexpr
     std::uint64_t
     default_body_limit(std::true_type)
@@ -352,6 +366,49 @@ public:
         return (f_ & flagSkipBody) != 0;
     }
 
+    /// Returns `true` if the coalesce chunks option is set.
+    bool
+    coalesce_chunks() const
+    {
+        return (f_ & flagCoalesceChunks) != 0;
+    }
+
+    /** Set the coalesce chunks option.
+
+        Normally the body of each chunk in a chunked message is delivered
+        with its own call to @ref on_chunk_body_impl. When a peer sends
+        many small chunks, this per-chunk cost can exceed the cost of the
+        octets themselves. With this option set, chunks whose bodies are
+        entirely present in the input are held back and delivered together
+        in one call of up to 4096 octets, before @ref put returns. A chunk
+        which is larger, or only partly present, is delivered as usual.
+
+        Chunk boundaries are not preserved: @ref on_chunk_header_impl is
+        still invoked for every chunk, but may be invoked for several
+        chunks before their bodies are delivered, and the `remain`
+        argument counts the octets of the combined bodies. If the body
+        callback consumes fewer octets than it is given, for example
+        because a @ref buffer_body has run out of space, the parser
+        rewinds to the first octet not consumed, @ref put returns the
+        number of octets consumed up to that point, and the remaining
+        chunks are parsed again by the next call without reporting their
+        headers twice. The option is most effective together with the
+        eager parse option.
+
+        The default setting is `false`.
+
+        @param v `true` to set the coalesce chunks option or `false`
+        to disable it.
+    */
+    void
+    coalesce_chunks(bool v)
+    {
+        if(v)
+            f_ |= flagCoalesceChunks;
+        else
+            f_ &= ~flagCoalesceChunks;
+    }
+
     /** Set the skip parse option.
 
         This option controls whether or not the parser expects to see an HTTP
@@ -431,6 +488,47 @@ public:
     void
     put_eof(error_code& ec);
 
+    /** Return a buffer for receiving body octets directly.
+
+        When the body has a known Content-Length with octets
+        remaining, this function asks the derived class for
+        a buffer which the caller may fill with up to `size`
+        further octets of the body, straight from the stream.
+        The octets are then delivered with @ref commit_body,
+        instead of being copied through @ref put.
+
+        An empty buffer is returned if the body is not sized
+        by Content-Length, if no octets remain, or if the
+        derived class does not support direct reads. In this
+        case the caller should keep using @ref put.
+
+        @param size The largest number of octets wanted. The
+        returned buffer is never larger than the remaining
+        content length.
+
+        @param ec Set to the error, if any occurred.
+
+        @note Only valid after parsing a complete header.
+    */
+    net::mutable_buffer
+    prepare_body(std::size_t size, error_code& ec);
+
+    /** Deliver body octets received directly.
+
+        This function accounts for `n` octets written to the
+        front of the buffer returned by the last call to
+        @ref prepare_body. The message is complete once the
+        remaining content length reaches zero.
+
+        @param n The number of octets received, which may be
+        zero. This must not exceed the size of the buffer
+        returned by @ref prepare_body.
+
+        @param ec Set to the error, if any occurred.
+    */
+    void
+    commit_body(std::size_t n, error_code& ec);
+
 protected:
     /** Called after receiving the request-line.
 
@@ -621,6 +719,50 @@ protected:
     void
     on_finish_impl(error_code& ec) = 0;
 
+    /** Called to obtain a buffer for receiving body octets directly.
+
+        This virtual function is invoked by @ref prepare_body. It is
+        only used when the body has a known Content-Length. The
+        default implementation returns an empty buffer, indicating
+        that the body is only received through @ref on_body_impl.
+
+        @param size The largest number of octets wanted.
+
+        @param ec An output parameter which the function may set to indicate
+        an error. The error will be clear before this function is invoked.
+
+        @return A buffer of at most `size` octets.
+    */
+    virtual
+    net::mutable_buffer
+    on_body_prepare_impl(
+        std::size_t size,
+        error_code& ec)
+    {
+        boost::ignore_unused(size, ec);
+        return {};
+    }
+
+    /** Called when body octets were received directly.
+
+        This virtual function is invoked by @ref commit_body, with
+        the number of octets written to the front of the buffer
+        returned by the last call to @ref on_body_prepare_impl.
+
+        @param size The number of octets received.
+
+        @param ec An output parameter which the function may set to indicate
+        an error. The error will be clear before this function is invoked.
+    */
+    virtual
+    void
+    on_body_commit_impl(
+        std::size_t size,
+        error_code& ec)
+    {
+        boost::ignore_unused(size, ec);
+    }
+
 private:
     template<class ConstBufferSequence>
     std::size_t
@@ -673,6 +815,9 @@ private:
     parse_chunk_body(char const*& p,
         std::size_t n, error_code& ec);
 
+    bool
+    flush_chunk_run(char const*& p, error_code& ec);
+
     void
     do_field(field f,
         string_view value, error_code& ec);
@@ -186,6 +186,11 @@ struct basic_parser_base
     bool
     parse_hex(char const*& it, std::uint64_t& v);
 
+    BOOST_BEAST_DECL
+    static
+    bool
+    parse_hex(char const*& it, char const* last, std::uint64_t& v);
+
     BOOST_BEAST_DECL
     static
     bool
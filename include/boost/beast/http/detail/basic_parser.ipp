@@ -11,8 +11,16 @@
 #define BOOST_BEAST_HTTP_DETAIL_BASIC_PARSER_IPP
 
 #include <boost/beast/http/detail/basic_parser.hpp>
+#include <boost/endian/conversion.hpp>
+#include <cstring>
 #include <limits>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define BOOST_BEAST_HTTP_PARSER_SSE2
+# include <emmintrin.h> // _mm_cmpeq_epi8
+#endif
+
 namespace boost {
 namespace beast {
 namespace http {
@@ -117,13 +125,24 @@ find_fast(
     return {buf, found};
 }
 
-// VFALCO Can SIMD help this?
 char const*
 basic_parser_base::
 find_eol(
     char const* it, char const* last,
         error_code& ec)
 {
+#ifdef BOOST_BEAST_HTTP_PARSER_SSE2
+    // Skip 16 octets at a time until one holds a CR
+    auto const cr = _mm_set1_epi8('\r');
+    while(last - it >= 16)
+    {
+        auto const v = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(it));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(v, cr)) != 0)
+            break;
+        it += 16;
+    }
+#endif
     for(;;)
     {
         if(it == last)
@@ -201,6 +220,60 @@ parse_hex(char const*& it, std::uint64_t& v)
     return true;
 }
 
+/*  Chunk sizes are almost always shorter than eight digits, so when
+    eight octets may be read, they are classified and converted at
+    once in a 64-bit word instead of through the table one at a time.
+*/
+bool
+basic_parser_base::
+parse_hex(char const*& it, char const* last, std::uint64_t& v)
+{
+    if(last - it < 8)
+        return parse_hex(it, v);
+    std::uint64_t x;
+    std::memcpy(&x, it, sizeof(x));
+    x = endian::little_to_native(x);
+
+    // Sets the high bit of each octet greater than lo and less
+    // than hi, for octets below 128 and 0 <= lo < hi <= 128.
+    std::uint64_t constexpr ones = 0x0101010101010101;
+    auto const between =
+        [](std::uint64_t w, std::uint64_t lo, std::uint64_t hi)
+        {
+            auto const t = w & (ones * 127);
+            return (ones * (127 + hi) - t) & ~w &
+                (t + ones * (127 - lo)) & (ones * 128);
+        };
+    auto const alpha = between(x | (ones * 0x20), 0x60, 0x67);
+    auto stop = ~(between(x, 0x2f, 0x3a) | alpha) & (ones * 128);
+    if(stop == 0)
+        return parse_hex(it, v);
+#if defined(BOOST_GCC) || defined(BOOST_CLANG)
+    auto const n = static_cast<unsigned>(__builtin_ctzll(stop) >> 3);
+#else
+    unsigned n = 0;
+    while(! (stop & 0x80))
+    {
+        stop >>= 8;
+        ++n;
+    }
+#endif
+    if(n == 0)
+        return false;
+
+    // Right-align the n digit values as an eight digit
+    // number, then gather the nibbles pairwise.
+    x = (x & (ones * 0x0f)) + (alpha >> 7) * 9;
+    x <<= 8 * (8 - n);
+    x = ((x & 0x000f000f000f000f) << 4) |
+        ((x >> 8) & 0x000f000f000f000f);
+    x = ((x & 0x000000ff000000ff) << 8) |
+        ((x >> 16) & 0x000000ff000000ff);
+    v = ((x & 0xffff) << 16) | (x >> 32);
+    it += n;
+    return true;
+}
+
 char const*
 basic_parser_base::
 find_eom(char const* p, char const* last)
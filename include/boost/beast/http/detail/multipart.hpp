@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_DETAIL_MULTIPART_HPP
+#define BOOST_BEAST_HTTP_DETAIL_MULTIPART_HPP
+
+#include <boost/beast/core/string.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+namespace detail {
+
+// Finds a multipart delimiter using Boyer-Moore-Horspool.
+//
+// The delimiter is at most 74 octets, "\r\n--" followed
+// by a boundary of up to 70, so the shift table fits
+// in one octet per entry.
+//
+class multipart_search
+{
+    std::string d_;
+    std::uint8_t skip_[256];
+
+public:
+    static std::size_t constexpr npos =
+        static_cast<std::size_t>(-1);
+
+    multipart_search() = default;
+
+    multipart_search(multipart_search const&) = delete;
+    multipart_search& operator=(multipart_search const&) = delete;
+
+    void
+    reset(string_view boundary)
+    {
+        BOOST_ASSERT(boundary.size() <= 70);
+        d_.assign("\r\n--");
+        d_.append(boundary.data(), boundary.size());
+        auto const m = d_.size();
+        std::memset(skip_, static_cast<int>(m), sizeof(skip_));
+        for(std::size_t i = 0; i + 1 < m; ++i)
+            skip_[static_cast<unsigned char>(d_[i])] =
+                static_cast<std::uint8_t>(m - 1 - i);
+    }
+
+    string_view
+    delimiter() const
+    {
+        return d_;
+    }
+
+    // Returns the offset of the first delimiter, or npos
+    std::size_t
+    find(char const* p, std::size_t n) const
+    {
+        auto const m = d_.size();
+        if(n < m)
+            return npos;
+        auto const last = m - 1;
+        auto const c0 = d_[last];
+        for(std::size_t i = 0; i <= n - m;)
+        {
+            auto const c = p[i + last];
+            if(c == c0 && std::memcmp(
+                    p + i, d_.data(), last) == 0)
+                return i;
+            i += skip_[static_cast<unsigned char>(c)];
+        }
+        return npos;
+    }
+
+    // Returns the offset of the first octet which may begin
+    // a delimiter continued past the end, or `n` if none.
+    std::size_t
+    find_partial(char const* p, std::size_t n) const
+    {
+        auto const m = d_.size();
+        auto i = n > m - 1 ? n - (m - 1) : 0;
+        for(; i < n; ++i)
+        {
+            // '\r' only appears first in the delimiter
+            if(p[i] != '\r')
+                continue;
+            if(std::memcmp(p + i, d_.data(), n - i) == 0)
+                return i;
+        }
+        return n;
+    }
+};
+
+} // detail
+} // http
+} // beast
+} // boost
+
+#endif
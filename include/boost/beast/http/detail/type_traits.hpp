@@ -10,7 +10,9 @@
 #ifndef BOOST_BEAST_HTTP_DETAIL_TYPE_TRAITS_HPP
 #define BOOST_BEAST_HTTP_DETAIL_TYPE_TRAITS_HPP
 
+#include <boost/beast/core/error.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/asio/buffer.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
 
@@ -96,6 +98,30 @@ struct is_body_sized<T, beast::detail::void_t<
         T::size(std::declval<typename T::value_type const&>())
     )>> : std::true_type {};
 
+/** Determine if a <em>Body</em> reader accepts octets in place
+
+    This metafunction is equivalent to `std::true_type` if the
+    nested reader has the optional members `prepare`, returning
+    a mutable buffer for up to the given number of octets, and
+    `commit`, keeping the octets written to its front. The parser
+    uses them to read a body with a Content-Length straight from
+    the stream, without copying it out of the caller's buffer.
+*/
+template<class T, class = void>
+struct has_direct_reader : std::false_type {};
+
+template<class T>
+struct has_direct_reader<T, beast::detail::void_t<
+    decltype(
+    std::declval<net::mutable_buffer&>() =
+        std::declval<typename T::reader&>().prepare(
+            std::declval<std::size_t>(),
+            std::declval<error_code&>()),
+    std::declval<typename T::reader&>().commit(
+        std::declval<std::size_t>(),
+        std::declval<error_code&>())
+    )>> : std::true_type {};
+
 template<class T>
 struct is_fields_helper : T
 {
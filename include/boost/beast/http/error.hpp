@@ -153,7 +153,10 @@ enum class error
         a new parser for each message. This can be easily done by
         storing the parser in an boost or std::optional container.
     */
-    stale_parser
+    stale_parser,
+
+    /// The multipart body is malformed.
+    bad_multipart
 };
 
 } // http
@@ -17,7 +17,9 @@
 #include <boost/beast/core/detail/clamp.hpp>
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/make_unique.hpp>
 #include <algorithm>
+#include <cstring>
 #include <utility>
 
 namespace boost {
@@ -216,6 +218,8 @@ loop:
         goto loop;
     }
 done:
+    if(run_len_ > 0)
+        flush_chunk_run(p, ec);
     return static_cast<std::size_t>(p - p0);
 }
 
@@ -248,6 +252,47 @@ put_eof(error_code& ec)
     state_ = state::complete;
 }
 
+template<bool isRequest>
+net::mutable_buffer
+basic_parser<isRequest>::
+prepare_body(std::size_t size, error_code& ec)
+{
+    BOOST_ASSERT(is_header_done());
+    ec = {};
+    if(state_ == state::body0)
+    {
+        this->on_body_init_impl(content_length(), ec);
+        if(ec)
+            return {};
+        state_ = state::body;
+    }
+    if(state_ != state::body)
+        return {};
+    BOOST_ASSERT(len_ > 0);
+    return this->on_body_prepare_impl(
+        beast::detail::clamp(len_, size), ec);
+}
+
+template<bool isRequest>
+void
+basic_parser<isRequest>::
+commit_body(std::size_t n, error_code& ec)
+{
+    BOOST_ASSERT(state_ == state::body);
+    BOOST_ASSERT(n <= len_);
+    ec = {};
+    this->on_body_commit_impl(n, ec);
+    if(ec)
+        return;
+    len_ -= n;
+    if(len_ > 0)
+        return;
+    this->on_finish_impl(ec);
+    if(ec)
+        return;
+    state_ = state::complete;
+}
+
 template<bool isRequest>
 void
 basic_parser<isRequest>::
@@ -642,7 +687,7 @@ parse_chunk_header(char const*& p0,
             std::size_t>(eol - 2 - p0);
 
         std::uint64_t size;
-        if(! parse_hex(p, size))
+        if(! parse_hex(p, pend, size))
         {
             ec = error::bad_chunk;
             return;
@@ -665,9 +710,14 @@ parse_chunk_header(char const*& p0,
                 return;
             }
             auto const ext = make_string(start, p);
-            this->on_chunk_header_impl(size, ext, ec);
+            if(hdr_skip_ > 0)
+                --hdr_skip_;
+            else
+                this->on_chunk_header_impl(size, ext, ec);
             if(ec)
                 return;
+            if(run_len_ > 0)
+                ++run_hdrs_;
             len_ = size;
             skip_ = 2;
             p0 = eol;
@@ -708,6 +758,8 @@ parse_chunk_header(char const*& p0,
         return;
     }
     auto const ext = make_string(start, p);
+    if(! flush_chunk_run(p0, ec) || ec)
+        return;
     this->on_chunk_header_impl(0, ext, ec);
     if(ec)
         return;
@@ -731,6 +783,39 @@ parse_chunk_body(char const*& p,
     std::size_t n, error_code& ec)
 {
     ec = {};
+    if( (f_ & flagCoalesceChunks) &&
+        len_ <= n && len_ <= max_chunk_run - run_len_)
+    {
+        // The whole chunk is in the input, so hold it
+        // back to deliver with the chunks which follow.
+        auto const size = static_cast<std::size_t>(len_);
+        if(run_len_ == 0)
+        {
+            run_data_ = p;
+            run_start_ = p;
+            run_first_ = size;
+            run_hdrs_ = 0;
+        }
+        else
+        {
+            if(run_data_ != run_.get())
+            {
+                if(! run_)
+                    run_ = boost::make_unique_noinit<
+                        char[]>(max_chunk_run);
+                std::memcpy(run_.get(), run_data_, run_len_);
+                run_data_ = run_.get();
+            }
+            std::memcpy(run_.get() + run_len_, p, size);
+        }
+        run_len_ += size;
+        p += size;
+        len_ = 0;
+        state_ = state::chunk_header;
+        return;
+    }
+    if(! flush_chunk_run(p, ec) || ec)
+        return;
     n = this->on_chunk_body_impl(
         len_, string_view{p,
             beast::detail::clamp(len_, n)}, ec);
@@ -740,6 +825,62 @@ parse_chunk_body(char const*& p,
         state_ = state::chunk_header;
 }
 
+template<bool isRequest>
+bool
+basic_parser<isRequest>::
+flush_chunk_run(char const*& p, error_code& ec)
+{
+    if(run_len_ == 0)
+        return true;
+    auto const size = run_len_;
+    run_len_ = 0;
+    // The parser cannot be restarted after
+    // an error, so held back octets are dropped.
+    if(ec && ec != error::need_more)
+        return true;
+    error_code ev;
+    auto const n = this->on_chunk_body_impl(
+        size, string_view{run_data_, size}, ev);
+    if(n >= size)
+    {
+        if(ev)
+            ec = ev;
+        return true;
+    }
+
+    // Some octets were not consumed. Walk the held back
+    // chunks, whose headers were already validated, to
+    // the one holding the first octet not consumed, and
+    // resume parsing inside its body. The headers after
+    // it were reported, so they are not reported again.
+    auto q = run_start_;
+    std::size_t len = run_first_;
+    std::size_t used = 0;
+    std::size_t hdrs = run_hdrs_;
+    while(used + len <= n)
+    {
+        used += len;
+        q += len + 2;
+        std::uint64_t v;
+        BOOST_VERIFY(parse_hex(q, v));
+        while(*q++ != '\n')
+            ;
+        len = static_cast<std::size_t>(v);
+        --hdrs;
+    }
+    body_limit_ += size - used - len;
+    if(state_ == state::chunk_body)
+        body_limit_ += len_;
+    hdr_skip_ += hdrs;
+    p = q + (n - used);
+    len_ = len - (n - used);
+    skip_ = 2;
+    f_ = (f_ | flagExpectCRLF) & ~flagFinalChunk;
+    state_ = state::chunk_body;
+    ec = ev;
+    return false;
+}
+
 template<bool isRequest>
 void
 basic_parser<isRequest>::
@@ -56,6 +56,7 @@ public:
         case error::bad_chunk_extension: return "bad chunk extension";
         case error::bad_obs_fold: return "bad obs-fold";
         case error::stale_parser: return "stale parser";
+        case error::bad_multipart: return "bad multipart";
 
         default:
             return "beast.http error";
@@ -21,6 +21,7 @@
 #include <boost/beast/http/chunk_encode.hpp>
 #include <boost/core/exchange.hpp>
 #include <boost/throw_exception.hpp>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -153,6 +154,7 @@ public:
 
     basic_fields const& f_;
     boost::optional<view_type> view_;
+    net::const_buffer line_[3];
     char buf_[13];
 
 public:
@@ -172,6 +174,41 @@ public:
     {
         return const_buffers_type(*view_);
     }
+
+    // Returns the number of octets in the header
+    std::size_t
+    size() const
+    {
+        std::size_t n = 2;
+        for(auto const& b : line_)
+            n += b.size();
+        for(auto const& e : f_.list_)
+            n += e.buffer().size();
+        return n;
+    }
+
+    // Copies the header to dest, which must have
+    // room for size() octets, returning the end.
+    char*
+    copy(char* dest) const
+    {
+        for(auto const& b : line_)
+        {
+            if(b.size() == 0)
+                continue;
+            std::memcpy(dest, b.data(), b.size());
+            dest += b.size();
+        }
+        for(auto const& e : f_.list_)
+        {
+            auto const b = e.buffer();
+            std::memcpy(dest, b.data(), b.size());
+            dest += b.size();
+        }
+        *dest++ = '\r';
+        *dest++ = '\n';
+        return dest;
+    }
 };
 
 template<class Allocator>
@@ -180,9 +217,9 @@ writer(basic_fields const& f)
     : f_(f)
 {
     view_.emplace(
-        net::const_buffer{nullptr, 0},
-        net::const_buffer{nullptr, 0},
-        net::const_buffer{nullptr, 0},
+        line_[0],
+        line_[1],
+        line_[2],
         field_range(f_.list_.begin(), f_.list_.end()),
         chunk_crlf());
 }
@@ -219,12 +256,15 @@ writer(basic_fields const& f,
     buf_[9] = '\r';
     buf_[10]= '\n';
 
+    line_[0] = {sv.data(), sv.size()};
+    line_[1] = {
+        f_.target_or_reason_.data(),
+        f_.target_or_reason_.size()};
+    line_[2] = {buf_, 11};
     view_.emplace(
-        net::const_buffer{sv.data(), sv.size()},
-        net::const_buffer{
-            f_.target_or_reason_.data(),
-            f_.target_or_reason_.size()},
-        net::const_buffer{buf_, 11},
+        line_[0],
+        line_[1],
+        line_[2],
         field_range(f_.list_.begin(), f_.list_.end()),
         chunk_crlf());
 }
@@ -261,10 +301,13 @@ writer(basic_fields const& f,
     else
         sv = obsolete_reason(static_cast<status>(code));
 
+    line_[0] = {buf_, 13};
+    line_[1] = {sv.data(), sv.size()};
+    line_[2] = {"\r\n", 2};
     view_.emplace(
-        net::const_buffer{buf_, 13},
-        net::const_buffer{sv.data(), sv.size()},
-        net::const_buffer{"\r\n", 2},
+        line_[0],
+        line_[1],
+        line_[2],
         field_range(f_.list_.begin(), f_.list_.end()),
         chunk_crlf{});
 }
@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_MULTIPART_BODY_HPP
+#define BOOST_BEAST_HTTP_IMPL_MULTIPART_BODY_HPP
+
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/http/detail/rfc7230.hpp>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+inline
+bool
+is_multipart_bchar(char c)
+{
+    // RFC 2046 bcharsnospace, and space
+    switch(c)
+    {
+    case '\'': case '(': case ')': case '+': case '_':
+    case ',': case '-': case '.': case '/': case ':':
+    case '=': case '?': case ' ':
+        return true;
+    default:
+        return
+            (c >= '0' && c <= '9') ||
+            (c >= 'a' && c <= 'z') ||
+            (c >= 'A' && c <= 'Z');
+    }
+}
+
+} // detail
+
+template<class File>
+void
+basic_multipart_body<File>::
+part::
+write(char const* p, std::size_t n, error_code& ec)
+{
+    size_ += n;
+    if(file_.is_open())
+    {
+        while(n > 0)
+        {
+            auto const used = file_.write(p, n, ec);
+            if(ec)
+                return;
+            p += used;
+            n -= used;
+        }
+    }
+    else if(cb_)
+    {
+        cb_(string_view(p, n), ec);
+    }
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+part::
+close(error_code& ec)
+{
+    if(file_.is_open())
+        file_.close(ec);
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+part::
+open(char const* path, error_code& ec)
+{
+    file_.open(path, file_mode::write, ec);
+}
+
+template<class File>
+std::string
+basic_multipart_body<File>::
+part::
+disposition_param(string_view name) const
+{
+    // Content-Disposition: form-data; name="field"; filename="a.txt"
+    auto const s = header_[field::content_disposition];
+    auto const pos = s.find(';');
+    if(pos == string_view::npos)
+        return {};
+    for(auto const& param : param_list{s.substr(pos)})
+        if(beast::iequals(param.first, name))
+            return std::string(param.second);
+    return {};
+}
+
+//------------------------------------------------------------------------------
+
+template<class File>
+template<bool isRequest, class Fields>
+basic_multipart_body<File>::
+reader::
+reader(header<isRequest, Fields>& h, value_type& b)
+    : body_(b)
+    , h_(&h)
+    , content_type_(&get_content_type<header<isRequest, Fields>>)
+{
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+reader::
+init(boost::optional<std::uint64_t> const&, error_code& ec)
+{
+    // Content-Type: multipart/form-data; boundary=xyz
+    //
+    // The reader is constructed before the header is
+    // received, so the boundary is only known now.
+    std::string boundary;
+    auto const s = content_type_(h_);
+    auto const pos = s.find(';');
+    if( beast::iequals(s.substr(0, 10), "multipart/") &&
+        pos != string_view::npos)
+    {
+        for(auto const& param : param_list{s.substr(pos)})
+        {
+            if(beast::iequals(param.first, "boundary"))
+            {
+                // The iterator owns an unquoted value
+                boundary = std::string(param.second);
+                break;
+            }
+        }
+    }
+    // A boundary is 1 to 70 characters, not ending in space
+    if( boundary.empty() ||
+        boundary.size() > 70 ||
+        boundary.back() == ' ' ||
+        ! std::all_of(boundary.begin(), boundary.end(),
+            &detail::is_multipart_bchar))
+    {
+        ec = error::bad_multipart;
+        return;
+    }
+    search_.reset(boundary);
+    // The first delimiter may begin the body, without
+    // the CRLF which precedes every other delimiter.
+    hold_.assign("\r\n");
+    s_ = s_content;
+    ec = {};
+}
+
+template<class File>
+template<class ConstBufferSequence>
+std::size_t
+basic_multipart_body<File>::
+reader::
+put(ConstBufferSequence const& buffers, error_code& ec)
+{
+    ec = {};
+    std::size_t total = 0;
+    for(auto it = net::buffer_sequence_begin(buffers);
+        it != net::buffer_sequence_end(buffers); ++it)
+    {
+        net::const_buffer b = *it;
+        auto p = static_cast<char const*>(b.data());
+        auto n = b.size();
+        while(n > 0)
+        {
+            auto const used = put_some(p, n, ec);
+            if(ec)
+                return total;
+            p += used;
+            n -= used;
+            total += used;
+        }
+    }
+    return total;
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+reader::
+finish(error_code& ec)
+{
+    if(s_ != s_done)
+    {
+        ec = error::bad_multipart;
+        return;
+    }
+    ec = {};
+}
+
+template<class File>
+std::size_t
+basic_multipart_body<File>::
+reader::
+put_some(char const* p, std::size_t n, error_code& ec)
+{
+    switch(s_)
+    {
+    case s_content:
+        return put_content(p, n, ec);
+
+    case s_header:
+        return put_header(p, n, ec);
+
+    case s_done:
+        // The epilogue is ignored
+        return n;
+
+    // After the delimiter comes "--" if it is the last,
+    // otherwise optional whitespace and then CRLF.
+
+    case s_boundary:
+        if(*p == '-')
+            s_ = s_close;
+        else if(*p == ' ' || *p == '\t')
+            s_ = s_padding;
+        else if(*p == '\r')
+            s_ = s_lf;
+        else
+            ec = error::bad_multipart;
+        return 1;
+
+    case s_close:
+        if(*p != '-')
+        {
+            ec = error::bad_multipart;
+            return 1;
+        }
+        end_part(ec);
+        s_ = s_done;
+        return 1;
+
+    case s_padding:
+        if(*p == '\r')
+            s_ = s_lf;
+        else if(*p != ' ' && *p != '\t')
+            ec = error::bad_multipart;
+        return 1;
+
+    case s_lf:
+        break;
+    }
+    if(*p != '\n')
+    {
+        ec = error::bad_multipart;
+        return 1;
+    }
+    end_part(ec);
+    hdr_.clear();
+    s_ = s_header;
+    return 1;
+}
+
+template<class File>
+std::size_t
+basic_multipart_body<File>::
+reader::
+put_content(char const* p, std::size_t n, error_code& ec)
+{
+    auto const d = search_.delimiter();
+    auto const m = d.size();
+    if(! hold_.empty())
+    {
+        // The octets held from before may begin a delimiter,
+        // this needs at most m more to tell.
+        auto const h = hold_.size();
+        auto const take = (std::min)(n, m);
+        hold_.append(p, take);
+        auto const i = search_.find(hold_.data(), hold_.size());
+        if(i < h)
+        {
+            if(in_part_)
+                part_.write(hold_.data(), i, ec);
+            hold_.clear();
+            s_ = s_boundary;
+            return i + m - h;
+        }
+        auto const k = search_.find_partial(
+            hold_.data(), hold_.size());
+        if(k < h)
+        {
+            // Still undecided, so everything was taken
+            BOOST_ASSERT(take == n);
+            if(in_part_)
+                part_.write(hold_.data(), k, ec);
+            hold_.erase(0, k);
+            return n;
+        }
+        hold_.resize(h);
+        if(in_part_)
+            part_.write(hold_.data(), h, ec);
+        hold_.clear();
+        if(ec)
+            return 0;
+    }
+    auto const i = search_.find(p, n);
+    if(i != detail::multipart_search::npos)
+    {
+        if(in_part_)
+            part_.write(p, i, ec);
+        s_ = s_boundary;
+        return i + m;
+    }
+    auto const k = search_.find_partial(p, n);
+    if(in_part_)
+        part_.write(p, k, ec);
+    hold_.assign(p + k, n - k);
+    return n;
+}
+
+template<class File>
+std::size_t
+basic_multipart_body<File>::
+reader::
+put_header(char const* p, std::size_t n, error_code& ec)
+{
+    // Never hold more than the limit, plus the final CRLF
+    auto const h = hdr_.size();
+    auto const limit = body_.header_limit_ + 4;
+    BOOST_ASSERT(h < limit);
+    auto const take = (std::min)(n, limit - h);
+    hdr_.append(p, take);
+    std::size_t end;
+    if(hdr_.size() >= 2 && hdr_[0] == '\r' && hdr_[1] == '\n')
+    {
+        // No fields
+        end = 2;
+    }
+    else
+    {
+        auto const pos = hdr_.find("\r\n\r\n", h > 3 ? h - 3 : 0);
+        if(pos == std::string::npos)
+        {
+            if(hdr_.size() > body_.header_limit_)
+                ec = error::header_limit;
+            return take;
+        }
+        end = pos + 4;
+        if(end > body_.header_limit_)
+        {
+            ec = error::header_limit;
+            return take;
+        }
+    }
+    parse_header(string_view(hdr_.data(), end - 2), ec);
+    if(ec)
+        return take;
+    in_part_ = true;
+    if(body_.on_part_)
+        body_.on_part_(part_, ec);
+    hdr_.clear();
+    s_ = s_content;
+    return end - h;
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+reader::
+parse_header(string_view s, error_code& ec)
+{
+    part_.header_.clear();
+    part_.cb_ = nullptr;
+    part_.size_ = 0;
+    while(! s.empty())
+    {
+        auto const eol = s.find("\r\n");
+        BOOST_ASSERT(eol != string_view::npos);
+        auto const line = s.substr(0, eol);
+        s.remove_prefix(eol + 2);
+        auto const colon = line.find(':');
+        if( colon == string_view::npos || colon == 0 ||
+            ! std::all_of(line.begin(), line.begin() + colon,
+                &detail::is_token_char))
+        {
+            ec = error::bad_multipart;
+            return;
+        }
+        auto value = line.substr(colon + 1);
+        while(! value.empty() &&
+            (value.front() == ' ' || value.front() == '\t'))
+            value.remove_prefix(1);
+        while(! value.empty() &&
+            (value.back() == ' ' || value.back() == '\t'))
+            value.remove_suffix(1);
+        part_.header_.insert(line.substr(0, colon), value);
+    }
+}
+
+template<class File>
+void
+basic_multipart_body<File>::
+reader::
+end_part(error_code& ec)
+{
+    if(! in_part_)
+        return;
+    in_part_ = false;
+    part_.close(ec);
+    if(ec)
+        return;
+    if(body_.on_part_end_)
+        body_.on_part_end_(part_, ec);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_HTTP_IMPL_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/type_traits.hpp>
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/throw_exception.hpp>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+template<class Serializer>
+class prepare_lambda
+{
+    std::string& s_;
+    Serializer& sr_;
+
+public:
+    prepare_lambda(std::string& s,
+            Serializer& sr)
+        : s_(s)
+        , sr_(sr)
+    {
+    }
+
+    template<class ConstBufferSequence>
+    void
+    operator()(error_code& ec,
+        ConstBufferSequence const& buffers) const
+    {
+        ec = {};
+        auto const size = s_.size();
+        auto const n = buffer_bytes(buffers);
+        s_.resize(size + n);
+        net::buffer_copy(
+            net::buffer(&s_[size], n), buffers);
+        sr_.consume(n);
+    }
+};
+
+template<
+    class Handler,
+    class Stream>
+class write_prepared_op
+    : public beast::stable_async_base<
+        Handler, beast::executor_type<Stream>>
+{
+public:
+    template<class Handler_>
+    write_prepared_op(
+        Handler_&& h,
+        Stream& s,
+        prepared_message const& m)
+        : stable_async_base<
+            Handler, beast::executor_type<Stream>>(
+                std::forward<Handler_>(h), s.get_executor())
+    {
+        // The copy must not move while the write is pending,
+        // since its buffers refer to the values it holds.
+        auto& mc = beast::allocate_stable<
+            prepared_message>(*this, m);
+        net::async_write(s, mc.buffers(), std::move(*this));
+    }
+
+    void
+    operator()(
+        error_code ec, std::size_t bytes_transferred)
+    {
+        this->complete_now(ec, bytes_transferred);
+    }
+};
+
+struct run_write_prepared_op
+{
+    template<
+        class WriteHandler,
+        class Stream>
+    void
+    operator()(
+        WriteHandler&& h,
+        Stream* s,
+        prepared_message const* m)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+            void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        write_prepared_op<
+            typename std::decay<WriteHandler>::type,
+            Stream>(
+                std::forward<WriteHandler>(h), *s, *m);
+    }
+};
+
+} // detail
+
+template<bool isRequest, class Body, class Fields>
+prepared_message::
+prepared_message(
+    message<isRequest, Body, Fields> const& msg,
+    std::initializer_list<field> fields)
+{
+    static_assert(is_body<Body>::value,
+        "Body type requirements not met");
+    static_assert(is_body_writer<Body>::value,
+        "BodyWriter type requirements not met");
+    std::string s;
+    serializer<isRequest, Body, Fields> sr{msg};
+    detail::prepare_lambda<decltype(sr)> f{s, sr};
+    error_code ec;
+    do
+    {
+        sr.next(ec, f);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+    }
+    while(! sr.is_done());
+    init(std::move(s), fields);
+}
+
+template<class SyncWriteStream>
+std::size_t
+write(
+    SyncWriteStream& stream,
+    prepared_message const& msg)
+{
+    static_assert(
+        is_sync_write_stream<SyncWriteStream>::value,
+        "SyncWriteStream type requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        http::write(stream, msg, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<class SyncWriteStream>
+std::size_t
+write(
+    SyncWriteStream& stream,
+    prepared_message const& msg,
+    error_code& ec)
+{
+    static_assert(
+        is_sync_write_stream<SyncWriteStream>::value,
+        "SyncWriteStream type requirements not met");
+    return net::write(stream, msg.buffers(), ec);
+}
+
+template<
+    class AsyncWriteStream,
+    class WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+async_write(
+    AsyncWriteStream& stream,
+    prepared_message const& msg,
+    WriteHandler&& handler)
+{
+    static_assert(
+        is_async_write_stream<AsyncWriteStream>::value,
+        "AsyncWriteStream type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            detail::run_write_prepared_op{},
+                handler, &stream, &msg);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
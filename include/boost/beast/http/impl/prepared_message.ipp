@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_PREPARED_MESSAGE_IPP
+#define BOOST_BEAST_HTTP_IMPL_PREPARED_MESSAGE_IPP
+
+#include <boost/beast/http/prepared_message.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+std::size_t
+prepared_message::
+size() const noexcept
+{
+    if(! impl_)
+        return 0;
+    auto n = impl_->data.size();
+    for(std::size_t i = 0; i < impl_->nslot; ++i)
+        if(set_ & (1U << i))
+            n = n - impl_->slots[i].size + values_[i].size();
+    return n;
+}
+
+void
+prepared_message::
+set(field name, string_view value)
+{
+    if(impl_)
+    {
+        for(std::size_t i = 0; i < impl_->nslot; ++i)
+        {
+            if(impl_->slots[i].name != name)
+                continue;
+            values_[i].assign(value.data(), value.size());
+            set_ |= 1U << i;
+            return;
+        }
+    }
+    BOOST_THROW_EXCEPTION(std::invalid_argument{
+        "field not prepared"});
+}
+
+void
+prepared_message::
+clear() noexcept
+{
+    set_ = 0;
+}
+
+auto
+prepared_message::
+buffers() const ->
+    const_buffers_type
+{
+    const_buffers_type cb;
+    if(! impl_)
+        return cb;
+    auto const p = impl_->data.data();
+    std::size_t pos = 0;
+    for(std::size_t i = 0; i < impl_->nslot; ++i)
+    {
+        if(! (set_ & (1U << i)))
+            continue;
+        auto const& s = impl_->slots[i];
+        cb.v_[cb.n_++] = {p + pos, s.pos - pos};
+        cb.v_[cb.n_++] = {
+            values_[i].data(), values_[i].size()};
+        pos = s.pos + s.size;
+    }
+    cb.v_[cb.n_++] = {p + pos, impl_->data.size() - pos};
+    return cb;
+}
+
+void
+prepared_message::
+init(std::string s,
+    std::initializer_list<field> fields)
+{
+    auto const sp = std::make_shared<impl>();
+    sp->data = std::move(s);
+    if(fields.size() > max_fields)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "too many fields"});
+
+    // The fields end at the first empty line
+    string_view const text = sp->data;
+    auto const end = text.find("\r\n\r\n");
+    for(auto f : fields)
+    {
+        // The body is shared, so its framing must not change
+        if( f == field::content_length ||
+            f == field::transfer_encoding)
+            BOOST_THROW_EXCEPTION(std::invalid_argument{
+                "framing field"});
+        auto const name = to_string(f);
+        bool found = false;
+        // Skip the start line
+        auto pos = text.find("\r\n");
+        while(pos < end)
+        {
+            pos += 2;
+            auto const eol = text.find("\r\n", pos);
+            auto const line = text.substr(pos, eol - pos);
+            auto const colon = line.find(':');
+            if( colon != string_view::npos &&
+                beast::iequals(line.substr(0, colon), name))
+            {
+                // The serializer writes "name: value"
+                auto const first = line.find_first_not_of(
+                    ' ', colon + 1);
+                auto& sl = sp->slots[sp->nslot];
+                sl.name = f;
+                sl.pos = pos + (first == string_view::npos ?
+                    line.size() : first);
+                sl.size = eol - sl.pos;
+                found = true;
+                break;
+            }
+            pos = eol;
+        }
+        if(! found)
+            BOOST_THROW_EXCEPTION(std::invalid_argument{
+                "field not present"});
+        for(std::size_t i = 0; i < sp->nslot; ++i)
+            if(sp->slots[i].name == f)
+                BOOST_THROW_EXCEPTION(std::invalid_argument{
+                    "duplicate field"});
+        ++sp->nslot;
+    }
+    std::sort(sp->slots.begin(), sp->slots.begin() + sp->nslot,
+        [](slot const& lhs, slot const& rhs)
+        {
+            return lhs.pos < rhs.pos;
+        });
+    impl_ = sp;
+    set_ = 0;
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -17,6 +17,7 @@
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/read.hpp>
+#include <boost/asio/coroutine.hpp>
 #include <boost/asio/error.hpp>
 
 namespace boost {
@@ -28,6 +29,9 @@ namespace detail {
 // The default maximum number of bytes to transfer in a single operation.
 std::size_t constexpr default_max_transfer_size = 65536;
 
+// The smallest remaining Content-Length read straight into the body.
+std::size_t constexpr direct_body_threshold = 8192;
+
 template<
     class DynamicBuffer,
     bool isRequest,
@@ -151,6 +155,206 @@ struct read_all_condition
     }
 };
 
+// predicate is true when parser message is complete, or when
+// the rest of a large body may be read without the buffer
+template<bool isRequest>
+struct read_direct_condition
+{
+    basic_parser<isRequest>& parser;
+
+    template<class DynamicBuffer>
+    std::size_t
+    operator()(error_code& ec, std::size_t,
+        DynamicBuffer& buffer)
+    {
+        return detail::parse_until(
+            buffer, parser, ec,
+            [this, &buffer]() -> bool
+            {
+                if(parser.is_done())
+                    return true;
+                if(! parser.is_header_done() ||
+                    buffer.size() > 0)
+                    return false;
+                auto const n =
+                    parser.content_length_remaining();
+                return n && *n >= direct_body_threshold;
+            });
+    }
+};
+
+// Account for body octets read directly, setting
+// the error to return. Returns `true` when done.
+template<bool isRequest>
+bool
+commit_body(
+    basic_parser<isRequest>& parser,
+    std::size_t bytes_transferred,
+    error_code& ec)
+{
+    error_code ev;
+    parser.commit_body(bytes_transferred, ev);
+    if(ev)
+    {
+        ec = ev;
+        return true;
+    }
+    if(parser.is_done())
+    {
+        // Caller sees the error on next read
+        ec = {};
+        return true;
+    }
+    if(ec)
+    {
+        // The header was received, so this
+        // is always a partial message.
+        ec = error::partial_message;
+        return true;
+    }
+    return false;
+}
+
+// Read the rest of a body with a known Content-Length into
+// the buffers provided by the parser, bypassing the dynamic
+// buffer. Falls back to the dynamic buffer when the parser
+// cannot provide buffers.
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest>
+std::size_t
+read_body(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest>& parser,
+    error_code& ec)
+{
+    std::size_t total = 0;
+    for(;;)
+    {
+        auto const b = parser.prepare_body(
+            default_max_transfer_size, ec);
+        if(ec)
+            break;
+        if(b.size() == 0)
+        {
+            total += beast::detail::read(stream, buffer,
+                read_all_condition<isRequest>{parser}, ec);
+            break;
+        }
+        auto const bytes_transferred =
+            stream.read_some(b, ec);
+        total += bytes_transferred;
+        if(detail::commit_body(
+                parser, bytes_transferred, ec))
+            break;
+    }
+    return total;
+}
+
+template<
+    class Stream, class DynamicBuffer,
+    bool isRequest, class Handler>
+class read_op
+    : public beast::async_base<
+        Handler, beast::executor_type<Stream>>
+    , public net::coroutine
+{
+    Stream& s_;
+    DynamicBuffer& b_;
+    basic_parser<isRequest>& p_;
+    std::size_t total_ = 0;
+
+public:
+    template<class Handler_>
+    read_op(
+        Handler_&& h,
+        Stream& s,
+        DynamicBuffer& b,
+        basic_parser<isRequest>& p)
+        : async_base<
+            Handler, beast::executor_type<Stream>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+        , p_(p)
+    {
+        (*this)({}, 0);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        net::mutable_buffer mb;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            BOOST_ASIO_CORO_YIELD
+            beast::detail::async_read(s_, b_,
+                read_direct_condition<isRequest>{p_},
+                std::move(*this));
+            total_ += bytes_transferred;
+            while(! ec && ! p_.is_done())
+            {
+                mb = p_.prepare_body(
+                    default_max_transfer_size, ec);
+                if(ec)
+                    break;
+                if(mb.size() == 0)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    beast::detail::async_read(s_, b_,
+                        read_all_condition<isRequest>{p_},
+                        std::move(*this));
+                    total_ += bytes_transferred;
+                    break;
+                }
+                BOOST_ASIO_CORO_YIELD
+                s_.async_read_some(mb, std::move(*this));
+                total_ += bytes_transferred;
+                if(detail::commit_body(
+                        p_, bytes_transferred, ec))
+                    break;
+            }
+            this->complete_now(ec, total_);
+        }
+    }
+};
+
+struct run_read_op
+{
+    template<
+        class ReadHandler,
+        class AsyncReadStream,
+        class DynamicBuffer,
+        bool isRequest>
+    void
+    operator()(
+        ReadHandler&& h,
+        AsyncReadStream* s,
+        DynamicBuffer* b,
+        basic_parser<isRequest>* p)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+            void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        read_op<
+            AsyncReadStream,
+            DynamicBuffer,
+            isRequest,
+            typename std::decay<ReadHandler>::type>(
+                std::forward<ReadHandler>(h), *s, *b, *p);
+    }
+};
+
 //------------------------------------------------------------------------------
 
 template<
@@ -430,9 +634,15 @@ read(
         net::is_dynamic_buffer<DynamicBuffer>::value,
         "DynamicBuffer type requirements not met");
     parser.eager(true);
-    return beast::detail::read(stream, buffer,
-        detail::read_all_condition<
-            isRequest>{parser}, ec);
+    auto bytes_transferred =
+        beast::detail::read(stream, buffer,
+            detail::read_direct_condition<
+                isRequest>{parser}, ec);
+    if(ec || parser.is_done())
+        return bytes_transferred;
+    bytes_transferred += detail::read_body(
+        stream, buffer, parser, ec);
+    return bytes_transferred;
 }
 
 template<
@@ -454,12 +664,11 @@ async_read(
         net::is_dynamic_buffer<DynamicBuffer>::value,
         "DynamicBuffer type requirements not met");
     parser.eager(true);
-    return beast::detail::async_read(
-        stream,
-        buffer,
-        detail::read_all_condition<
-            isRequest>{parser},
-        std::forward<ReadHandler>(handler));
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            detail::run_read_op{},
+                handler, &stream, &buffer, &parser);
 }
 
 //------------------------------------------------------------------------------
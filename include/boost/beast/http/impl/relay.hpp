@@ -0,0 +1,538 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_RELAY_HPP
+#define BOOST_BEAST_HTTP_IMPL_RELAY_HPP
+
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/clamp.hpp>
+#include <boost/asio/basic_stream_socket.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/error.hpp>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if BOOST_BEAST_USE_SPLICE
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace boost {
+namespace beast {
+namespace http {
+namespace detail {
+
+// The size of the buffer used to relay a body piece by piece.
+std::size_t constexpr relay_buffer_size = 8192;
+
+// Determine if a stream is a socket which splice(2) may use
+template<class Stream>
+struct is_spliceable : std::false_type {};
+
+#if BOOST_BEAST_USE_SPLICE
+
+template<class Protocol, class Executor>
+struct is_spliceable<
+    net::basic_stream_socket<Protocol, Executor>>
+    : std::true_type
+{
+};
+
+// The largest number of bytes moved by one call to splice.
+std::size_t constexpr splice_size = 65536;
+
+// A pipe through which splice moves octets between sockets
+class splice_pipe
+{
+    int fd_[2] = { -1, -1 };
+
+public:
+    splice_pipe() = default;
+    splice_pipe(splice_pipe const&) = delete;
+    splice_pipe& operator=(splice_pipe const&) = delete;
+
+    ~splice_pipe()
+    {
+        if(fd_[0] != -1)
+            ::close(fd_[0]);
+        if(fd_[1] != -1)
+            ::close(fd_[1]);
+    }
+
+    bool
+    is_open() const
+    {
+        return fd_[0] != -1;
+    }
+
+    void
+    open(error_code& ec)
+    {
+        if(::pipe2(fd_, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            ec.assign(errno, net::error::get_system_category());
+            return;
+        }
+        ec = {};
+    }
+
+    int
+    read_end() const
+    {
+        return fd_[0];
+    }
+
+    int
+    write_end() const
+    {
+        return fd_[1];
+    }
+};
+
+// Move up to `size` octets between two file descriptors
+// without blocking, where at least one is a pipe.
+inline
+std::size_t
+splice_some(int from, int to,
+    std::size_t size, error_code& ec)
+{
+    auto const n = ::splice(from, nullptr, to, nullptr,
+        size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if(n < 0)
+    {
+        ec.assign(errno, net::error::get_system_category());
+        return 0;
+    }
+    ec = {};
+    return static_cast<std::size_t>(n);
+}
+
+inline
+bool
+splice_would_block(error_code const& ec)
+{
+    return
+        ec == net::error::would_block ||
+        ec == net::error::try_again ||
+        ec == net::error::interrupted;
+}
+
+// Move `remain` body octets from one socket to
+// another through the pipe, waiting for readiness
+// whenever the sockets would block.
+template<
+    class Handler,
+    class WriteSocket,
+    class ReadSocket>
+class splice_op
+    : public beast::async_base<
+        Handler, beast::executor_type<WriteSocket>>
+    , public net::coroutine
+{
+    WriteSocket& out_;
+    ReadSocket& in_;
+    splice_pipe& pipe_;
+    std::uint64_t remain_;
+    std::size_t piped_ = 0;
+    std::size_t total_ = 0;
+
+public:
+    template<class Handler_>
+    splice_op(
+        Handler_&& h,
+        WriteSocket& out,
+        ReadSocket& in,
+        splice_pipe& pipe,
+        std::uint64_t remain)
+        : async_base<
+            Handler, beast::executor_type<WriteSocket>>(
+                std::forward<Handler_>(h), out.get_executor())
+        , out_(out)
+        , in_(in)
+        , pipe_(pipe)
+        , remain_(remain)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t = 0,
+        bool cont = true)
+    {
+        std::size_t n;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            while(remain_ > 0)
+            {
+                n = splice_some(in_.native_handle(),
+                    pipe_.write_end(), beast::detail::clamp(
+                        remain_, splice_size), ec);
+                if(splice_would_block(ec))
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    in_.async_wait(net::socket_base::wait_read,
+                        std::move(*this));
+                    if(ec)
+                        goto upcall;
+                    continue;
+                }
+                if(ec)
+                    goto upcall;
+                if(n == 0)
+                {
+                    ec = error::partial_message;
+                    goto upcall;
+                }
+                remain_ -= n;
+                piped_ = n;
+                while(piped_ > 0)
+                {
+                    n = splice_some(pipe_.read_end(),
+                        out_.native_handle(), piped_, ec);
+                    if(splice_would_block(ec))
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        out_.async_wait(net::socket_base::wait_write,
+                            std::move(*this));
+                        if(ec)
+                            goto upcall;
+                        continue;
+                    }
+                    if(ec)
+                        goto upcall;
+                    piped_ -= n;
+                    total_ += n;
+                }
+            }
+        upcall:
+            this->complete(cont, ec, total_);
+        }
+    }
+};
+
+#endif
+
+template<
+    class Handler,
+    class WriteStream,
+    class ReadStream,
+    class DynamicBuffer,
+    bool isRequest,
+    class Transform>
+class relay_op
+    : public beast::stable_async_base<
+        Handler, beast::executor_type<WriteStream>>
+    , public net::coroutine
+{
+    using can_splice_type = std::integral_constant<bool,
+        is_spliceable<WriteStream>::value &&
+        is_spliceable<ReadStream>::value>;
+
+    struct data
+    {
+        parser<isRequest, buffer_body> p;
+        serializer<isRequest, buffer_body, fields> sr;
+        char buf[relay_buffer_size];
+#if BOOST_BEAST_USE_SPLICE
+        splice_pipe pipe;
+#endif
+
+        data()
+            : sr(p.get())
+        {
+            // The body is never stored
+            p.body_limit((std::numeric_limits<
+                std::uint64_t>::max)());
+        }
+    };
+
+    WriteStream& out_;
+    ReadStream& in_;
+    DynamicBuffer& b_;
+    Transform tr_;
+    data& d_;
+    std::size_t total_ = 0;
+    bool splice_ = false;
+    bool in_nb_ = false;    // the caller's modes
+    bool out_nb_ = false;
+
+public:
+    template<class Handler_, class Transform_>
+    relay_op(
+        Handler_&& h,
+        WriteStream& out,
+        ReadStream& in,
+        DynamicBuffer& b,
+        Transform_&& tr)
+        : stable_async_base<
+            Handler, beast::executor_type<WriteStream>>(
+                std::forward<Handler_>(h), out.get_executor())
+        , out_(out)
+        , in_(in)
+        , b_(b)
+        , tr_(std::forward<Transform_>(tr))
+        , d_(beast::allocate_stable<data>(*this))
+    {
+        save(can_splice_type{});
+        (*this)();
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0)
+    {
+        auto& body = d_.p.get().body();
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            BOOST_ASIO_CORO_YIELD
+            http::async_read_header(
+                in_, b_, d_.p, std::move(*this));
+            if(ec)
+                goto upcall;
+
+            // Apply the caller's header transformation
+            tr_(d_.p.get(), ec);
+            if(ec)
+                goto upcall;
+
+            BOOST_ASIO_CORO_YIELD
+            http::async_write_header(
+                out_, d_.sr, std::move(*this));
+            total_ += bytes_transferred;
+            if(ec)
+                goto upcall;
+
+            splice_ = can_splice(can_splice_type{});
+            do
+            {
+                if(! d_.p.is_done())
+                {
+                    // Octets which are not in the buffer
+                    // yet are moved without it.
+                    if(splice_ && b_.size() == 0)
+                        break;
+                    body.data = d_.buf;
+                    body.size = sizeof(d_.buf);
+                    if(splice_)
+                    {
+                        b_.consume(d_.p.put(b_.data(), ec));
+                    }
+                    else
+                    {
+                        BOOST_ASIO_CORO_YIELD
+                        http::async_read(
+                            in_, b_, d_.p, std::move(*this));
+                    }
+                    // This error is returned when
+                    // buffer_body uses up the buffer
+                    if(ec == error::need_buffer)
+                        ec = {};
+                    if(ec)
+                        goto upcall;
+                    body.size = sizeof(d_.buf) - body.size;
+                    body.data = d_.buf;
+                    body.more = ! d_.p.is_done();
+                }
+                else
+                {
+                    body.data = nullptr;
+                    body.size = 0;
+                }
+
+                // Write everything in the buffer
+                // (which might be empty)
+                BOOST_ASIO_CORO_YIELD
+                http::async_write(
+                    out_, d_.sr, std::move(*this));
+                total_ += bytes_transferred;
+                if(ec == error::need_buffer)
+                    ec = {};
+                if(ec)
+                    goto upcall;
+            }
+            while(! d_.p.is_done() && ! d_.sr.is_done());
+
+            if(! d_.p.is_done())
+            {
+                BOOST_ASIO_CORO_YIELD
+                do_splice(can_splice_type{});
+                total_ += bytes_transferred;
+            }
+
+        upcall:
+            restore(can_splice_type{});
+            this->complete_now(ec, total_);
+        }
+    }
+
+private:
+    bool
+    can_splice(std::false_type)
+    {
+        return false;
+    }
+
+    void
+    do_splice(std::false_type)
+    {
+        BOOST_ASSERT(false);
+    }
+
+    void
+    save(std::false_type)
+    {
+    }
+
+    void
+    restore(std::false_type)
+    {
+    }
+
+#if BOOST_BEAST_USE_SPLICE
+    bool
+    can_splice(std::true_type)
+    {
+        // The body must be delimited by Content-Length
+        // on both sides, with more left than is buffered.
+        if(d_.p.is_done() ||
+            ! d_.p.content_length() ||
+            d_.p.get().chunked() ||
+            *d_.p.content_length_remaining() <= b_.size())
+            return false;
+        error_code ec;
+        d_.pipe.open(ec);
+        if(ec)
+            return false;
+        in_.native_non_blocking(true, ec);
+        if(! ec)
+            out_.native_non_blocking(true, ec);
+        if(ec)
+        {
+            restore(std::true_type{});
+            return false;
+        }
+        return true;
+    }
+
+    void
+    save(std::true_type)
+    {
+        in_nb_ = in_.native_non_blocking();
+        out_nb_ = out_.native_non_blocking();
+    }
+
+    // Put back the caller's modes, so later
+    // synchronous operations still block.
+    void
+    restore(std::true_type)
+    {
+        error_code ec;
+        in_.native_non_blocking(in_nb_, ec);
+        out_.native_non_blocking(out_nb_, ec);
+    }
+
+    void
+    do_splice(std::true_type)
+    {
+        splice_op<relay_op, WriteStream, ReadStream>(
+            std::move(*this), out_, in_, d_.pipe,
+                *d_.p.content_length_remaining());
+    }
+#endif
+};
+
+template<bool isRequest>
+struct run_relay_op
+{
+    template<
+        class RelayHandler,
+        class AsyncWriteStream,
+        class AsyncReadStream,
+        class DynamicBuffer,
+        class Transform>
+    void
+    operator()(
+        RelayHandler&& h,
+        AsyncWriteStream* output,
+        AsyncReadStream* input,
+        DynamicBuffer* buffer,
+        Transform&& transform)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<RelayHandler,
+            void(error_code, std::size_t)>::value,
+            "RelayHandler type requirements not met");
+
+        relay_op<
+            typename std::decay<RelayHandler>::type,
+            AsyncWriteStream,
+            AsyncReadStream,
+            DynamicBuffer,
+            isRequest,
+            typename std::decay<Transform>::type>(
+                std::forward<RelayHandler>(h),
+                *output, *input, *buffer,
+                std::forward<Transform>(transform));
+    }
+};
+
+} // detail
+
+template<
+    bool isRequest,
+    class AsyncWriteStream,
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class Transform,
+    class RelayHandler>
+BOOST_BEAST_ASYNC_RESULT2(RelayHandler)
+async_relay(
+    AsyncWriteStream& output,
+    AsyncReadStream& input,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    RelayHandler&& handler)
+{
+    static_assert(
+        is_async_write_stream<AsyncWriteStream>::value,
+        "AsyncWriteStream type requirements not met");
+    static_assert(
+        is_async_read_stream<AsyncReadStream>::value,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    return net::async_initiate<
+        RelayHandler,
+        void(error_code, std::size_t)>(
+            detail::run_relay_op<isRequest>{},
+                handler, &output, &input, &buffer,
+                std::forward<Transform>(transform));
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,432 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_SERIALIZE_HPP
+#define BOOST_BEAST_HTTP_IMPL_SERIALIZE_HPP
+
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/optional.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+// True if the fields writer can measure and copy the
+// header directly, without iterating its buffer sequence.
+template<class T, class = void>
+struct is_flat_fields_writer : std::false_type {};
+
+template<class T>
+struct is_flat_fields_writer<T, beast::detail::void_t<decltype(
+    std::declval<std::size_t&>() =
+        std::declval<T const&>().size(),
+    std::declval<char*&>() =
+        std::declval<T const&>().copy(std::declval<char*>())
+    )>> : std::true_type {};
+
+template<class Writer>
+std::size_t
+header_size(Writer const& w, std::true_type)
+{
+    return w.size();
+}
+
+template<class Writer>
+std::size_t
+header_size(Writer const& w, std::false_type)
+{
+    return buffer_bytes(w.get());
+}
+
+template<class Writer, class Message>
+void
+fields_writer_init(
+    boost::optional<Writer>& w,
+    Message const& m,
+    std::true_type)
+{
+    w.emplace(m, m.version(), m.method());
+}
+
+template<class Writer, class Message>
+void
+fields_writer_init(
+    boost::optional<Writer>& w,
+    Message const& m,
+    std::false_type)
+{
+    w.emplace(m, m.version(), m.result_int());
+}
+
+// Returns the number of hex digits in the chunk size n
+inline
+std::size_t
+chunk_size_digits(std::uint64_t n)
+{
+    std::size_t d = 1;
+    while(n >>= 4)
+        ++d;
+    return d;
+}
+
+// Writes the chunk header for n octets, returning the end
+inline
+char*
+write_chunk_size(char* dest, std::uint64_t n)
+{
+    auto const end = dest + chunk_size_digits(n);
+    auto it = end;
+    do
+    {
+        *--it = "0123456789abcdef"[n & 0xf];
+        n >>= 4;
+    }
+    while(n);
+    end[0] = '\r';
+    end[1] = '\n';
+    return end + 2;
+}
+
+// Copies serialized octets to a single buffer
+class flat_output
+{
+    char* p_;
+    char* end_;
+
+public:
+    explicit
+    flat_output(net::mutable_buffer b)
+        : p_(static_cast<char*>(b.data()))
+        , end_(p_ + b.size())
+    {
+    }
+
+    template<class Writer>
+    void
+    header(Writer const& w, std::true_type)
+    {
+        p_ = w.copy(p_);
+    }
+
+    template<class Writer>
+    void
+    header(Writer const& w, std::false_type)
+    {
+        put(w.get());
+    }
+
+    template<class ConstBufferSequence>
+    void
+    put(ConstBufferSequence const& buffers)
+    {
+        p_ += net::buffer_copy(net::mutable_buffer(
+            p_, static_cast<std::size_t>(end_ - p_)), buffers);
+    }
+
+    void
+    chunk_size(std::uint64_t n)
+    {
+        p_ = write_chunk_size(p_, n);
+    }
+};
+
+// Copies serialized octets to a buffer sequence
+template<class MutableBufferSequence>
+class sequence_output
+{
+    buffers_suffix<MutableBufferSequence> b_;
+
+public:
+    explicit
+    sequence_output(MutableBufferSequence const& b)
+        : b_(b)
+    {
+    }
+
+    template<class Writer, class Tag>
+    void
+    header(Writer const& w, Tag)
+    {
+        put(w.get());
+    }
+
+    template<class ConstBufferSequence>
+    void
+    put(ConstBufferSequence const& buffers)
+    {
+        b_.consume(net::buffer_copy(b_, buffers));
+    }
+
+    void
+    chunk_size(std::uint64_t n)
+    {
+        char buf[2 * sizeof(n) + 2];
+        put(net::const_buffer(buf, static_cast<
+            std::size_t>(write_chunk_size(buf, n) - buf)));
+    }
+};
+
+// Serialize a message whose body has a known size,
+// into output with room for exactly the message.
+template<
+    class Output,
+    class FieldsWriter,
+    class BodyWriter>
+void
+serialize_sized(
+    Output& out,
+    FieldsWriter const& fwr,
+    BodyWriter& wr,
+    bool chunked,
+    std::uint64_t size,
+    error_code& ec)
+{
+    out.header(fwr, is_flat_fields_writer<FieldsWriter>{});
+    if(chunked && size > 0)
+        out.chunk_size(size);
+    // The body writer must produce exactly the number of
+    // octets the body reported, which is what was prepared.
+    std::uint64_t n = 0;
+    for(;;)
+    {
+        auto result = wr.get(ec);
+        if(ec)
+            return;
+        if(! result)
+            break;
+        auto const k = buffer_bytes(result->first);
+        if(k > size - n)
+        {
+            ec = error::bad_content_length;
+            return;
+        }
+        n += k;
+        out.put(result->first);
+        if(! result->second)
+            break;
+    }
+    if(n != size)
+    {
+        ec = error::bad_content_length;
+        return;
+    }
+    if(chunked)
+    {
+        if(size > 0)
+            out.put(net::const_buffer("\r\n", 2));
+        out.put(net::const_buffer("0\r\n\r\n", 5));
+    }
+}
+
+// Returns the output for the next n octets of the buffer
+template<class DynamicBuffer>
+sequence_output<typename DynamicBuffer::mutable_buffers_type>
+prepare_output(DynamicBuffer& buffer, std::size_t n)
+{
+    return sequence_output<typename
+        DynamicBuffer::mutable_buffers_type>(buffer.prepare(n));
+}
+
+template<
+    bool isRequest, class Body, class Fields,
+    class Message, class DynamicBuffer>
+std::size_t
+serialize_impl(
+    Message& msg,
+    DynamicBuffer& buffer,
+    error_code& ec)
+{
+    using fields_writer = typename Fields::writer;
+    using is_flat = is_flat_fields_writer<fields_writer>;
+
+    boost::optional<fields_writer> fwr;
+    fields_writer_init(fwr, msg,
+        std::integral_constant<bool, isRequest>{});
+    typename Body::writer wr(msg.base(), msg.body());
+    wr.init(ec);
+    if(ec)
+        return 0;
+
+    bool const chunked = msg.chunked();
+    auto const hn = header_size(*fwr, is_flat{});
+    auto const size = msg.payload_size();
+    if(size)
+    {
+        // The exact size of the message is known
+        auto const limit =
+            (std::numeric_limits<std::size_t>::max)() - hn -
+            (chunk_size_digits(*size) + 9);
+        if(*size > limit)
+            BOOST_THROW_EXCEPTION(std::length_error{
+                "message too large"});
+        auto n = hn + static_cast<std::size_t>(*size);
+        if(chunked)
+        {
+            if(*size > 0)
+                n += chunk_size_digits(*size) + 4;
+            n += 5;
+        }
+        auto const mb = buffer.prepare(n);
+        auto const first = net::buffer_sequence_begin(mb);
+        if( first != net::buffer_sequence_end(mb) &&
+            net::mutable_buffer(*first).size() == n)
+        {
+            flat_output out(*first);
+            serialize_sized(out, *fwr, wr, chunked, *size, ec);
+        }
+        else
+        {
+            sequence_output<typename
+                DynamicBuffer::mutable_buffers_type> out(mb);
+            serialize_sized(out, *fwr, wr, chunked, *size, ec);
+        }
+        if(ec)
+            return 0;
+        buffer.commit(n);
+        return n;
+    }
+
+    // The header is appended first, then each
+    // buffer produced by the body as it comes.
+    prepare_output(buffer, hn).header(*fwr, is_flat{});
+    buffer.commit(hn);
+    std::size_t total = hn;
+    for(;;)
+    {
+        auto result = wr.get(ec);
+        if(ec)
+            return total;
+        if(! result)
+            break;
+        auto const len = buffer_bytes(result->first);
+        if(! chunked)
+        {
+            prepare_output(buffer, len).put(result->first);
+            buffer.commit(len);
+            total += len;
+        }
+        else if(len > 0)
+        {
+            auto const n = chunk_size_digits(len) + 4 + len;
+            auto out = prepare_output(buffer, n);
+            out.chunk_size(len);
+            out.put(result->first);
+            out.put(net::const_buffer("\r\n", 2));
+            buffer.commit(n);
+            total += n;
+        }
+        if(! result->second)
+            break;
+    }
+    if(chunked)
+    {
+        prepare_output(buffer, 5).put(net::const_buffer("0\r\n\r\n", 5));
+        buffer.commit(5);
+        total += 5;
+    }
+    return total;
+}
+
+} // detail
+
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+typename std::enable_if<
+    is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+serialize(
+    message<isRequest, Body, Fields>& msg,
+    DynamicBuffer& buffer)
+{
+    error_code ec;
+    auto const n = http::serialize(msg, buffer, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+typename std::enable_if<
+    ! is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+serialize(
+    message<isRequest, Body, Fields> const& msg,
+    DynamicBuffer& buffer)
+{
+    error_code ec;
+    auto const n = http::serialize(msg, buffer, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+typename std::enable_if<
+    is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+serialize(
+    message<isRequest, Body, Fields>& msg,
+    DynamicBuffer& buffer,
+    error_code& ec)
+{
+    static_assert(is_body<Body>::value,
+        "Body type requirements not met");
+    static_assert(is_body_writer<Body>::value,
+        "BodyWriter type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    ec = {};
+    return detail::serialize_impl<
+        isRequest, Body, Fields>(msg, buffer, ec);
+}
+
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+typename std::enable_if<
+    ! is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+serialize(
+    message<isRequest, Body, Fields> const& msg,
+    DynamicBuffer& buffer,
+    error_code& ec)
+{
+    static_assert(is_body<Body>::value,
+        "Body type requirements not met");
+    static_assert(is_body_writer<Body>::value,
+        "BodyWriter type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    ec = {};
+    return detail::serialize_impl<
+        isRequest, Body, Fields>(msg, buffer, ec);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
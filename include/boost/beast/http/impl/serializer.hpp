@@ -16,6 +16,7 @@
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/assert.hpp>
+#include <algorithm>
 #include <ostream>
 
 namespace boost {
@@ -48,11 +49,45 @@ void
 serializer<isRequest, Body, Fields>::
 do_visit(error_code& ec, Visit& visit)
 {
+    // Hand out a flat copy of the buffers when they fit,
+    // this is much cheaper for the stream to iterate.
+    if(bv_.assign(v_.template get<I>(), limit_))
+    {
+        visit(ec, beast::detail::make_buffers_ref(bv_));
+        return;
+    }
     pv_.template emplace<I>(limit_, v_.template get<I>());
     visit(ec, beast::detail::make_buffers_ref(
         pv_.template get<I>()));
 }
 
+template<
+    bool isRequest, class Body, class Fields>
+template<std::size_t I>
+bool
+serializer<isRequest, Body, Fields>::
+do_flatten()
+{
+    // Copy a small message into one buffer, so the
+    // stream sees a single buffer instead of many.
+    if(flat_limit_ == 0)
+        return false;
+    auto const& cb = v_.template get<I>();
+    auto const n = buffer_bytes(cb);
+    if(n > flat_limit_)
+        return false;
+    flat_.resize(n);
+    if(bv_.assign(cb, n))
+        net::buffer_copy(net::buffer(&flat_[0], n), bv_);
+    else
+        net::buffer_copy(net::buffer(&flat_[0], n), cb);
+    flat_pos_ = 0;
+    v_.reset();
+    fwr_ = boost::none;
+    s_ = do_flat;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 
 template<
@@ -102,6 +137,8 @@ next(error_code& ec, Visit&& visit)
             boost::in_place_init,
             fwr_->get(),
             result->first);
+        if(! more_ && do_flatten<2>())
+            goto go_flat;
         s_ = do_header;
         BOOST_FALLTHROUGH;
     }
@@ -173,6 +210,8 @@ next(error_code& ec, Visit&& visit)
                 detail::chunk_last(),
                 net::const_buffer{nullptr, 0},
                 chunk_crlf{});
+            if(do_flatten<7>())
+                goto go_flat;
             goto go_all_c;
         }
         v_.template emplace<4>(
@@ -272,6 +311,18 @@ next(error_code& ec, Visit&& visit)
 
     //----------------------------------------------------------------------
 
+    go_flat:
+    case do_flat:
+    {
+        auto const n = (std::min)(
+            flat_.size() - flat_pos_, limit_);
+        visit(ec, net::const_buffer(
+            flat_.data() + flat_pos_, n));
+        break;
+    }
+
+    //----------------------------------------------------------------------
+
     default:
     case do_complete:
         BOOST_ASSERT(false);
@@ -413,6 +464,16 @@ consume(std::size_t n)
 
     //----------------------------------------------------------------------
 
+    case do_flat:
+        BOOST_ASSERT(n <= flat_.size() - flat_pos_);
+        flat_pos_ += n;
+        if(flat_pos_ < flat_.size())
+            break;
+        header_done_ = true;
+        goto go_complete;
+
+    //----------------------------------------------------------------------
+
     default:
         BOOST_ASSERT(false);
     case do_complete:
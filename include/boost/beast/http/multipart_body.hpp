@@ -0,0 +1,325 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_MULTIPART_BODY_HPP
+#define BOOST_BEAST_HTTP_MULTIPART_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/detail/multipart.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A message body which streams the parts of a multipart body.
+
+    This body is used to receive a message whose body has a
+    multipart media type, such as `multipart/form-data`. Parts
+    are not stored in the message. Instead, as the body is
+    parsed, the header of each part is made available to a
+    callback, which then decides where the content of that
+    part goes: to a file, to a callback, or nowhere. The memory
+    used is bounded by the limit on the size of a part's header,
+    however large the body is.
+
+    Boundaries are found incrementally using the Boyer-Moore-Horspool
+    algorithm, so content is searched once as it arrives, even
+    when a delimiter straddles two reads.
+
+    This body type may only be used to read messages.
+
+    @par Example
+    @code
+    request_parser<multipart_body> p;
+    p.get().body().on_part(
+        [](multipart_body::part& part, error_code& ec)
+        {
+            if(! part.filename().empty())
+                part.open(make_path(part.filename()), ec);
+            else
+                part.on_data(
+                    [&](string_view s, error_code&)
+                    {
+                        ...
+                    });
+        });
+    read(stream, buffer, p);
+    @endcode
+
+    @tparam File The implementation to use for accessing files.
+    This type must meet the requirements of <em>File</em>.
+*/
+template<class File>
+struct basic_multipart_body
+{
+    // Make sure the type meets the requirements
+    static_assert(is_file<File>::value,
+        "File type requirements not met");
+
+    /// The type of File this body uses
+    using file_type = File;
+
+    /** One part of a multipart body.
+
+        An object of this type is passed to the callbacks set
+        on the body. It holds the header of the current part,
+        and the sink for its content. If no sink is chosen,
+        the content is discarded.
+    */
+    class part;
+
+    /** The type of the @ref message::body member.
+
+        This holds the callbacks used while the body is parsed.
+    */
+    class value_type;
+
+    /// The algorithm for parsing the body
+    class reader;
+};
+
+template<class File>
+class basic_multipart_body<File>::part
+{
+    friend class reader;
+
+    fields header_;
+    File file_;
+    std::function<void(string_view, error_code&)> cb_;
+    std::uint64_t size_ = 0;
+
+    void
+    write(char const* p, std::size_t n, error_code& ec);
+
+    void
+    close(error_code& ec);
+
+public:
+    /// Returns the header of this part
+    fields const&
+    header() const
+    {
+        return header_;
+    }
+
+    /** Returns the name of this part.
+
+        This is the unquoted `name` parameter of the
+        Content-Disposition field, or an empty string if
+        there is none.
+    */
+    std::string
+    name() const
+    {
+        return disposition_param("name");
+    }
+
+    /** Returns the file name of this part.
+
+        This is the unquoted `filename` parameter of the
+        Content-Disposition field, or an empty string if there
+        is none. The value is supplied by the peer and must not
+        be used as a path without validation.
+    */
+    std::string
+    filename() const
+    {
+        return disposition_param("filename");
+    }
+
+    /// Returns the number of content octets received so far
+    std::uint64_t
+    size() const
+    {
+        return size_;
+    }
+
+    /** Write the content of this part to a file.
+
+        The file is created, or truncated if it exists, and
+        closed when the part ends.
+
+        @param path The utf-8 encoded path to the file
+
+        @param ec Set to the error, if any occurred
+    */
+    void
+    open(char const* path, error_code& ec);
+
+    /** Deliver the content of this part to a callback.
+
+        @param cb The function to call with each piece of the
+        content as it arrives. The equivalent function signature
+        must be:
+        @code
+        void cb(
+            string_view data,   // content octets
+            error_code& ec      // set to indicate an error
+        );
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_data(Callback&& cb)
+    {
+        cb_ = std::forward<Callback>(cb);
+    }
+
+private:
+    std::string
+    disposition_param(string_view name) const;
+};
+
+template<class File>
+class basic_multipart_body<File>::value_type
+{
+    friend class reader;
+
+    std::function<void(part&, error_code&)> on_part_;
+    std::function<void(part&, error_code&)> on_part_end_;
+    std::size_t header_limit_ = 8192;
+
+public:
+    /** Set the callback invoked when the header of a part is received.
+
+        The callback chooses the sink for the content of the part,
+        by calling @ref part::open or @ref part::on_data. The
+        equivalent function signature must be:
+        @code
+        void cb(
+            part& p,            // the part
+            error_code& ec      // set to indicate an error
+        );
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_part(Callback&& cb)
+    {
+        on_part_ = std::forward<Callback>(cb);
+    }
+
+    /** Set the callback invoked when all of a part is received.
+
+        If the content was written to a file, the file is closed
+        before the callback is invoked. The equivalent function
+        signature must be:
+        @code
+        void cb(
+            part& p,            // the part
+            error_code& ec      // set to indicate an error
+        );
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_part_end(Callback&& cb)
+    {
+        on_part_end_ = std::forward<Callback>(cb);
+    }
+
+    /** Set the limit on the size of the header of each part.
+
+        A part whose header is larger results in
+        @ref error::header_limit. The default is 8KB.
+    */
+    void
+    header_limit(std::size_t n)
+    {
+        header_limit_ = n;
+    }
+};
+
+/** The algorithm for parsing the body.
+
+    Meets the requirements of <em>BodyReader</em>.
+*/
+template<class File>
+class basic_multipart_body<File>::reader
+{
+    enum state
+    {
+        s_content,
+        s_boundary,
+        s_close,
+        s_padding,
+        s_lf,
+        s_header,
+        s_done
+    };
+
+    value_type& body_;
+    void const* h_;
+    string_view (*content_type_)(void const*);
+    detail::multipart_search search_;
+    part part_;
+    std::string hold_;      // octets which may begin a delimiter
+    std::string hdr_;       // the header of the part, or nothing
+    state s_ = s_content;
+    bool in_part_ = false;
+
+    std::size_t
+    put_content(char const* p, std::size_t n, error_code& ec);
+
+    std::size_t
+    put_header(char const* p, std::size_t n, error_code& ec);
+
+    std::size_t
+    put_some(char const* p, std::size_t n, error_code& ec);
+
+    void
+    parse_header(string_view s, error_code& ec);
+
+    void
+    end_part(error_code& ec);
+
+    template<class Header>
+    static
+    string_view
+    get_content_type(void const* h)
+    {
+        return (*static_cast<Header const*>(h))[
+            field::content_type];
+    }
+
+public:
+    template<bool isRequest, class Fields>
+    explicit
+    reader(header<isRequest, Fields>& h, value_type& b);
+
+    void
+    init(boost::optional<std::uint64_t> const&, error_code& ec);
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers, error_code& ec);
+
+    void
+    finish(error_code& ec);
+};
+
+/// A message body which streams the parts of a multipart body.
+using multipart_body = basic_multipart_body<file>;
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/multipart_body.hpp>
+
+#endif
@@ -486,6 +486,59 @@ private:
     {
         rd_.finish(ec);
     }
+
+    net::mutable_buffer
+    on_body_prepare_impl(
+        std::size_t size,
+        error_code& ec) override
+    {
+        return this->on_body_prepare_impl(size, ec,
+            detail::has_direct_reader<Body>{});
+    }
+
+    net::mutable_buffer
+    on_body_prepare_impl(
+        std::size_t size,
+        error_code& ec,
+        std::true_type)
+    {
+        return rd_.prepare(size, ec);
+    }
+
+    net::mutable_buffer
+    on_body_prepare_impl(
+        std::size_t,
+        error_code&,
+        std::false_type)
+    {
+        return {};
+    }
+
+    void
+    on_body_commit_impl(
+        std::size_t size,
+        error_code& ec) override
+    {
+        this->on_body_commit_impl(size, ec,
+            detail::has_direct_reader<Body>{});
+    }
+
+    void
+    on_body_commit_impl(
+        std::size_t size,
+        error_code& ec,
+        std::true_type)
+    {
+        rd_.commit(size, ec);
+    }
+
+    void
+    on_body_commit_impl(
+        std::size_t,
+        error_code&,
+        std::false_type)
+    {
+    }
 };
 
 /// An HTTP/1 parser for producing a request message.
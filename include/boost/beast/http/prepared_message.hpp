@@ -0,0 +1,292 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_HTTP_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A message serialized once, for writing many times.
+
+    Objects of this type hold the complete serialized form of an
+    HTTP message in an immutable, reference counted buffer. Copies
+    share the buffer, so one prepared message may be written to any
+    number of streams, concurrently, without serializing the message
+    again. This suits responses which rarely change, such as health
+    checks, redirects, errors and small cached documents.
+
+    A few fields, chosen when the message is prepared, may be given
+    a different value in each copy using @ref set. The new value is
+    written in place of the one serialized, while the rest of the
+    message is still shared. This is how a per-response Date is
+    sent, for example.
+
+    @par Example
+    @code
+    response<string_body> res{status::not_found, 11};
+    res.set(field::date, "Thu, 01 Jan 1970 00:00:00 GMT");
+    res.body() = "Not found";
+    res.prepare_payload();
+    prepared_message const not_found{res, {field::date}};
+    ...
+    prepared_message m{not_found};
+    m.set(field::date, now());
+    http::async_write(stream, m, handler);
+    @endcode
+*/
+class prepared_message
+{
+public:
+    /// The largest number of fields which may be set on a copy.
+    static std::size_t constexpr max_fields = 4;
+
+#if BOOST_BEAST_DOXYGEN
+    /// The buffer sequence representing the message.
+    using const_buffers_type = __implementation_defined__;
+#else
+    class const_buffers_type
+    {
+        friend class prepared_message;
+
+        std::array<net::const_buffer,
+            2 * max_fields + 1> v_;
+        std::size_t n_ = 0;
+
+    public:
+        using value_type = net::const_buffer;
+        using const_iterator = net::const_buffer const*;
+
+        const_iterator
+        begin() const noexcept
+        {
+            return v_.data();
+        }
+
+        const_iterator
+        end() const noexcept
+        {
+            return v_.data() + n_;
+        }
+    };
+#endif
+
+    /// Constructor, for an empty message.
+    prepared_message() = default;
+
+    /// Copy constructor. The serialized message is shared.
+    prepared_message(prepared_message const&) = default;
+
+    /// Copy assignment. The serialized message is shared.
+    prepared_message& operator=(prepared_message const&) = default;
+
+    /** Constructor
+
+        The message is serialized as if by @ref write, and kept.
+        The message is not needed after this call returns.
+
+        @param msg The message to prepare. The caller is responsible
+        for setting the payload fields, for example by calling
+        @ref message::prepare_payload.
+
+        @param fields The fields which may be given new values with
+        @ref set. Each field must be present in `msg`. At most
+        @ref max_fields may be listed. Content-Length and
+        Transfer-Encoding may not be listed, since every copy
+        shares the body which they describe.
+
+        @throws system_error Thrown if the serializer fails.
+
+        @throws std::invalid_argument Thrown if a field is not present,
+        if it is Content-Length or Transfer-Encoding, or if too many
+        fields are listed.
+    */
+    template<bool isRequest, class Body, class Fields>
+    explicit
+    prepared_message(
+        message<isRequest, Body, Fields> const& msg,
+        std::initializer_list<field> fields = {});
+
+    /// Returns the number of octets in the message.
+    BOOST_BEAST_DECL
+    std::size_t
+    size() const noexcept;
+
+    /** Set the value of a field in this copy only.
+
+        The value replaces the one the field had when the message
+        was prepared. Other copies are not affected.
+
+        @param name The field to set. It must be one of the fields
+        listed when the message was prepared.
+
+        @param value The new value. It is not checked for validity.
+
+        @throws std::invalid_argument Thrown if the field was not
+        listed when the message was prepared.
+    */
+    BOOST_BEAST_DECL
+    void
+    set(field name, string_view value);
+
+    /** Restore the prepared value of every field set in this copy.
+    */
+    BOOST_BEAST_DECL
+    void
+    clear() noexcept;
+
+    /** Returns the buffers representing the message.
+
+        The buffers remain valid until this object is
+        modified or destroyed.
+    */
+    BOOST_BEAST_DECL
+    const_buffers_type
+    buffers() const;
+
+private:
+    struct slot
+    {
+        field name;
+        std::size_t pos;        // offset of the value
+        std::size_t size;       // size of the value
+    };
+
+    struct impl
+    {
+        std::string data;
+        std::array<slot, max_fields> slots;
+        std::size_t nslot = 0;
+    };
+
+    BOOST_BEAST_DECL
+    void
+    init(std::string s,
+        std::initializer_list<field> fields);
+
+    std::shared_ptr<impl const> impl_;
+    std::array<std::string, max_fields> values_;
+    unsigned set_ = 0;  // bit i is set when values_[i] is used
+};
+
+//------------------------------------------------------------------------------
+
+/** Write a prepared message to a stream.
+
+    This function is used to write a prepared message to a stream. The call
+    will block until all of the octets are written, or an error occurs.
+
+    This operation is implemented in terms of one or more calls to the
+    stream's `write_some` function.
+
+    @param stream The stream to which the data is to be written.
+    The type must support the <em>SyncWriteStream</em> concept.
+
+    @param msg The message to write.
+
+    @return The number of bytes written to the stream.
+
+    @throws system_error Thrown on failure.
+*/
+template<class SyncWriteStream>
+std::size_t
+write(
+    SyncWriteStream& stream,
+    prepared_message const& msg);
+
+/** Write a prepared message to a stream.
+
+    This function is used to write a prepared message to a stream. The call
+    will block until all of the octets are written, or an error occurs.
+
+    This operation is implemented in terms of one or more calls to the
+    stream's `write_some` function.
+
+    @param stream The stream to which the data is to be written.
+    The type must support the <em>SyncWriteStream</em> concept.
+
+    @param msg The message to write.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of bytes written to the stream.
+*/
+template<class SyncWriteStream>
+std::size_t
+write(
+    SyncWriteStream& stream,
+    prepared_message const& msg,
+    error_code& ec);
+
+/** Write a prepared message to a stream asynchronously.
+
+    This function is used to write a prepared message to a stream
+    asynchronously. The function call always returns immediately. The
+    asynchronous operation will continue until all of the octets are
+    written, or an error occurs.
+
+    This operation is implemented in terms of zero or more calls to the stream's
+    `async_write_some` function, and is known as a <em>composed operation</em>.
+    The program must ensure that the stream performs no other writes
+    until this operation completes.
+
+    @param stream The stream to which the data is to be written.
+    The type must support the <em>AsyncWriteStream</em> concept.
+
+    @param msg The message to write. The implementation keeps a copy,
+    which shares the serialized message, until the handler is called.
+
+    @param handler The completion handler to invoke when the operation
+    completes. The implementation takes ownership of the handler by
+    performing a decay-copy. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of bytes written to the stream
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+*/
+template<
+    class AsyncWriteStream,
+    class WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+async_write(
+    AsyncWriteStream& stream,
+    prepared_message const& msg,
+    WriteHandler&& handler);
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/prepared_message.hpp>
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/http/impl/prepared_message.ipp>
+#endif
+
+#endif
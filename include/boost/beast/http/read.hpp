@@ -423,6 +423,11 @@ async_read_header(
     bytes are stored in the dynamic buffer, which must be preserved for
     subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
@@ -480,6 +485,11 @@ read(
     bytes are stored in the dynamic buffer, which must be preserved for
     subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
@@ -541,6 +551,11 @@ read(
     These additional bytes are stored in the dynamic buffer, which must be
     preserved for subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
@@ -616,6 +631,11 @@ async_read(
     bytes are stored in the dynamic buffer, which must be preserved for
     subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
@@ -676,6 +696,11 @@ read(
     bytes are stored in the dynamic buffer, which must be preserved for
     subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
@@ -740,6 +765,11 @@ read(
     These additional bytes are stored in the dynamic buffer, which must be
     preserved for subsequent reads.
 
+    Once the header is parsed, the remainder of a large body with a known
+    Content-Length is read from the stream directly into the buffers
+    provided by the parser through @ref basic_parser::prepare_body, when
+    the body's reader supports it, instead of through the dynamic buffer.
+
     If the end of file error is received while reading from the stream, then
     the error returned from this function will be:
 
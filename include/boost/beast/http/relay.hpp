@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_RELAY_HPP
+#define BOOST_BEAST_HTTP_RELAY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/async_result.hpp>
+
+#if ! defined(BOOST_BEAST_NO_SPLICE)
+# if ! defined(__linux__)
+#  define BOOST_BEAST_NO_SPLICE
+# endif
+#endif
+
+#if ! defined(BOOST_BEAST_USE_SPLICE)
+# if ! defined(BOOST_BEAST_NO_SPLICE)
+#  define BOOST_BEAST_USE_SPLICE 1
+# else
+#  define BOOST_BEAST_USE_SPLICE 0
+# endif
+#endif
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** Relay an HTTP message asynchronously.
+
+    This function relays an HTTP message from a downstream client to
+    an upstream server, or from an upstream server to a downstream
+    client. After the message header is read from the input, a user
+    provided transformation function is invoked which may change the
+    contents of the header before forwarding to the output. This may
+    be used to adjust fields such as Server, or proxy fields.
+
+    The body is relayed piece by piece through a small buffer owned
+    by the operation. When `BOOST_BEAST_USE_SPLICE` is set, which is
+    the default on Linux, both streams are instances of
+    `net::basic_stream_socket`, the input body has a Content-Length
+    and the transformed header is not chunked, the rest of the body
+    is instead moved from the input socket to the output socket
+    through a pipe with `splice(2)`, so it never enters user space.
+    The sockets are made non-blocking while splicing, and their
+    previous modes are restored before the handler is invoked.
+    Chunked bodies and other streams, such as SSL streams, always
+    use the buffer.
+
+    This operation is implemented in terms of zero or more calls to
+    the input's `async_read_some` and the output's `async_write_some`
+    functions, and is known as a <em>composed operation</em>. The
+    program must ensure that the input performs no other reads and
+    the output performs no other writes until this operation completes.
+    The implementation may read additional bytes from the input that
+    lie past the end of the message being relayed. These additional
+    bytes are stored in the dynamic buffer, which must be preserved
+    for subsequent reads.
+
+    @param output The stream to write to. The type must meet the
+    requirements of <em>AsyncWriteStream</em>.
+
+    @param input The stream to read from. The type must meet the
+    requirements of <em>AsyncReadStream</em>.
+
+    @param buffer The buffer to use for the input. The object must
+    remain valid at least until the handler is called; ownership is
+    not transferred.
+
+    @param transform The header transformation to apply. The
+    implementation takes ownership by performing a decay-copy.
+    The function will be called with this signature:
+    @code
+        void transform(
+            message<isRequest, buffer_body, fields>&,   // The message to transform
+            error_code&);                               // Set to the error, if any
+    @endcode
+
+    @param handler The completion handler to invoke when the operation
+    completes. The implementation takes ownership of the handler by
+    performing a decay-copy. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of bytes written to the output
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+
+    @tparam isRequest `true` to relay a request.
+*/
+template<
+    bool isRequest,
+    class AsyncWriteStream,
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class Transform,
+    class RelayHandler>
+BOOST_BEAST_ASYNC_RESULT2(RelayHandler)
+async_relay(
+    AsyncWriteStream& output,
+    AsyncReadStream& input,
+    DynamicBuffer& buffer,
+    Transform&& transform,
+    RelayHandler&& handler);
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/relay.hpp>
+
+#endif
@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_SERIALIZE_HPP
+#define BOOST_BEAST_HTTP_SERIALIZE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/type_traits.hpp>
+#include <cstddef>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** Serialize a complete message into a dynamic buffer.
+
+    This function appends the HTTP/1 serialized representation of
+    the message to the buffer, as @ref write would send it to a
+    stream. The output may then be cached, or handed to another
+    transport.
+
+    When the size of the body is known, the exact size of the output
+    is computed first from the header and the body. The buffer is
+    grown once, and the start line, fields and body are copied into
+    it in one pass. A chunked body of known size is sent as a single
+    chunk. Otherwise, the header is appended first, then each buffer
+    produced by the body. A body writer which produces a different
+    number of octets than the size of the body fails with
+    @ref error::bad_content_length.
+
+    @note This function only participates in overload resolution
+    if @ref is_mutable_body_writer for <em>Body</em> returns `true`.
+
+    @param msg The message to serialize.
+
+    @param buffer The dynamic buffer to which the octets are
+    appended.
+
+    @return The number of octets appended.
+
+    @throws system_error Thrown if the body fails.
+
+    @throws std::length_error Thrown if the buffer cannot hold
+    the message.
+*/
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+#if BOOST_BEAST_DOXYGEN
+std::size_t
+#else
+typename std::enable_if<
+    is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+#endif
+serialize(
+    message<isRequest, Body, Fields>& msg,
+    DynamicBuffer& buffer);
+
+/** Serialize a complete message into a dynamic buffer.
+
+    This function appends the HTTP/1 serialized representation of
+    the message to the buffer, as @ref write would send it to a
+    stream. The output may then be cached, or handed to another
+    transport.
+
+    When the size of the body is known, the exact size of the output
+    is computed first from the header and the body. The buffer is
+    grown once, and the start line, fields and body are copied into
+    it in one pass. A chunked body of known size is sent as a single
+    chunk. Otherwise, the header is appended first, then each buffer
+    produced by the body. A body writer which produces a different
+    number of octets than the size of the body fails with
+    @ref error::bad_content_length.
+
+    @note This function only participates in overload resolution
+    if @ref is_mutable_body_writer for <em>Body</em> returns `false`.
+
+    @param msg The message to serialize.
+
+    @param buffer The dynamic buffer to which the octets are
+    appended.
+
+    @return The number of octets appended.
+
+    @throws system_error Thrown if the body fails.
+
+    @throws std::length_error Thrown if the buffer cannot hold
+    the message.
+*/
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+#if BOOST_BEAST_DOXYGEN
+std::size_t
+#else
+typename std::enable_if<
+    ! is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+#endif
+serialize(
+    message<isRequest, Body, Fields> const& msg,
+    DynamicBuffer& buffer);
+
+/** Serialize a complete message into a dynamic buffer.
+
+    This function appends the HTTP/1 serialized representation of
+    the message to the buffer, as @ref write would send it to a
+    stream. The output may then be cached, or handed to another
+    transport.
+
+    When the size of the body is known, the exact size of the output
+    is computed first from the header and the body. The buffer is
+    grown once, and the start line, fields and body are copied into
+    it in one pass. A chunked body of known size is sent as a single
+    chunk. Otherwise, the header is appended first, then each buffer
+    produced by the body. A body writer which produces a different
+    number of octets than the size of the body fails with
+    @ref error::bad_content_length.
+
+    @note This function only participates in overload resolution
+    if @ref is_mutable_body_writer for <em>Body</em> returns `true`.
+
+    @param msg The message to serialize.
+
+    @param buffer The dynamic buffer to which the octets are
+    appended. If an error occurs when the size of the body is
+    known, nothing is appended. Otherwise, the octets produced
+    before the error are kept.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of octets appended.
+
+    @throws std::length_error Thrown if the buffer cannot hold
+    the message.
+*/
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+#if BOOST_BEAST_DOXYGEN
+std::size_t
+#else
+typename std::enable_if<
+    is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+#endif
+serialize(
+    message<isRequest, Body, Fields>& msg,
+    DynamicBuffer& buffer,
+    error_code& ec);
+
+/** Serialize a complete message into a dynamic buffer.
+
+    This function appends the HTTP/1 serialized representation of
+    the message to the buffer, as @ref write would send it to a
+    stream. The output may then be cached, or handed to another
+    transport.
+
+    When the size of the body is known, the exact size of the output
+    is computed first from the header and the body. The buffer is
+    grown once, and the start line, fields and body are copied into
+    it in one pass. A chunked body of known size is sent as a single
+    chunk. Otherwise, the header is appended first, then each buffer
+    produced by the body. A body writer which produces a different
+    number of octets than the size of the body fails with
+    @ref error::bad_content_length.
+
+    @note This function only participates in overload resolution
+    if @ref is_mutable_body_writer for <em>Body</em> returns `false`.
+
+    @param msg The message to serialize.
+
+    @param buffer The dynamic buffer to which the octets are
+    appended. If an error occurs when the size of the body is
+    known, nothing is appended. Otherwise, the octets produced
+    before the error are kept.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of octets appended.
+
+    @throws std::length_error Thrown if the buffer cannot hold
+    the message.
+*/
+template<
+    bool isRequest, class Body, class Fields,
+    class DynamicBuffer>
+#if BOOST_BEAST_DOXYGEN
+std::size_t
+#else
+typename std::enable_if<
+    ! is_mutable_body_writer<Body>::value,
+    std::size_t>::type
+#endif
+serialize(
+    message<isRequest, Body, Fields> const& msg,
+    DynamicBuffer& buffer,
+    error_code& ec);
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/serialize.hpp>
+
+#endif
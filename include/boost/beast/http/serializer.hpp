@@ -15,11 +15,13 @@
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/core/detail/buffers_array.hpp>
 #include <boost/beast/core/detail/variant.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/chunk_encode.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/optional.hpp>
+#include <string>
 
 namespace boost {
 namespace beast {
@@ -100,8 +102,9 @@ private:
         do_body_final_c     = 100,
         do_all_c            = 110,
     #endif
+        do_flat             = 120,
 
-        do_complete         = 120
+        do_complete         = 130
     };
 
     void fwrinit(std::true_type);
@@ -111,6 +114,10 @@ private:
     void
     do_visit(error_code& ec, Visit& visit);
 
+    template<std::size_t I>
+    bool
+    do_flatten();
+
     using writer = typename Body::writer;
 
     using cb1_t = buffers_suffix<typename
@@ -181,8 +188,12 @@ private:
     beast::detail::variant<
         pcb1_t, pcb2_t, pcb3_t, pcb4_t,
         pcb5_t ,pcb6_t, pcb7_t, pcb8_t> pv_;
+    beast::detail::buffers_array<16> bv_;
     std::size_t limit_ =
         (std::numeric_limits<std::size_t>::max)();
+    std::string flat_;
+    std::size_t flat_limit_ = 0;
+    std::size_t flat_pos_ = 0;
     int s_ = do_construct;
     bool split_ = false;
     bool header_done_ = false;
@@ -247,6 +258,35 @@ public:
             (std::numeric_limits<std::size_t>::max)();
     }
 
+    /// Returns the size limit for a message copied into one buffer
+    std::size_t
+    flatten_limit()
+    {
+        return flat_limit_;
+    }
+
+    /** Set the size limit for a message copied into one buffer
+
+        When the serialized message is no larger than this limit,
+        the start line, fields and body, including any chunk framing,
+        are copied into a contiguous buffer owned by the serializer
+        and presented to the visitor as a single buffer. A stream
+        then receives one buffer instead of a sequence of small
+        ones, at the cost of a copy. This applies only when the
+        <em>BodyWriter</em> produces the entire body on its first
+        call, and the split feature is not enabled. The new limit
+        takes effect if set before the first call to @ref next.
+
+        The default is zero, which disables the copy.
+
+        @param limit The new size limit, in bytes.
+    */
+    void
+    flatten_limit(std::size_t limit)
+    {
+        flat_limit_ = limit;
+    }
+
     /** Returns `true` if we will pause after writing the complete header.
     */
     bool
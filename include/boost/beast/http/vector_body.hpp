@@ -73,6 +73,8 @@ public:
     class reader
     {
         value_type& body_;
+        std::size_t prepared_ = 0;
+        std::size_t slack_ = 0; // prepared octets past the end
 
     public:
         template<bool isRequest, class Fields>
@@ -103,6 +105,7 @@ public:
         put(ConstBufferSequence const& buffers,
             error_code& ec)
         {
+            trim();
             auto const n = buffer_bytes(buffers);
             auto const len = body_.size();
             if (n > body_.max_size() - len)
@@ -117,11 +120,54 @@ public:
                 &body_[0] + len, n), buffers);
         }
 
+        net::mutable_buffer
+        prepare(std::size_t n, error_code& ec)
+        {
+            // Octets prepared but not received are kept as slack,
+            // so that resize initializes each octet only once.
+            auto const size = body_.size() - slack_;
+            if (n > body_.max_size() - size)
+            {
+                ec = error::buffer_overflow;
+                return {};
+            }
+
+            if(n > slack_)
+            {
+                body_.resize(size + n);
+                slack_ = n;
+            }
+            prepared_ = n;
+            ec = {};
+            return {&body_[0] + size, n};
+        }
+
+        void
+        commit(std::size_t n, error_code& ec)
+        {
+            BOOST_ASSERT(n <= prepared_);
+            slack_ -= n;
+            prepared_ = 0;
+            // Nothing was received, the body may end here
+            if(n == 0)
+                trim();
+            ec = {};
+        }
+
         void
         finish(error_code& ec)
         {
+            trim();
             ec = {};
         }
+
+    private:
+        void
+        trim()
+        {
+            body_.resize(body_.size() - slack_);
+            slack_ = 0;
+        }
     };
 #endif
 
@@ -25,6 +25,8 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 # error Do not compile Beast library source with BOOST_BEAST_HEADER_ONLY defined
 #endif
 
+#include <boost/beast/_experimental/core/detail/uring_service.ipp>
+
 #include <boost/beast/_experimental/test/impl/error.ipp>
 #include <boost/beast/_experimental/test/impl/fail_count.ipp>
 #include <boost/beast/_experimental/test/impl/stream.ipp>
@@ -36,6 +38,7 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/core/impl/file_stdio.ipp>
 #include <boost/beast/core/impl/file_win32.ipp>
 #include <boost/beast/core/impl/flat_static_buffer.ipp>
+#include <boost/beast/core/impl/monotonic_arena.ipp>
 #include <boost/beast/core/impl/saved_handler.ipp>
 #include <boost/beast/core/impl/static_buffer.ipp>
 
@@ -44,6 +47,7 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/http/impl/basic_parser.ipp>
 #include <boost/beast/http/impl/error.ipp>
 #include <boost/beast/http/impl/field.ipp>
+#include <boost/beast/http/impl/prepared_message.ipp>
 #include <boost/beast/http/impl/rfc7230.ipp>
 #include <boost/beast/http/impl/status.ipp>
 #include <boost/beast/http/impl/verb.ipp>
@@ -58,5 +62,6 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/zlib/detail/deflate_stream.ipp>
 #include <boost/beast/zlib/detail/inflate_stream.ipp>
 #include <boost/beast/zlib/impl/error.ipp>
+#include <boost/beast/zlib/impl/parallel_deflate_stream.ipp>
 
 #endif
@@ -47,6 +47,9 @@ struct impl_base<true>
         // `true` if current read message is compressed
         bool rd_set = false;
 
+        // `true` if the dictionary is loaded by the next inflate
+        bool rd_dict = false;
+
         zlib::deflate_stream zo;
         zlib::inflate_stream zi;
     };
@@ -160,30 +163,95 @@ struct impl_base<true>
             this->pmd_config_.server_no_context_takeover))
         {
             this->pmd_->zo.reset();
+            set_dictionary_write();
         }
     }
 
+    // prime the compressor with the preset dictionary
+    void
+    set_dictionary_write()
+    {
+        if(pmd_opts_.dictionary.empty())
+            return;
+        error_code ec;
+        pmd_->zo.set_dictionary(
+            pmd_opts_.dictionary.data(),
+            pmd_opts_.dictionary.size(), ec);
+        BOOST_ASSERT(! ec);
+    }
+
+    // prime the decompressor with the preset dictionary
+    void
+    set_dictionary_read()
+    {
+        if(pmd_opts_.dictionary.empty())
+            return;
+        error_code ec;
+        pmd_->zi.set_dictionary(
+            pmd_opts_.dictionary.data(),
+            pmd_opts_.dictionary.size(), ec);
+        BOOST_ASSERT(! ec);
+    }
+
     void
     inflate(
         zlib::z_params& zs,
         zlib::Flush flush,
         error_code& ec)
     {
+        if(pmd_->rd_dict)
+        {
+            pmd_->rd_dict = false;
+            set_dictionary_read();
+        }
         pmd_->zi.write(zs, flush, ec);
     }
 
+    // `true` if each message read starts from an empty window
+    bool
+    rd_no_context_takeover(role_type role) const
+    {
+        return
+            (role == role_type::client &&
+                pmd_config_.server_no_context_takeover) ||
+            (role == role_type::server &&
+                pmd_config_.client_no_context_takeover);
+    }
+
+    // A message inflated in place must be copied into the window
+    // before the caller gets its buffers back, unless it is done.
+    void
+    keep_inflate_output()
+    {
+        pmd_->zi.in_place(false);
+    }
+
     void
     do_context_takeover_read(role_type role)
     {
-        if((role == role_type::client &&
-                pmd_config_.server_no_context_takeover) ||
-           (role == role_type::server &&
-                pmd_config_.client_no_context_takeover))
+        if(rd_no_context_takeover(role))
         {
+            // Without references to earlier messages, each one
+            // is inflated in place into the caller's buffers.
             pmd_->zi.clear();
+            pmd_->zi.in_place(true);
+            // The window must hold only the dictionary. It is loaded
+            // when the next message arrives, which may be much later.
+            pmd_->rd_dict = ! pmd_opts_.dictionary.empty();
         }
     }
 
+    // Release the inflate memory of an idle connection. Only
+    // possible between messages, when none refer to earlier ones.
+    void
+    shrink_inflate(role_type role)
+    {
+        if(! pmd_ || ! rd_no_context_takeover(role))
+            return;
+        pmd_->zi.shrink();
+        pmd_->rd_dict = ! pmd_opts_.dictionary.empty();
+    }
+
     template<class Body, class Allocator>
     void
     build_response_pmd(
@@ -277,7 +345,7 @@ struct impl_base<true>
                     pmd_opts_.compLevel,
                     pmd_config_.client_max_window_bits,
                     pmd_opts_.memLevel,
-                    zlib::Strategy::normal);
+                    pmd_opts_.strategy);
             }
             else
             {
@@ -287,8 +355,12 @@ struct impl_base<true>
                     pmd_opts_.compLevel,
                     pmd_config_.server_max_window_bits,
                     pmd_opts_.memLevel,
-                    zlib::Strategy::normal);
+                    pmd_opts_.strategy);
             }
+            set_dictionary_read();
+            set_dictionary_write();
+            if(rd_no_context_takeover(role))
+                pmd_->zi.in_place(true);
         }
     }
 
@@ -383,11 +455,21 @@ struct impl_base<false>
     {
     }
 
+    void
+    keep_inflate_output()
+    {
+    }
+
     void
     do_context_takeover_read(role_type)
     {
     }
 
+    void
+    shrink_inflate(role_type)
+    {
+    }
+
     template<class Body, class Allocator>
     void
     build_response_pmd(
@@ -34,7 +34,8 @@ template<class NextLayer, bool deflateSupported>
 template<class Handler>
 class stream<NextLayer, deflateSupported>::ping_op
     : public beast::stable_async_base<
-        Handler, beast::executor_type<stream>>
+        Handler, beast::executor_type<stream>,
+        beast::detail::op_cache::allocator_type>
     , public net::coroutine
 {
     boost::weak_ptr<impl_type> wp_;
@@ -50,9 +51,11 @@ public:
         detail::opcode op,
         ping_data const& payload)
         : stable_async_base<Handler,
-            beast::executor_type<stream>>(
+            beast::executor_type<stream>,
+            beast::detail::op_cache::allocator_type>(
                 std::forward<Handler_>(h),
-                    sp->stream().get_executor())
+                    sp->stream().get_executor(),
+                    sp->cache.get_allocator())
         , wp_(sp)
         , fb_(beast::allocate_stable<
             detail::frame_buffer>(*this))
@@ -47,7 +47,8 @@ template<class NextLayer, bool deflateSupported>
 template<class Handler, class MutableBufferSequence>
 class stream<NextLayer, deflateSupported>::read_some_op
     : public beast::async_base<
-        Handler, beast::executor_type<stream>>
+        Handler, beast::executor_type<stream>,
+        beast::detail::op_cache::allocator_type>
     , public net::coroutine
 {
     boost::weak_ptr<impl_type> wp_;
@@ -67,9 +68,11 @@ public:
         boost::shared_ptr<impl_type> const& sp,
         MutableBufferSequence const& bs)
         : async_base<
-            Handler, beast::executor_type<stream>>(
+            Handler, beast::executor_type<stream>,
+            beast::detail::op_cache::allocator_type>(
                 std::forward<Handler_>(h),
-                    sp->stream().get_executor())
+                    sp->stream().get_executor(),
+                    sp->cache.get_allocator())
         , wp_(sp)
         , bs_(bs)
         , cb_(bs)
@@ -526,6 +529,9 @@ public:
                     impl.rd_buf.consume(zs.total_in);
                     bytes_written_ += zs.total_out;
                 }
+                // the caller may reuse the buffers from here on
+                if(! impl.rd_done)
+                    impl.keep_inflate_output();
                 if(impl.rd_op == detail::opcode::text)
                 {
                     // check utf8
@@ -618,7 +624,8 @@ template<class NextLayer, bool deflateSupported>
 template<class Handler,  class DynamicBuffer>
 class stream<NextLayer, deflateSupported>::read_op
     : public beast::async_base<
-        Handler, beast::executor_type<stream>>
+        Handler, beast::executor_type<stream>,
+        beast::detail::op_cache::allocator_type>
     , public net::coroutine
 {
     boost::weak_ptr<impl_type> wp_;
@@ -636,9 +643,11 @@ public:
         std::size_t limit,
         bool some)
         : async_base<Handler,
-            beast::executor_type<stream>>(
+            beast::executor_type<stream>,
+            beast::detail::op_cache::allocator_type>(
                 std::forward<Handler_>(h),
-                    sp->stream().get_executor())
+                    sp->stream().get_executor(),
+                    sp->cache.get_allocator())
         , wp_(sp)
         , b_(b)
         , limit_(limit ? limit : (
@@ -1241,6 +1250,9 @@ loop:
             impl.rd_buf.consume(zs.total_in);
             bytes_written += zs.total_out;
         }
+        // the caller may reuse the buffers from here on
+        if(! impl.rd_done)
+            impl.keep_inflate_output();
         if(impl.rd_op == detail::opcode::text)
         {
             // check utf8
@@ -30,6 +30,7 @@
 #include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/clamp.hpp>
+#include <boost/beast/core/detail/op_cache.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -114,6 +115,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     saved_handler           op_close;       // paused close op
     saved_handler           op_r_rd;        // paused read op (async read)
     saved_handler           op_r_close;     // paused close op (async read)
+    beast::detail::op_cache cache;          // recycles op memory
 
     bool    idle_pinging = false;
     bool    secure_prng_ = true;
@@ -216,6 +218,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     begin_msg()
     {
         wr_frag = wr_frag_opt;
+        wr_compress = this->pmd_enabled();
 
         // Maintain the write buffer
         if( this->pmd_enabled() ||
@@ -416,7 +419,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
                     timeout_opt.handshake_timeout);
                 timer.async_wait(
                     timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                        ex, this->weak_from_this(),
+                        cache.get_allocator()));
             }
             break;
 
@@ -432,7 +436,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
                         timeout_opt.idle_timeout);
                 timer.async_wait(
                     timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                        ex, this->weak_from_this(),
+                        cache.get_allocator()));
             }
             else
             {
@@ -449,7 +454,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
                     timeout_opt.handshake_timeout);
                 timer.async_wait(
                     timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                        ex, this->weak_from_this(),
+                        cache.get_allocator()));
             }
             else
             {
@@ -478,14 +484,17 @@ private:
         : boost::empty_value<Executor>
     {
         boost::weak_ptr<impl_type> wp_;
+        beast::detail::op_cache::allocator_type alloc_;
 
     public:
         timeout_handler(
             Executor const& ex,
-            boost::weak_ptr<impl_type>&& wp)
+            boost::weak_ptr<impl_type>&& wp,
+            beast::detail::op_cache::allocator_type const& alloc)
             : boost::empty_value<Executor>(
                 boost::empty_init_t{}, ex)
             , wp_(std::move(wp))
+            , alloc_(alloc)
         {
         }
 
@@ -497,6 +506,15 @@ private:
             return this->get();
         }
 
+        using allocator_type =
+            beast::detail::op_cache::allocator_type;
+
+        allocator_type
+        get_allocator() const noexcept
+        {
+            return alloc_;
+        }
+
         void
         operator()(error_code ec)
         {
@@ -526,6 +544,8 @@ private:
                 if( impl.timeout_opt.keep_alive_pings &&
                     impl.idle_counter < 1)
                 {
+                    if(impl.rd_done)
+                        impl.shrink_inflate(impl.role);
                     idle_ping_op<Executor>(sp, get_executor());
 
                     ++impl.idle_counter;
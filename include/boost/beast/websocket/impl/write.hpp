@@ -40,7 +40,8 @@ template<class NextLayer, bool deflateSupported>
 template<class Handler, class Buffers>
 class stream<NextLayer, deflateSupported>::write_some_op
     : public beast::async_base<
-        Handler, beast::executor_type<stream>>
+        Handler, beast::executor_type<stream>,
+        beast::detail::op_cache::allocator_type>
     , public net::coroutine
 {
     enum
@@ -74,9 +75,11 @@ public:
         bool fin,
         Buffers const& bs)
         : beast::async_base<Handler,
-            beast::executor_type<stream>>(
+            beast::executor_type<stream>,
+            beast::detail::op_cache::allocator_type>(
                 std::forward<Handler_>(h),
-                    sp->stream().get_executor())
+                    sp->stream().get_executor(),
+                    sp->cache.get_allocator())
         , wp_(sp)
         , cb_(bs)
         , fin_(fin)
@@ -12,12 +12,14 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
+#include <boost/beast/zlib/zlib.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/throw_exception.hpp>
 #include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -64,6 +66,28 @@ struct permessage_deflate
 
     /// Deflate memory level, 1..9
     int memLevel = 4;
+
+    /** Deflate strategy
+
+        @ref zlib::Strategy::quick gives the lowest CPU cost per
+        message, at the expense of compression ratio.
+    */
+    zlib::Strategy strategy = zlib::Strategy::normal;
+
+    /** Preset dictionary for both directions
+
+        When not empty, the compressor and decompressor of each
+        direction are primed with this dictionary at the start, and
+        again at every message when context takeover is disabled for
+        that direction. Short messages which resemble each other, such
+        as small JSON documents, then compress much better.
+
+        Nothing in the extension negotiates a dictionary, so both
+        peers must agree on it out of band; a peer without the same
+        dictionary fails to decompress the first message. Do not set
+        this for connections with arbitrary peers.
+    */
+    std::string dictionary;
 };
 
 } // websocket
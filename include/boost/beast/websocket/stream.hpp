@@ -73,6 +73,11 @@ class frame_test;
     that they are are all performed within the same implicit
     or explicit strand.
 
+    Intermediate operations allocate their memory with the
+    allocator associated with the completion handler, or else
+    from a cache kept by the stream. The deprecated
+    `asio_handler_allocate` hooks are not consulted.
+
     @par Thread Safety
     @e Distinct @e objects: Safe.@n
     @e Shared @e objects: Unsafe.
@@ -146,6 +151,7 @@ class stream
     friend class read2_test;
     friend class read3_test;
     friend class stream_test;
+    friend class timer_test;
     friend class write_test;
 
     /*  The read buffer has to be at least as large
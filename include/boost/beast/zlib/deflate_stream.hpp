@@ -134,6 +134,49 @@ public:
         doClear();
     }
 
+    /** Initialize the compression dictionary.
+
+        This function loads a preset dictionary: a sequence of bytes
+        which are likely to be encountered in the data to be compressed,
+        with the most commonly used strings placed toward its end. The
+        compressor may then refer to strings in the dictionary as if
+        they had just been compressed, which mostly benefits short
+        inputs that resemble each other, such as small documents with
+        the same structure.
+
+        The decompressor must be given the identical dictionary with
+        @ref inflate_stream::set_dictionary before it is given any of
+        the compressed data, since nothing in the raw deflate format
+        identifies it.
+
+        This function should be called after @ref reset and before the
+        first call to @ref write. It may also be called when a flush
+        has consumed all input, to start over from new history. Only
+        the last window size bytes of the dictionary are used.
+
+        @param dict A pointer to the dictionary.
+
+        @param size The size of the dictionary in bytes.
+
+        @param ec Set to `error::stream_error` if input is still
+        pending from a previous call to @ref write.
+    */
+    void
+    set_dictionary(
+        void const* dict,
+        std::size_t size,
+        error_code& ec)
+    {
+        auto p = static_cast<Byte const*>(dict);
+        // More than the largest window is never used
+        if(size > 32768)
+        {
+            p += size - 32768;
+            size = 32768;
+        }
+        doDictionary(p, static_cast<uInt>(size), ec);
+    }
+
     /** Returns the upper limit on the size of a compressed block.
 
         This function makes a conservative estimate of the maximum number
@@ -150,6 +193,20 @@ public:
         return doUpperBound(sourceLen);
     }
 
+    /** Returns the memory used by the stream, in bytes.
+
+        This is the size of the object plus the internal buffers it
+        holds. The buffers are sized by the window size and memory
+        level, and are allocated by the first call to @ref write or
+        @ref set_dictionary. They are kept by @ref reset and freed
+        by @ref clear.
+    */
+    std::size_t
+    memory_usage() const
+    {
+        return sizeof(*this) + doAllocated();
+    }
+
     /** Fine tune internal compression parameters.
 
         Compression parameters should only be tuned by someone who
@@ -38,7 +38,9 @@
 #define BOOST_BEAST_ZLIB_DETAIL_BITSTREAM_HPP
 
 #include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 
 namespace boost {
@@ -46,9 +48,17 @@ namespace beast {
 namespace zlib {
 namespace detail {
 
+/*  Bits are held least significant first in a 64-bit reservoir.
+
+    Bits above size() are either zero or the bits of the bytes which
+    follow in the input: refill() loads whole words and only advances
+    past the bytes which fit, so those bytes are loaded again, in the
+    same position, by the next refill. For this reason bits are always
+    merged in with a bitwise or.
+*/
 class bitstream
 {
-    using value_type = std::uint32_t;
+    using value_type = std::uint64_t;
 
     value_type v_ = 0;
     unsigned n_ = 0;
@@ -100,6 +110,18 @@ public:
     void
     fill_16(FwdIt& it);
 
+    // fill to at least 56 bits, reading 8 bytes unchecked
+    void
+    refill(std::uint8_t const*& it)
+    {
+        BOOST_ASSERT(n_ < 64);
+        value_type v;
+        std::memcpy(&v, it, sizeof(v));
+        v_ |= endian::little_to_native(v) << n_;
+        it += (63 - n_) >> 3;
+        n_ |= 56;
+    }
+
     // return n bits
     template<class Unsigned>
     void
@@ -132,7 +154,7 @@ fill(std::size_t n, FwdIt& first, FwdIt const& last)
     {
         if(first == last)
             return false;
-        v_ += static_cast<value_type>(*first++) << n_;
+        v_ |= static_cast<value_type>(*first++) << n_;
         n_ += 8;
     }
     return true;
@@ -143,7 +165,7 @@ void
 bitstream::
 fill_8(FwdIt& it)
 {
-    v_ += static_cast<value_type>(*it++) << n_;
+    v_ |= static_cast<value_type>(*it++) << n_;
     n_ += 8;
 }
 
@@ -152,9 +174,9 @@ void
 bitstream::
 fill_16(FwdIt& it)
 {
-    v_ += static_cast<value_type>(*it++) << n_;
+    v_ |= static_cast<value_type>(*it++) << n_;
     n_ += 8;
-    v_ += static_cast<value_type>(*it++) << n_;
+    v_ |= static_cast<value_type>(*it++) << n_;
     n_ += 8;
 }
 
@@ -190,7 +212,7 @@ rewind(BidirIt& it)
     auto len = n_ >> 3;
     it = std::prev(it, len);
     n_ &= 7;
-    v_ &= (1U << n_) - 1;
+    v_ &= (value_type(1) << n_) - 1;
 }
 
 } // detail
@@ -40,9 +40,11 @@
 #include <boost/beast/zlib/error.hpp>
 #include <boost/beast/zlib/zlib.hpp>
 #include <boost/beast/zlib/detail/ranges.hpp>
+#include <boost/beast/core/detail/cpu_info.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/optional.hpp>
 #include <boost/throw_exception.hpp>
 #include <cstdint>
@@ -52,11 +54,35 @@
 #include <stdexcept>
 #include <type_traits>
 
+#if BOOST_BEAST_CPU_DISPATCH
+#include <nmmintrin.h> // _mm_crc32_u32
+#endif
+
 namespace boost {
 namespace beast {
 namespace zlib {
 namespace detail {
 
+#if BOOST_BEAST_CPU_DISPATCH
+/*  Return the CRC32C of the three bytes at p.
+
+    This is compiled for SSE4.2 whatever the build flags, so it
+    must only be called when cpu_info reports support.
+*/
+#if defined(BOOST_GCC) || defined(BOOST_CLANG)
+__attribute__((target("sse4.2")))
+#endif
+inline
+std::uint32_t
+crc_hash3(std::uint8_t const* p)
+{
+    return _mm_crc32_u32(0,
+        std::uint32_t(p[0]) |
+        (std::uint32_t(p[1]) << 8) |
+        (std::uint32_t(p[2]) << 16));
+}
+#endif
+
 class deflate_stream
 {
 protected:
@@ -302,6 +328,11 @@ protected:
     */
     uInt hash_shift_;
 
+    /*  Set when strings are hashed with the SSE4.2 CRC32 instruction
+        instead of the running hash.
+    */
+    bool crc_hash_ = false;
+
     /*  Window position at the beginning of the current output block.
         Gets negative when the window is moved backwards.
     */
@@ -502,6 +533,24 @@ protected:
         h = ((h << hash_shift_) ^ c) & hash_mask_;
     }
 
+    /*  Return the hash index of the string at window_[str].
+        Without SSE4.2 this advances the running hash, and the
+        same assertion as update_hash applies: calls are made
+        with consecutive values of str. With SSE4.2 the minMatch
+        bytes of the string are hashed directly using CRC32, which
+        spreads strings over the table better.
+    */
+    uInt
+    next_hash(uInt str)
+    {
+#if BOOST_BEAST_CPU_DISPATCH
+        if(crc_hash_)
+            return crc_hash3(window_ + str) & hash_mask_;
+#endif
+        update_hash(ins_h_, window_[str + (minMatch-1)]);
+        return ins_h_;
+    }
+
     /*  Initialize the hash table (avoiding 64K overflow for 16
         bit systems). prev[] will be initialized on the fly.
     */
@@ -538,9 +587,9 @@ protected:
     void
     insert_string(IPos& hash_head)
     {
-        update_hash(ins_h_, window_[strstart_ + (minMatch-1)]);
-        hash_head = prev_[strstart_ & w_mask_] = head_[ins_h_];
-        head_[ins_h_] = (std::uint16_t)strstart_;
+        auto const h = next_hash(strstart_);
+        hash_head = prev_[strstart_ & w_mask_] = head_[h];
+        head_[h] = (std::uint16_t)strstart_;
     }
 
     //--------------------------------------------------------------------------
@@ -601,6 +650,12 @@ protected:
             init();
     }
 
+    std::size_t
+    doAllocated() const
+    {
+        return buf_ ? buf_size_ : 0;
+    }
+
     template<class Unsigned>
     static
     Unsigned
@@ -637,6 +692,7 @@ protected:
     BOOST_BEAST_DECL void scan_tree           (ct_data *tree, int max_code);
     BOOST_BEAST_DECL void send_tree           (ct_data *tree, int max_code);
     BOOST_BEAST_DECL int  build_bl_tree       ();
+    BOOST_BEAST_DECL std::uint32_t static_tree_len();
     BOOST_BEAST_DECL void send_all_trees      (int lcodes, int dcodes, int blcodes);
     BOOST_BEAST_DECL void compress_block      (ct_data const* ltree, ct_data const* dtree);
     BOOST_BEAST_DECL int  detect_data_type    ();
@@ -657,12 +713,14 @@ protected:
     BOOST_BEAST_DECL void flush_block         (z_params& zs, bool last);
     BOOST_BEAST_DECL int  read_buf            (z_params& zs, Byte *buf, unsigned size);
     BOOST_BEAST_DECL uInt longest_match       (IPos cur_match);
+    BOOST_BEAST_DECL static int match_length  (Byte const* scan, Byte const* match);
 
     BOOST_BEAST_DECL block_state f_stored     (z_params& zs, Flush flush);
     BOOST_BEAST_DECL block_state f_fast       (z_params& zs, Flush flush);
     BOOST_BEAST_DECL block_state f_slow       (z_params& zs, Flush flush);
     BOOST_BEAST_DECL block_state f_rle        (z_params& zs, Flush flush);
     BOOST_BEAST_DECL block_state f_huff       (z_params& zs, Flush flush);
+    BOOST_BEAST_DECL block_state f_quick      (z_params& zs, Flush flush);
 
     block_state
     deflate_stored(z_params& zs, Flush flush)
@@ -693,6 +751,12 @@ protected:
     {
         return f_huff(zs, flush);
     }
+
+    block_state
+    deflate_quick(z_params& zs, Flush flush)
+    {
+        return f_quick(zs, flush);
+    }
 };
 
 //--------------------------------------------------------------------------
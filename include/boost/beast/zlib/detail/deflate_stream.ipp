@@ -39,6 +39,7 @@
 
 #include <boost/beast/zlib/detail/deflate_stream.hpp>
 #include <boost/beast/zlib/detail/ranges.hpp>
+#include <boost/beast/zlib/detail/slide_hash.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
@@ -422,7 +423,8 @@ doWrite(z_params& zs, boost::optional<Flush> flush, error_code& ec)
     {
         block_state bstate;
 
-        switch(strategy_)
+        // Level 0 always produces stored blocks
+        switch(level_ == 0 ? Strategy::normal : strategy_)
         {
         case Strategy::huffman:
             bstate = deflate_huff(zs, flush.get());
@@ -430,6 +432,9 @@ doWrite(z_params& zs, boost::optional<Flush> flush, error_code& ec)
         case Strategy::rle:
             bstate = deflate_rle(zs, flush.get());
             break;
+        case Strategy::quick:
+            bstate = deflate_quick(zs, flush.get());
+            break;
         default:
         {
             bstate = (this->*(get_config(level_).func))(zs, flush.get());
@@ -496,19 +501,18 @@ doWrite(z_params& zs, boost::optional<Flush> flush, error_code& ec)
     }
 }
 
-// VFALCO Warning: untested
 void
 deflate_stream::
 doDictionary(Byte const* dict, uInt dictLength, error_code& ec)
 {
+    maybe_init();
+
     if(lookahead_)
     {
         ec = error::stream_error;
         return;
     }
 
-    maybe_init();
-
     /* if dict would fill window, just replace the history */
     if(dictLength >= w_size_)
     {
@@ -533,9 +537,9 @@ doDictionary(Byte const* dict, uInt dictLength, error_code& ec)
         uInt n = lookahead_ - (minMatch-1);
         do
         {
-            update_hash(ins_h_, window_[str + minMatch-1]);
-            prev_[str & w_mask_] = head_[ins_h_];
-            head_[ins_h_] = (std::uint16_t)str;
+            auto const h = next_hash(str);
+            prev_[str & w_mask_] = head_[h];
+            head_[h] = (std::uint16_t)str;
             str++;
         }
         while(--n);
@@ -607,6 +611,9 @@ init()
     hash_size_ = 1 << hash_bits_;
     hash_mask_ = hash_size_ - 1;
     hash_shift_ =  ((hash_bits_+minMatch-1)/minMatch);
+#if BOOST_BEAST_CPU_DISPATCH
+    crc_hash_ = beast::detail::get_cpu_info().sse42;
+#endif
 
     auto const nwindow  = w_size_ * 2*sizeof(Byte);
     auto const nprev    = w_size_ * sizeof(std::uint16_t);
@@ -1121,6 +1128,28 @@ build_bl_tree()
     return max_blindex;
 }
 
+/*  Return the bit length of the current block with the static trees,
+    the same value build_tree leaves in static_len, without building
+    the dynamic trees.
+*/
+std::uint32_t
+deflate_stream::
+static_tree_len()
+{
+    std::uint32_t len = 0;
+    for(int n = 0; n < lCodes; ++n)
+    {
+        unsigned bits = lut_.ltree[n].dl;
+        if(n > literals)
+            bits += lut_.extra_lbits[n - literals - 1];
+        len += std::uint32_t{dyn_ltree_[n].fc} * bits;
+    }
+    for(int n = 0; n < dCodes; ++n)
+        len += std::uint32_t{dyn_dtree_[n].fc} *
+            (lut_.dtree[n].dl + lut_.extra_dbits[n]);
+    return len;
+}
+
 /*  Send the header for a block using dynamic Huffman trees: the counts,
     the lengths of the bit length codes, the literal tree and the distance
     tree.
@@ -1405,25 +1434,34 @@ tr_flush_block(
         if(zs.data_type == unknown)
             zs.data_type = detect_data_type();
 
-        // Construct the literal and distance trees
-        build_tree((tree_desc *)(&(l_desc_)));
+        if(strategy_ == Strategy::quick)
+        {
+            // Quick blocks use the static trees or are stored,
+            // so the dynamic trees are never built.
+            opt_lenb = static_lenb = (static_tree_len()+3+7)>>3;
+        }
+        else
+        {
+            // Construct the literal and distance trees
+            build_tree((tree_desc *)(&(l_desc_)));
 
-        build_tree((tree_desc *)(&(d_desc_)));
-        /* At this point, opt_len and static_len are the total bit lengths of
-         * the compressed block data, excluding the tree representations.
-         */
+            build_tree((tree_desc *)(&(d_desc_)));
+            /* At this point, opt_len and static_len are the total bit lengths of
+             * the compressed block data, excluding the tree representations.
+             */
 
-        /* Build the bit length tree for the above two trees, and get the index
-         * in bl_order of the last bit length code to send.
-         */
-        max_blindex = build_bl_tree();
+            /* Build the bit length tree for the above two trees, and get the index
+             * in bl_order of the last bit length code to send.
+             */
+            max_blindex = build_bl_tree();
 
-        /* Determine the best encoding. Compute the block lengths in bytes. */
-        opt_lenb = (opt_len_+3+7)>>3;
-        static_lenb = (static_len_+3+7)>>3;
+            /* Determine the best encoding. Compute the block lengths in bytes. */
+            opt_lenb = (opt_len_+3+7)>>3;
+            static_lenb = (static_len_+3+7)>>3;
 
-        if(static_lenb <= opt_lenb)
-            opt_lenb = static_lenb;
+            if(static_lenb <= opt_lenb)
+                opt_lenb = static_lenb;
+        }
     }
     else
     {
@@ -1458,7 +1496,8 @@ tr_flush_block(
         // force static trees
 #else
     }
-    else if(strategy_ == Strategy::fixed || static_lenb == opt_lenb)
+    else if(strategy_ == Strategy::fixed ||
+        strategy_ == Strategy::quick || static_lenb == opt_lenb)
     {
 #endif
         send_bits((STATIC_TREES<<1)+last, 3);
@@ -1485,9 +1524,8 @@ void
 deflate_stream::
 fill_window(z_params& zs)
 {
-    unsigned n, m;
+    unsigned n;
     unsigned more;    // Amount of free space at the end of the window.
-    std::uint16_t *p;
     uInt wsize = w_size_;
 
     do
@@ -1530,26 +1568,11 @@ fill_window(z_params& zs)
                later. (Using level 0 permanently is not an optimal usage of
                zlib, so we don't care about this pathological case.)
             */
-            n = hash_size_;
-            p = &head_[n];
-            do
-            {
-                m = *--p;
-                *p = (std::uint16_t)(m >= wsize ? m-wsize : 0);
-            }
-            while(--n);
-
-            n = wsize;
-            p = &prev_[n];
-            do
-            {
-                m = *--p;
-                *p = (std::uint16_t)(m >= wsize ? m-wsize : 0);
-                /*  If n is not on any hash chain, prev[n] is garbage but
-                    its value will never be used.
-                */
-            }
-            while(--n);
+            slide_hash(head_, hash_size_, (std::uint16_t)wsize);
+            /*  If n is not on any hash chain, prev[n] is garbage but
+                its value will never be used.
+            */
+            slide_hash(prev_, wsize, (std::uint16_t)wsize);
             more += wsize;
         }
         if(zs.avail_in == 0)
@@ -1577,9 +1600,9 @@ fill_window(z_params& zs)
             update_hash(ins_h_, window_[str + 1]);
             while(insert_)
             {
-                update_hash(ins_h_, window_[str + minMatch-1]);
-                prev_[str & w_mask_] = head_[ins_h_];
-                head_[ins_h_] = (std::uint16_t)str;
+                auto const h = next_hash(str);
+                prev_[str & w_mask_] = head_[h];
+                head_[h] = (std::uint16_t)str;
                 str++;
                 insert_--;
                 if(lookahead_ + insert_ < minMatch)
@@ -1724,7 +1747,6 @@ longest_match(IPos cur_match)
     std::uint16_t *prev = prev_;
     uInt wmask = w_mask_;
 
-    Byte *strend = window_ + strstart_ + maxMatch;
     Byte scan_end1  = scan[best_len-1];
     Byte scan_end   = scan[best_len];
 
@@ -1760,34 +1782,14 @@ longest_match(IPos cur_match)
         if(     match[best_len]   != scan_end  ||
                 match[best_len-1] != scan_end1 ||
                 *match            != *scan     ||
-                *++match          != scan[1])
+                match[1]          != scan[1])
             continue;
 
-        /* The check at best_len-1 can be removed because it will be made
-         * again later. (This heuristic is not always a win.)
-         * It is not necessary to compare scan[2] and match[2] since they
-         * are always equal when the other bytes match, given that
-         * the hash keys are equal and that HASH_BITS >= 8.
+        /* Unlike zlib, scan[2] is compared too: strings in the same
+         * bucket need not share their third byte when they were hashed
+         * with CRC32.
          */
-        scan += 2, match++;
-        BOOST_ASSERT(*scan == *match);
-
-        /* We check for insufficient lookahead only every 8th comparison;
-         * the 256th check will be made at strstart+258.
-         */
-        do
-        {
-        }
-        while(  *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                *++scan == *++match && *++scan == *++match &&
-                scan < strend);
-
-        BOOST_ASSERT(scan <= window_+(unsigned)(window_size_-1));
-
-        len = maxMatch - (int)(strend - scan);
-        scan = strend - maxMatch;
+        len = match_length(scan, match);
 
         if(len > best_len) {
             match_start_ = cur_match;
@@ -1805,6 +1807,45 @@ longest_match(IPos cur_match)
     return lookahead_;
 }
 
+/*  Return the number of leading bytes scan and match have in common,
+    up to maxMatch. Eight bytes are compared per step, and the first
+    difference is found from the trailing zeros of their exclusive or.
+    Both strings are read up to maxMatch bytes, as in longest_match.
+*/
+int
+deflate_stream::
+match_length(Byte const* scan, Byte const* match)
+{
+    static_assert(maxMatch == 32 * 8 + 2,
+        "maxMatch must be 2 more than a multiple of 8");
+    for(int len = 0; len < 32 * 8; len += 8)
+    {
+        std::uint64_t a;
+        std::uint64_t b;
+        std::memcpy(&a, scan + len, sizeof(a));
+        std::memcpy(&b, match + len, sizeof(b));
+        auto x = endian::little_to_native(a ^ b);
+        if(x != 0)
+        {
+#if defined(BOOST_GCC) || defined(BOOST_CLANG)
+            return len + (__builtin_ctzll(x) >> 3);
+#else
+            while((x & 0xff) == 0)
+            {
+                x >>= 8;
+                ++len;
+            }
+            return len;
+#endif
+        }
+    }
+    if(scan[256] != match[256])
+        return 256;
+    if(scan[257] != match[257])
+        return 257;
+    return maxMatch;
+}
+
 //------------------------------------------------------------------------------
 
 /*  Copy without compression as much as possible from the input stream, return
@@ -2285,6 +2326,91 @@ f_huff(z_params& zs, Flush flush) ->
     return block_done;
 }
 
+/*  For Strategy::quick, probe the hash table once per position and
+    take whatever the most recent string with the same hash gives,
+    without walking the chain or evaluating lazily. Strings inside a
+    match are not inserted. Blocks use the fixed codes, as for
+    Strategy::fixed, unless a stored block is smaller.
+*/
+auto
+deflate_stream::
+f_quick(z_params& zs, Flush flush) ->
+    block_state
+{
+    IPos hash_head;         // most recent string with the same hash
+    bool bflush;            // set if current block must be flushed
+
+    for(;;)
+    {
+        /* Make sure that we always have enough lookahead, except
+         * at the end of the input file. We need maxMatch bytes
+         * for the next match, plus minMatch bytes to insert the
+         * string following the next match.
+         */
+        if(lookahead_ < kMinLookahead)
+        {
+            fill_window(zs);
+            if(lookahead_ < kMinLookahead && flush == Flush::none)
+                return need_more;
+            if(lookahead_ == 0)
+                break; /* flush the current block */
+        }
+
+        match_length_ = 0;
+        if(lookahead_ >= minMatch)
+        {
+            insert_string(hash_head);
+            if(hash_head != 0 && strstart_ - hash_head <= max_dist())
+            {
+                match_length_ = match_length(
+                    window_ + strstart_, window_ + hash_head);
+                if(match_length_ > lookahead_)
+                    match_length_ = lookahead_;
+            }
+        }
+
+        if(match_length_ >= minMatch)
+        {
+            tr_tally_dist(static_cast<std::uint16_t>(strstart_ - hash_head),
+                static_cast<std::uint8_t>(match_length_ - minMatch), bflush);
+            lookahead_ -= match_length_;
+            strstart_ += match_length_;
+            match_length_ = 0;
+            // Restart the running hash after the skipped strings
+            ins_h_ = window_[strstart_];
+            update_hash(ins_h_, window_[strstart_+1]);
+        }
+        else
+        {
+            /* No match, output a literal byte */
+            tr_tally_lit(window_[strstart_], bflush);
+            lookahead_--;
+            strstart_++;
+        }
+        if(bflush)
+        {
+            flush_block(zs, false);
+            if(zs.avail_out == 0)
+                return need_more;
+        }
+    }
+    insert_ = strstart_ < minMatch-1 ? strstart_ : minMatch-1;
+    if(flush == Flush::finish)
+    {
+        flush_block(zs, true);
+        if(zs.avail_out == 0)
+            return finish_started;
+        return finish_done;
+    }
+    if(last_lit_)
+    {
+        flush_block(zs, false);
+        if(zs.avail_out == 0)
+            return need_more;
+    }
+    return block_done;
+}
+
 } // detail
 } // zlib
 } // beast
@@ -42,6 +42,7 @@
 #include <boost/beast/zlib/detail/bitstream.hpp>
 #include <boost/beast/zlib/detail/ranges.hpp>
 #include <boost/beast/zlib/detail/window.hpp>
+#include <memory>
 #if 0
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/throw_exception.hpp>
@@ -69,6 +70,10 @@ protected:
     void
     doClear();
 
+    BOOST_BEAST_DECL
+    void
+    doShrink();
+
     BOOST_BEAST_DECL
     void
     doReset(int windowBits);
@@ -77,12 +82,27 @@ protected:
     void
     doWrite(z_params& zs, Flush flush, error_code& ec);
 
+    BOOST_BEAST_DECL
+    void
+    doDictionary(std::uint8_t const* dict, std::size_t size, error_code& ec);
+
+    BOOST_BEAST_DECL
+    void
+    doInPlace(bool value);
+
     void
     doReset()
     {
         doReset(w_.bits());
     }
 
+    std::size_t
+    doAllocated() const
+    {
+        return w_.allocated() +
+            (tables_ ? sizeof(tables) : 0);
+    }
+
 private:
     enum Mode
     {
@@ -163,6 +183,20 @@ private:
     static std::uint16_t constexpr kEnoughDists = 592;
     static std::uint16_t constexpr kEnough = kEnoughLens + kEnoughDists;
 
+    // Input and output space inflate_fast() needs on hand to
+    // decode one more literal or length/distance pair unchecked.
+    static std::size_t constexpr kFastIn = 19;
+    static std::size_t constexpr kFastOut = 2 + 258 + 15;
+
+    // Space for building dynamic tables. Most of the stream's
+    // size, so it is only allocated when a dynamic block arrives.
+    struct tables
+    {
+        unsigned short lens[320];   // temporary storage for code lengths
+        unsigned short work[288];   // work area for code table building
+        code codes[kEnough];        // space for code tables
+    };
+
     struct codes
     {
         code const* lencode;
@@ -200,10 +234,23 @@ private:
     void
     fixedTables();
 
+    BOOST_BEAST_DECL
+    void
+    keep_output();
+
+    BOOST_BEAST_DECL
+    code const*
+    decode(code const* table, unsigned root, ranges& r);
+
     BOOST_BEAST_DECL
     void
     inflate_fast(ranges& r, error_code& ec);
 
+    BOOST_BEAST_DECL
+    static
+    void
+    copy_match(std::uint8_t* out, unsigned dist, unsigned len);
+
     bitstream bi_;
 
     Mode mode_ = HEAD;              // current inflate mode
@@ -213,6 +260,11 @@ private:
     // sliding window
     window w_;
 
+    // output kept in place by the caller, instead of the window
+    bool in_place_ = false;         // true if output is kept in place
+    std::uint8_t* out_end_ = nullptr;// end of the last output
+    std::size_t out_have_ = 0;      // bytes kept before out_end_
+
     // for string and stored block copying
     unsigned length_;               // literal or length of data to copy
     unsigned offset_;               // distance back to copy string from
@@ -225,16 +277,14 @@ private:
     unsigned nlen_;                 // number of length code lengths
     unsigned ndist_;                // number of distance code lengths
     unsigned have_;                 // number of code lengths in lens[]
-    unsigned short lens_[320];      // temporary storage for code lengths
-    unsigned short work_[288];      // work area for code table building
-    code codes_[kEnough];           // space for code tables
-    code *next_ = codes_;           // next available space in codes[]
+    std::unique_ptr<tables> tables_;// allocated by the first dynamic block
+    code *next_ = nullptr;          // next available space in codes[]
     int back_ = -1;                 // bits back of last unprocessed length/lit
     unsigned was_;                  // initial length of match
 
     // fixed and dynamic code tables
-    code const* lencode_ = codes_   ; // starting table for length/literal codes
-    code const* distcode_ = codes_; // starting table for distance codes
+    code const* lencode_ = nullptr; // starting table for length/literal codes
+    code const* distcode_ = nullptr;// starting table for distance codes
     unsigned lenbits_;              // index bits for lencode
     unsigned distbits_;             // index bits for distcode
 };
@@ -38,8 +38,10 @@
 #define BOOST_BEAST_ZLIB_DETAIL_INFLATE_STREAM_IPP
 
 #include <boost/beast/zlib/detail/inflate_stream.hpp>
+#include <boost/make_unique.hpp>
 #include <boost/throw_exception.hpp>
 #include <array>
+#include <cstring>
 
 namespace boost {
 namespace beast {
@@ -50,6 +52,16 @@ void
 inflate_stream::
 doClear()
 {
+    doReset();
+}
+
+void
+inflate_stream::
+doShrink()
+{
+    w_.clear();
+    tables_.reset();
+    doReset();
 }
 
 void
@@ -65,10 +77,51 @@ doReset(int windowBits)
     mode_ = HEAD;
     last_ = 0;
     dmax_ = 32768U;
-    lencode_ = codes_;
-    distcode_ = codes_;
-    next_ = codes_;
+    lencode_ = nullptr;
+    distcode_ = nullptr;
+    next_ = nullptr;
     back_ = -1;
+    out_end_ = nullptr;
+    out_have_ = 0;
+}
+
+void
+inflate_stream::
+doDictionary(std::uint8_t const* dict, std::size_t size, error_code& ec)
+{
+    // The window may only change between blocks
+    if(mode_ != HEAD && mode_ != TYPE && mode_ != TYPEDO)
+    {
+        ec = error::stream_error;
+        return;
+    }
+    // The dictionary comes after any output kept in place
+    keep_output();
+    // Matches reach into the dictionary through the window
+    w_.write(dict, size);
+}
+
+void
+inflate_stream::
+doInPlace(bool value)
+{
+    if(! value)
+        keep_output();
+    in_place_ = value;
+}
+
+/*  Copy the most recent output kept in place into the window, so
+    that it no longer needs to stay in the caller's buffer.
+*/
+void
+inflate_stream::
+keep_output()
+{
+    if(out_have_ == 0)
+        return;
+    auto const n = clamp(out_have_, w_.capacity());
+    w_.write(out_end_ - n, n);
+    out_have_ = 0;
 }
 
 void
@@ -84,6 +137,15 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
         std::uint8_t*>(zs.next_out);
     r.out.last = r.out.first + zs.avail_out;
     r.out.next = r.out.first;
+    auto const out = r.out.first;
+    if(in_place_)
+    {
+        // Output kept in place counts as used, so that
+        // back-references resolve against it directly.
+        if(out != out_end_)
+            keep_output();
+        r.out.first -= out_have_;
+    }
 
     auto const done =
         [&]
@@ -96,22 +158,29 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
              */
 
 
+            auto const written =
+                static_cast<std::size_t>(r.out.next - out);
+            if(in_place_)
+            {
+                out_end_ = r.out.next;
+                out_have_ = r.out.used();
+            }
             // VFALCO TODO Don't allocate update the window unless necessary
-            if(/*wsize_ ||*/ (r.out.used() && mode_ < BAD &&
+            else if(/*wsize_ ||*/ (written && mode_ < BAD &&
                     (mode_ < CHECK || flush != Flush::finish)))
-                w_.write(r.out.first, r.out.used());
+                w_.write(out, written);
 
             zs.next_in = r.in.next;
             zs.avail_in = r.in.avail();
             zs.next_out = r.out.next;
             zs.avail_out = r.out.avail();
             zs.total_in += r.in.used();
-            zs.total_out += r.out.used();
+            zs.total_out += written;
             zs.data_type = bi_.size() + (last_ ? 64 : 0) +
                 (mode_ == TYPE ? 128 : 0) +
                 (mode_ == LEN_ || mode_ == COPY_ ? 256 : 0);
 
-            if(((! r.in.used() && ! r.out.used()) ||
+            if(((! r.in.used() && ! written) ||
                     flush == Flush::finish) && ! ec)
                 ec = error::need_buffers;
         };
@@ -229,6 +298,8 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
             ncode_ += 4;
             if(nlen_ > 286 || ndist_ > 30)
                 return err(error::too_many_symbols);
+            if(! tables_)
+                tables_ = boost::make_unique_noinit<tables>();
             have_ = 0;
             mode_ = LENLENS;
             BOOST_FALLTHROUGH;
@@ -241,17 +312,17 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
             {
                 if(! bi_.fill(3, r.in.next, r.in.last))
                     return done();
-                bi_.read(lens_[order[have_]], 3);
+                bi_.read(tables_->lens[order[have_]], 3);
                 ++have_;
             }
             while(have_ < order.size())
-                lens_[order[have_++]] = 0;
+                tables_->lens[order[have_++]] = 0;
 
-            next_ = &codes_[0];
+            next_ = &tables_->codes[0];
             lencode_ = next_;
             lenbits_ = 7;
-            inflate_table(build::codes, &lens_[0],
-                order.size(), &next_, &lenbits_, work_, ec);
+            inflate_table(build::codes, &tables_->lens[0],
+                order.size(), &next_, &lenbits_, tables_->work, ec);
             if(ec)
             {
                 mode_ = BAD;
@@ -274,7 +345,7 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
                 if(cp->val < 16)
                 {
                     bi_.drop(cp->bits);
-                    lens_[have_++] = cp->val;
+                    tables_->lens[have_++] = cp->val;
                 }
                 else
                 {
@@ -288,7 +359,7 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
                         if(have_ == 0)
                             return err(error::invalid_bit_length_repeat);
                         bi_.read(copy, 2);
-                        len = lens_[have_ - 1];
+                        len = tables_->lens[have_ - 1];
                         copy += 3;
 
                     }
@@ -312,7 +383,7 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
                     }
                     if(have_ + copy > nlen_ + ndist_)
                         return err(error::invalid_bit_length_repeat);
-                    std::fill(&lens_[have_], &lens_[have_ + copy], len);
+                    std::fill(&tables_->lens[have_], &tables_->lens[have_ + copy], len);
                     have_ += copy;
                     copy = 0;
                 }
@@ -321,16 +392,16 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
             if(mode_ == BAD)
                 break;
             // check for end-of-block code (better have one)
-            if(lens_[256] == 0)
+            if(tables_->lens[256] == 0)
                 return err(error::missing_eob);
             /* build code tables -- note: do not change the lenbits or distbits
                values here (9 and 6) without reading the comments in inftrees.hpp
                concerning the kEnough constants, which depend on those values */
-            next_ = &codes_[0];
+            next_ = &tables_->codes[0];
             lencode_ = next_;
             lenbits_ = 9;
-            inflate_table(build::lens, &lens_[0],
-                nlen_, &next_, &lenbits_, work_, ec);
+            inflate_table(build::lens, &tables_->lens[0],
+                nlen_, &next_, &lenbits_, tables_->work, ec);
             if(ec)
             {
                 mode_ = BAD;
@@ -338,8 +409,8 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
             }
             distcode_ = next_;
             distbits_ = 6;
-            inflate_table(build::dists, lens_ + nlen_,
-                ndist_, &next_, &distbits_, work_, ec);
+            inflate_table(build::dists, tables_->lens + nlen_,
+                ndist_, &next_, &distbits_, tables_->work, ec);
             if(ec)
             {
                 mode_ = BAD;
@@ -357,7 +428,7 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
 
         case LEN:
         {
-            if(r.in.avail() >= 6 && r.out.avail() >= 258)
+            if(r.in.avail() >= kFastIn && r.out.avail() >= kFastOut)
             {
                 inflate_fast(r, ec);
                 if(ec)
@@ -369,27 +440,10 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
                     back_ = -1;
                 break;
             }
-            if(! bi_.fill(lenbits_, r.in.next, r.in.last))
-                return done();
-            std::uint16_t v;
             back_ = 0;
-            bi_.peek(v, lenbits_);
-            auto cp = &lencode_[v];
-            if(cp->op && (cp->op & 0xf0) == 0)
-            {
-                auto prev = cp;
-                if(! bi_.fill(prev->bits + prev->op, r.in.next, r.in.last))
-                    return done();
-                bi_.peek(v, prev->bits + prev->op);
-                cp = &lencode_[prev->val + (v >> prev->bits)];
-                bi_.drop(prev->bits + cp->bits);
-                back_ += prev->bits + cp->bits;
-            }
-            else
-            {
-                bi_.drop(cp->bits);
-                back_ += cp->bits;
-            }
+            auto const cp = decode(lencode_, lenbits_, r);
+            if(! cp)
+                return done();
             length_ = cp->val;
             if(cp->op == 0)
             {
@@ -425,26 +479,9 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
 
         case DIST:
         {
-            if(! bi_.fill(distbits_, r.in.next, r.in.last))
+            auto const cp = decode(distcode_, distbits_, r);
+            if(! cp)
                 return done();
-            std::uint16_t v;
-            bi_.peek(v, distbits_);
-            auto cp = &distcode_[v];
-            if((cp->op & 0xf0) == 0)
-            {
-                auto prev = cp;
-                if(! bi_.fill(prev->bits + prev->op, r.in.next, r.in.last))
-                    return done();
-                bi_.peek(v, prev->bits + prev->op);
-                cp = &distcode_[prev->val + (v >> prev->bits)];
-                bi_.drop(prev->bits + cp->bits);
-                back_ += prev->bits + cp->bits;
-            }
-            else
-            {
-                bi_.drop(cp->bits);
-                back_ += cp->bits;
-            }
             if(cp->op & 64)
                 return err(error::invalid_distance_code);
             offset_ = cp->val;
@@ -563,6 +600,7 @@ inflate_table(
     unsigned drop;                  // code bits to drop for sub-table
     int left;                       // number of prefix codes available
     unsigned used;                  // code entries in table used
+    unsigned size;                  // root table entries made so far
     unsigned huff;                  // Huffman code
     unsigned incr;                  // for incrementing code, index
     unsigned fill;                  // index for replicating entries
@@ -629,11 +667,20 @@ inflate_table(
        decoding tables.
      */
 
-    /* accumulate lengths for codes (assumes lens[] all in 0..15) */
+    /* accumulate lengths for codes (assumes lens[] all in 0..15), with
+       odd symbols counted in offs[] for now, since runs of equal lengths
+       would otherwise wait on each other's increments */
     for (len = 0; len <= 15; len++)
-        count[len] = 0;
-    for (sym = 0; sym < codes; sym++)
+        count[len] = offs[len] = 0;
+    for (sym = 0; sym + 1 < codes; sym += 2)
+    {
+        count[lens[sym]]++;
+        offs[lens[sym + 1]]++;
+    }
+    if (sym < codes)
         count[lens[sym]]++;
+    for (len = 0; len <= 15; len++)
+        count[len] += offs[len];
 
     /* bound code lengths, force root to be within code lengths */
     root = *bits;
@@ -746,6 +793,7 @@ inflate_table(
     drop = 0;                   /* current bits to drop from code for index */
     low = (unsigned)(-1);       /* trigger new sub-table when len > root */
     used = 1U << root;          /* use root table entries */
+    size = 1U << min;           /* root table entries made so far */
     mask = used - 1;            /* mask for comparing low */
 
     auto const not_enough = []
@@ -784,7 +832,13 @@ inflate_table(
         incr = 1U << (len - drop);
         fill = 1U << curr;
         min = fill;                 /* save offset to next table */
-        do
+        if (drop == 0)
+        {
+            /* the root table so far holds 1 << len entries, and is
+               replicated by doubling it when len increases below */
+            next[huff] = here;
+        }
+        else do
         {
             fill -= incr;
             next[(huff >> drop) + fill] = here;
@@ -808,6 +862,13 @@ inflate_table(
         {
             if (len == max) break;
             len = lens[work[sym]];
+
+            /* grow the root table to the new length, or to all of it
+               before sub-tables are made, in one copy per extra bit */
+            if (drop == 0)
+                for (fill = 1U << (len < root ? len : root);
+                        size < fill; size <<= 1)
+                    std::memcpy(next + size, next, size * sizeof(code));
         }
 
         /* create new sub-table if needed */
@@ -865,54 +926,110 @@ inflate_stream::
 get_fixed_tables() ->
     codes const&
 {
-    struct fixed_codes : codes
-    {
-        code len_[512];
-        code dist_[32];
-
-        fixed_codes()
-        {
-            lencode = len_;
-            lenbits = 9;
-            distcode = dist_;
-            distbits = 5;
-
-            std::uint16_t lens[320];
-            std::uint16_t work[288];
-
-            std::fill(&lens[  0], &lens[144], std::uint16_t{8});
-            std::fill(&lens[144], &lens[256], std::uint16_t{9});
-            std::fill(&lens[256], &lens[280], std::uint16_t{7});
-            std::fill(&lens[280], &lens[288], std::uint16_t{8});
-
-            {
-                error_code ec;
-                auto next = &len_[0];
-                inflate_table(build::lens,
-                    lens, 288, &next, &lenbits, work, ec);
-                if(ec)
-                    BOOST_THROW_EXCEPTION(std::logic_error{ec.message()});
-            }
-
-            // VFALCO These fixups are from ZLib
-            len_[ 99].op = 64;
-            len_[227].op = 64;
-            len_[355].op = 64;
-            len_[483].op = 64;
+    /*  The tables inflate_table() makes from the fixed code lengths
+        of RFC1951 section 3.2.6, with zlib's fixups marking the
+        unused length symbols 286 and 287 as invalid. Being constant
+        initialized, no fixed block ever waits on building them.
+    */
+    static code constexpr lenfix[512] = {
+        {96,7,0}, {0,8,80}, {0,8,16}, {20,8,115}, {18,7,31}, {0,8,112},
+        {0,8,48}, {0,9,192}, {16,7,10}, {0,8,96}, {0,8,32}, {0,9,160},
+        {0,8,0}, {0,8,128}, {0,8,64}, {0,9,224}, {16,7,6}, {0,8,88},
+        {0,8,24}, {0,9,144}, {19,7,59}, {0,8,120}, {0,8,56}, {0,9,208},
+        {17,7,17}, {0,8,104}, {0,8,40}, {0,9,176}, {0,8,8}, {0,8,136},
+        {0,8,72}, {0,9,240}, {16,7,4}, {0,8,84}, {0,8,20}, {21,8,227},
+        {19,7,43}, {0,8,116}, {0,8,52}, {0,9,200}, {17,7,13}, {0,8,100},
+        {0,8,36}, {0,9,168}, {0,8,4}, {0,8,132}, {0,8,68}, {0,9,232},
+        {16,7,8}, {0,8,92}, {0,8,28}, {0,9,152}, {20,7,83}, {0,8,124},
+        {0,8,60}, {0,9,216}, {18,7,23}, {0,8,108}, {0,8,44}, {0,9,184},
+        {0,8,12}, {0,8,140}, {0,8,76}, {0,9,248}, {16,7,3}, {0,8,82},
+        {0,8,18}, {21,8,163}, {19,7,35}, {0,8,114}, {0,8,50}, {0,9,196},
+        {17,7,11}, {0,8,98}, {0,8,34}, {0,9,164}, {0,8,2}, {0,8,130},
+        {0,8,66}, {0,9,228}, {16,7,7}, {0,8,90}, {0,8,26}, {0,9,148},
+        {20,7,67}, {0,8,122}, {0,8,58}, {0,9,212}, {18,7,19}, {0,8,106},
+        {0,8,42}, {0,9,180}, {0,8,10}, {0,8,138}, {0,8,74}, {0,9,244},
+        {16,7,5}, {0,8,86}, {0,8,22}, {64,8,0}, {19,7,51}, {0,8,118},
+        {0,8,54}, {0,9,204}, {17,7,15}, {0,8,102}, {0,8,38}, {0,9,172},
+        {0,8,6}, {0,8,134}, {0,8,70}, {0,9,236}, {16,7,9}, {0,8,94},
+        {0,8,30}, {0,9,156}, {20,7,99}, {0,8,126}, {0,8,62}, {0,9,220},
+        {18,7,27}, {0,8,110}, {0,8,46}, {0,9,188}, {0,8,14}, {0,8,142},
+        {0,8,78}, {0,9,252}, {96,7,0}, {0,8,81}, {0,8,17}, {21,8,131},
+        {18,7,31}, {0,8,113}, {0,8,49}, {0,9,194}, {16,7,10}, {0,8,97},
+        {0,8,33}, {0,9,162}, {0,8,1}, {0,8,129}, {0,8,65}, {0,9,226},
+        {16,7,6}, {0,8,89}, {0,8,25}, {0,9,146}, {19,7,59}, {0,8,121},
+        {0,8,57}, {0,9,210}, {17,7,17}, {0,8,105}, {0,8,41}, {0,9,178},
+        {0,8,9}, {0,8,137}, {0,8,73}, {0,9,242}, {16,7,4}, {0,8,85},
+        {0,8,21}, {16,8,258}, {19,7,43}, {0,8,117}, {0,8,53}, {0,9,202},
+        {17,7,13}, {0,8,101}, {0,8,37}, {0,9,170}, {0,8,5}, {0,8,133},
+        {0,8,69}, {0,9,234}, {16,7,8}, {0,8,93}, {0,8,29}, {0,9,154},
+        {20,7,83}, {0,8,125}, {0,8,61}, {0,9,218}, {18,7,23}, {0,8,109},
+        {0,8,45}, {0,9,186}, {0,8,13}, {0,8,141}, {0,8,77}, {0,9,250},
+        {16,7,3}, {0,8,83}, {0,8,19}, {21,8,195}, {19,7,35}, {0,8,115},
+        {0,8,51}, {0,9,198}, {17,7,11}, {0,8,99}, {0,8,35}, {0,9,166},
+        {0,8,3}, {0,8,131}, {0,8,67}, {0,9,230}, {16,7,7}, {0,8,91},
+        {0,8,27}, {0,9,150}, {20,7,67}, {0,8,123}, {0,8,59}, {0,9,214},
+        {18,7,19}, {0,8,107}, {0,8,43}, {0,9,182}, {0,8,11}, {0,8,139},
+        {0,8,75}, {0,9,246}, {16,7,5}, {0,8,87}, {0,8,23}, {64,8,0},
+        {19,7,51}, {0,8,119}, {0,8,55}, {0,9,206}, {17,7,15}, {0,8,103},
+        {0,8,39}, {0,9,174}, {0,8,7}, {0,8,135}, {0,8,71}, {0,9,238},
+        {16,7,9}, {0,8,95}, {0,8,31}, {0,9,158}, {20,7,99}, {0,8,127},
+        {0,8,63}, {0,9,222}, {18,7,27}, {0,8,111}, {0,8,47}, {0,9,190},
+        {0,8,15}, {0,8,143}, {0,8,79}, {0,9,254}, {96,7,0}, {0,8,80},
+        {0,8,16}, {20,8,115}, {18,7,31}, {0,8,112}, {0,8,48}, {0,9,193},
+        {16,7,10}, {0,8,96}, {0,8,32}, {0,9,161}, {0,8,0}, {0,8,128},
+        {0,8,64}, {0,9,225}, {16,7,6}, {0,8,88}, {0,8,24}, {0,9,145},
+        {19,7,59}, {0,8,120}, {0,8,56}, {0,9,209}, {17,7,17}, {0,8,104},
+        {0,8,40}, {0,9,177}, {0,8,8}, {0,8,136}, {0,8,72}, {0,9,241},
+        {16,7,4}, {0,8,84}, {0,8,20}, {21,8,227}, {19,7,43}, {0,8,116},
+        {0,8,52}, {0,9,201}, {17,7,13}, {0,8,100}, {0,8,36}, {0,9,169},
+        {0,8,4}, {0,8,132}, {0,8,68}, {0,9,233}, {16,7,8}, {0,8,92},
+        {0,8,28}, {0,9,153}, {20,7,83}, {0,8,124}, {0,8,60}, {0,9,217},
+        {18,7,23}, {0,8,108}, {0,8,44}, {0,9,185}, {0,8,12}, {0,8,140},
+        {0,8,76}, {0,9,249}, {16,7,3}, {0,8,82}, {0,8,18}, {21,8,163},
+        {19,7,35}, {0,8,114}, {0,8,50}, {0,9,197}, {17,7,11}, {0,8,98},
+        {0,8,34}, {0,9,165}, {0,8,2}, {0,8,130}, {0,8,66}, {0,9,229},
+        {16,7,7}, {0,8,90}, {0,8,26}, {0,9,149}, {20,7,67}, {0,8,122},
+        {0,8,58}, {0,9,213}, {18,7,19}, {0,8,106}, {0,8,42}, {0,9,181},
+        {0,8,10}, {0,8,138}, {0,8,74}, {0,9,245}, {16,7,5}, {0,8,86},
+        {0,8,22}, {64,8,0}, {19,7,51}, {0,8,118}, {0,8,54}, {0,9,205},
+        {17,7,15}, {0,8,102}, {0,8,38}, {0,9,173}, {0,8,6}, {0,8,134},
+        {0,8,70}, {0,9,237}, {16,7,9}, {0,8,94}, {0,8,30}, {0,9,157},
+        {20,7,99}, {0,8,126}, {0,8,62}, {0,9,221}, {18,7,27}, {0,8,110},
+        {0,8,46}, {0,9,189}, {0,8,14}, {0,8,142}, {0,8,78}, {0,9,253},
+        {96,7,0}, {0,8,81}, {0,8,17}, {21,8,131}, {18,7,31}, {0,8,113},
+        {0,8,49}, {0,9,195}, {16,7,10}, {0,8,97}, {0,8,33}, {0,9,163},
+        {0,8,1}, {0,8,129}, {0,8,65}, {0,9,227}, {16,7,6}, {0,8,89},
+        {0,8,25}, {0,9,147}, {19,7,59}, {0,8,121}, {0,8,57}, {0,9,211},
+        {17,7,17}, {0,8,105}, {0,8,41}, {0,9,179}, {0,8,9}, {0,8,137},
+        {0,8,73}, {0,9,243}, {16,7,4}, {0,8,85}, {0,8,21}, {16,8,258},
+        {19,7,43}, {0,8,117}, {0,8,53}, {0,9,203}, {17,7,13}, {0,8,101},
+        {0,8,37}, {0,9,171}, {0,8,5}, {0,8,133}, {0,8,69}, {0,9,235},
+        {16,7,8}, {0,8,93}, {0,8,29}, {0,9,155}, {20,7,83}, {0,8,125},
+        {0,8,61}, {0,9,219}, {18,7,23}, {0,8,109}, {0,8,45}, {0,9,187},
+        {0,8,13}, {0,8,141}, {0,8,77}, {0,9,251}, {16,7,3}, {0,8,83},
+        {0,8,19}, {21,8,195}, {19,7,35}, {0,8,115}, {0,8,51}, {0,9,199},
+        {17,7,11}, {0,8,99}, {0,8,35}, {0,9,167}, {0,8,3}, {0,8,131},
+        {0,8,67}, {0,9,231}, {16,7,7}, {0,8,91}, {0,8,27}, {0,9,151},
+        {20,7,67}, {0,8,123}, {0,8,59}, {0,9,215}, {18,7,19}, {0,8,107},
+        {0,8,43}, {0,9,183}, {0,8,11}, {0,8,139}, {0,8,75}, {0,9,247},
+        {16,7,5}, {0,8,87}, {0,8,23}, {64,8,0}, {19,7,51}, {0,8,119},
+        {0,8,55}, {0,9,207}, {17,7,15}, {0,8,103}, {0,8,39}, {0,9,175},
+        {0,8,7}, {0,8,135}, {0,8,71}, {0,9,239}, {16,7,9}, {0,8,95},
+        {0,8,31}, {0,9,159}, {20,7,99}, {0,8,127}, {0,8,63}, {0,9,223},
+        {18,7,27}, {0,8,111}, {0,8,47}, {0,9,191}, {0,8,15}, {0,8,143},
+        {0,8,79}, {0,9,255}
+    };
 
-            {
-                error_code ec;
-                auto next = &dist_[0];
-                std::fill(&lens[0], &lens[32], std::uint16_t{5});
-                inflate_table(build::dists,
-                    lens, 32, &next, &distbits, work, ec);
-                if(ec)
-                    BOOST_THROW_EXCEPTION(std::logic_error{ec.message()});
-            }
-        }
+    static code constexpr distfix[32] = {
+        {16,5,1}, {23,5,257}, {19,5,17}, {27,5,4097}, {17,5,5}, {25,5,1025},
+        {21,5,65}, {29,5,16385}, {16,5,3}, {24,5,513}, {20,5,33},
+        {28,5,8193}, {18,5,9}, {26,5,2049}, {22,5,129}, {64,5,0}, {16,5,2},
+        {23,5,385}, {19,5,25}, {27,5,6145}, {17,5,7}, {25,5,1537},
+        {21,5,97}, {29,5,24577}, {16,5,4}, {24,5,769}, {20,5,49},
+        {28,5,12289}, {18,5,13}, {26,5,3073}, {22,5,193}, {64,5,0}
     };
 
-    static fixed_codes const fc;
+    static codes constexpr fc = { lenfix, distfix, 9, 5 };
     return fc;
 }
 
@@ -920,13 +1037,51 @@ void
 inflate_stream::
 fixedTables()
 {
-    auto const fc = get_fixed_tables();
+    auto const& fc = get_fixed_tables();
     lencode_ = fc.lencode;
     lenbits_ = fc.lenbits;
     distcode_ = fc.distcode;
     distbits_ = fc.distbits;
 }
 
+/*  Decode the next length or distance code from a table with root
+    index bits, and consume it.
+
+    As in zlib, only as many bits as the code turns out to have are
+    required: at the end of the stream the last codes may be shorter
+    than the root index. Bits past the end of the reservoir are never
+    part of the code found, however they happen to be set. Returns
+    nullptr, having consumed nothing, if more input is needed.
+*/
+auto
+inflate_stream::
+decode(code const* table, unsigned root, ranges& r) ->
+    code const*
+{
+    bi_.fill(root, r.in.next, r.in.last);
+    auto v = static_cast<unsigned>(bi_.peek_fast());
+    auto cp = &table[v & ((1U << root) - 1)];
+    if(cp->op && (cp->op & 0xf0) == 0)
+    {
+        auto const prev = cp;
+        unsigned const n = prev->bits + prev->op;
+        bi_.fill(n, r.in.next, r.in.last);
+        v = static_cast<unsigned>(bi_.peek_fast());
+        cp = &table[prev->val +
+            ((v & ((1U << n) - 1)) >> prev->bits)];
+        if(prev->bits + cp->bits > bi_.size())
+            return nullptr;
+        bi_.drop(prev->bits + cp->bits);
+        back_ += prev->bits + cp->bits;
+        return cp;
+    }
+    if(cp->bits > bi_.size())
+        return nullptr;
+    bi_.drop(cp->bits);
+    back_ += cp->bits;
+    return cp;
+}
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -938,10 +1093,8 @@ fixedTables()
    Entry assumptions:
 
         state->mode_ == LEN
-        zs.avail_in >= 6
-        zs.avail_out >= 258
-        start >= zs.avail_out
-        state->bits_ < 8
+        zs.avail_in >= kFastIn
+        zs.avail_out >= kFastOut
 
    On return, state->mode_ is one of:
 
@@ -951,35 +1104,30 @@ fixedTables()
 
    Notes:
 
-    - The maximum input bits used by a length/distance pair is 15 bits for the
-      length code, 5 bits for the length extra, 15 bits for the distance code,
-      and 13 bits for the distance extra.  This totals 48 bits, or six bytes.
-      Therefore if zs.avail_in >= 6, then there is enough input to avoid
-      checking for available input while decoding.
+    - The bit reservoir is refilled a word at a time and holds at least 56
+      bits afterwards. The maximum input bits used by a length/distance pair
+      is 15 bits for the length code, 5 bits for the length extra, 15 bits
+      for the distance code, and 13 bits for the distance extra.  This totals
+      48 bits, so a pair is decoded from a single refill. A literal in the
+      root table uses at most 9 bits, so up to three literals are decoded
+      before refilling again.
+
+    - A refill reads 8 bytes, and the reservoir holds at most 63 bits. An
+      iteration refills at most twice, the second time after using at most
+      27 bits for literals, so it reads no further than 19 bytes past where
+      it started. Therefore if zs.avail_in >= kFastIn at the top of the
+      loop, no refill reads past the end of the input.
 
     - The maximum bytes that a single length/distance pair can output is 258
-      bytes, which is the maximum length that can be coded.  inflate_fast()
-      requires zs.avail_out >= 258 for each loop to avoid checking for
-      output space.
-
-  inflate_fast() speedups that turned out slower (on a PowerPC G3 750CXe):
-   - Using bit fields for code structure
-   - Different op definition to avoid & for extra bits (do & for table bits)
-   - Three separate decoding do-loops for direct, window, and wnext == 0
-   - Special case for distance > 1 copies to do overlapped load and store copy
-   - Explicit branch predictions (based on measured branch probabilities)
-   - Deferring match copy and interspersed it with decoding subsequent codes
-   - Swapping literal/length else
-   - Swapping window/direct else
-   - Larger unrolled copy loops (three is about right)
-   - Moving len -= 3 statement into middle of loop
+      bytes, which is the maximum length that can be coded. Matches are
+      copied in chunks of up to 16 bytes which may overrun the match by up
+      to 15 bytes, and two literals may precede the pair. kFastOut covers
+      all of this, so no output space checks are needed inside the loop.
  */
 void
 inflate_stream::
 inflate_fast(ranges& r, error_code& ec)
 {
-    unsigned char const* last;  // have enough input while in < last
-    unsigned char *end;         // while out < end, enough space available
     std::size_t op;             // code bits, operation, extra bits, or window position, window bytes to copy
     unsigned len;               // match length, unused bytes
     unsigned dist;              // match distance
@@ -988,38 +1136,48 @@ inflate_fast(ranges& r, error_code& ec)
     unsigned const dmask =
         (1U << distbits_) - 1;  // mask for first level of distance codes
 
-    last = r.in.next + (r.in.avail() - 5);
-    end = r.out.next + (r.out.avail() - 257);
-
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do
     {
-        if(bi_.size() < 15)
-            bi_.fill_16(r.in.next);
+        bi_.refill(r.in.next);
         auto cp = &lencode_[bi_.peek_fast() & lmask];
+        if(cp->op == 0)
+        {
+            // literals
+            bi_.drop(cp->bits);
+            *r.out.next++ = static_cast<std::uint8_t>(cp->val);
+            cp = &lencode_[bi_.peek_fast() & lmask];
+            if(cp->op == 0)
+            {
+                bi_.drop(cp->bits);
+                *r.out.next++ = static_cast<std::uint8_t>(cp->val);
+                cp = &lencode_[bi_.peek_fast() & lmask];
+                if(cp->op == 0)
+                {
+                    bi_.drop(cp->bits);
+                    *r.out.next++ = static_cast<std::uint8_t>(cp->val);
+                    continue;
+                }
+            }
+            // leaves the bits cp was looked up with in place
+            bi_.refill(r.in.next);
+        }
     dolen:
         bi_.drop(cp->bits);
         op = (unsigned)(cp->op);
         if(op == 0)
         {
-            // literal
-            *r.out.next++ = (unsigned char)(cp->val);
+            // literal from a 2nd level table
+            *r.out.next++ = static_cast<std::uint8_t>(cp->val);
         }
         else if(op & 16)
         {
             // length base
             len = (unsigned)(cp->val);
             op &= 15; // number of extra bits
-            if(op)
-            {
-                if(bi_.size() < op)
-                    bi_.fill_8(r.in.next);
-                len += (unsigned)bi_.peek_fast() & ((1U << op) - 1);
-                bi_.drop(op);
-            }
-            if(bi_.size() < 15)
-                bi_.fill_16(r.in.next);
+            len += (unsigned)bi_.peek_fast() & ((1U << op) - 1);
+            bi_.drop(op);
             cp = &distcode_[bi_.peek_fast() & dmask];
         dodist:
             bi_.drop(cp->bits);
@@ -1029,12 +1187,6 @@ inflate_fast(ranges& r, error_code& ec)
                 // distance base
                 dist = (unsigned)(cp->val);
                 op &= 15; // number of extra bits
-                if(bi_.size() < op)
-                {
-                    bi_.fill_8(r.in.next);
-                    if(bi_.size() < op)
-                        bi_.fill_8(r.in.next);
-                }
                 dist += (unsigned)bi_.peek_fast() & ((1U << op) - 1);
 #ifdef INFLATE_STRICT
                 if(dist > dmax_)
@@ -1065,11 +1217,8 @@ inflate_fast(ranges& r, error_code& ec)
                 if(len > 0)
                 {
                     // copy from output
-                    auto in = r.out.next - dist;
-                    auto n = clamp(len, r.out.avail());
-                    len -= n;
-                    while(n--)
-                        *r.out.next++ = *in++;
+                    copy_match(r.out.next, dist, len);
+                    r.out.next += len;
                 }
             }
             else if((op & 64) == 0)
@@ -1104,12 +1253,61 @@ inflate_fast(ranges& r, error_code& ec)
             break;
         }
     }
-    while(r.in.next < last && r.out.next < end);
+    while(r.in.avail() >= kFastIn && r.out.avail() >= kFastOut);
 
-    // return unused bytes (on entry, bits < 8, so in won't go too far back)
+    // return unused bytes
     bi_.rewind(r.in.next);
 }
 
+/*
+    Copy len bytes starting dist bytes back from out. When the source
+    and destination are at least a chunk apart, whole chunks are copied
+    and the last one may write up to 15 bytes past out + len. A closer
+    source repeats with a period of dist, so after the first 8 bytes
+    are copied singly it can step back whole periods to a chunk away.
+*/
+void
+inflate_stream::
+copy_match(std::uint8_t* out, unsigned dist, unsigned len)
+{
+    auto const end = out + len;
+    auto in = out - dist;
+    if(dist == 1)
+    {
+        std::memset(out, *in, len);
+        return;
+    }
+    if(dist < 8)
+    {
+        // Once 8 bytes are written the pattern
+        // repeats and in can step back to out - 8k
+        auto const n = len < 8 ? len : 8;
+        for(unsigned i = 0; i < n; ++i)
+            *out++ = *in++;
+        if(out >= end)
+            return;
+        in = out - ((8 + dist - 1) / dist) * dist;
+    }
+    if(out - in >= 16)
+    {
+        do
+        {
+            std::memcpy(out, in, 16);
+            out += 16;
+            in += 16;
+        }
+        while(out < end);
+        return;
+    }
+    do
+    {
+        std::memcpy(out, in, 8);
+        out += 8;
+        in += 8;
+    }
+    while(out < end);
+}
+
 } // detail
 } // zlib
 } // beast
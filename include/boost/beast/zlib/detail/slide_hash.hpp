@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_SLIDE_HASH_HPP
+#define BOOST_BEAST_ZLIB_DETAIL_SLIDE_HASH_HPP
+
+#include <boost/beast/core/detail/cpu_info.hpp>
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#if BOOST_BEAST_CPU_DISPATCH
+# include <immintrin.h> // _mm256_subs_epu16
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define BOOST_BEAST_ZLIB_SLIDE_SSE2
+# include <emmintrin.h> // _mm_subs_epu16
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define BOOST_BEAST_ZLIB_SLIDE_NEON
+# include <arm_neon.h>  // vqsubq_u16
+#endif
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+#if BOOST_BEAST_CPU_DISPATCH
+#if defined(BOOST_GCC) || defined(BOOST_CLANG)
+__attribute__((target("avx2")))
+#endif
+inline
+void
+slide_hash_avx2(
+    std::uint16_t* p, std::size_t n, std::uint16_t wsize)
+{
+    auto const w = _mm256_set1_epi16(static_cast<short>(wsize));
+    for(auto const end = p + n; p != end; p += 16)
+    {
+        auto const v = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(p));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+            _mm256_subs_epu16(v, w));
+    }
+}
+#endif
+
+/*  Subtract wsize from each of the n hash chain entries at p,
+    saturating at zero, when deflate slides its window.
+
+    This runs on every window advance over the whole head and prev
+    tables, so it uses a saturating subtract 8 or 16 entries at a
+    time: AVX2 when cpu_info reports it at runtime, else SSE2 or NEON
+    when the target guarantees them. n must be a multiple of 16,
+    which holds for every table size deflate_stream uses.
+*/
+inline
+void
+slide_hash(std::uint16_t* p, std::size_t n, std::uint16_t wsize)
+{
+    BOOST_ASSERT(n % 16 == 0);
+#if BOOST_BEAST_CPU_DISPATCH
+    if(beast::detail::get_cpu_info().avx2)
+        return slide_hash_avx2(p, n, wsize);
+#endif
+#if defined(BOOST_BEAST_ZLIB_SLIDE_SSE2)
+    auto const w = _mm_set1_epi16(static_cast<short>(wsize));
+    for(auto const end = p + n; p != end; p += 8)
+    {
+        auto const v = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+            _mm_subs_epu16(v, w));
+    }
+#elif defined(BOOST_BEAST_ZLIB_SLIDE_NEON)
+    auto const w = vdupq_n_u16(wsize);
+    for(auto const end = p + n; p != end; p += 8)
+        vst1q_u16(p, vqsubq_u16(vld1q_u16(p), w));
+#else
+    for(auto const end = p + n; p != end; ++p)
+        *p = static_cast<std::uint16_t>(
+            *p >= wsize ? *p - wsize : 0);
+#endif
+}
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
@@ -75,6 +75,13 @@ public:
         return size_;
     }
 
+    // bytes of memory held, zero until the first write
+    std::size_t
+    allocated() const
+    {
+        return p_ ? capacity_ : 0;
+    }
+
     void
     reset(int bits)
     {
@@ -88,6 +95,15 @@ public:
         size_ = 0;
     }
 
+    // release the memory, keeping the size
+    void
+    clear()
+    {
+        p_.reset();
+        i_ = 0;
+        size_ = 0;
+    }
+
     void
     read(std::uint8_t* out, std::size_t pos, std::size_t n)
     {
@@ -113,7 +129,7 @@ public:
     write(std::uint8_t const* in, std::size_t n)
     {
         if(! p_)
-            p_ = boost::make_unique<
+            p_ = boost::make_unique_noinit<
                 std::uint8_t[]>(capacity_);
         if(n >= capacity_)
         {
@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_IMPL_PARALLEL_DEFLATE_STREAM_IPP
+#define BOOST_BEAST_ZLIB_IMPL_PARALLEL_DEFLATE_STREAM_IPP
+
+#include <boost/beast/zlib/parallel_deflate_stream.hpp>
+#include <boost/beast/zlib/detail/deflate_stream.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/*  Compresses one block on a worker thread.
+
+    A fresh stream is primed with the dictionary and flushed at the
+    end of the block, so the output is a run of complete deflate blocks
+    ending on a byte boundary, which may be appended to the output of
+    the previous block as is. The stream's memory is reused from one
+    block to the next.
+*/
+class parallel_deflate_stream::compressor
+    : private detail::deflate_stream
+{
+public:
+    void
+    check(settings const& opts)
+    {
+        doReset(opts.level, opts.windowBits,
+            opts.memLevel, opts.strategy);
+    }
+
+    void
+    compress(job& j)
+    {
+        doReset(j.opts.level, j.opts.windowBits,
+            j.opts.memLevel, j.opts.strategy);
+        error_code ec;
+        if(j.dict_size > 0)
+        {
+            doDictionary(j.in.data(),
+                static_cast<uInt>(j.dict_size), ec);
+            BOOST_ASSERT(! ec);
+        }
+        z_params zs;
+        zs.next_in = j.in.data() + j.dict_size;
+        zs.avail_in = j.in.size() - j.dict_size;
+        // room for the block and the flush marker
+        j.out.resize(doUpperBound(zs.avail_in) + 8);
+        std::size_t n = 0;
+        for(;;)
+        {
+            zs.next_out = j.out.data() + n;
+            zs.avail_out = j.out.size() - n;
+            doWrite(zs, j.flush, ec);
+            n = j.out.size() - zs.avail_out;
+            if(ec == error::end_of_stream)
+                break;
+            if(ec && ec != error::need_buffers)
+                BOOST_THROW_EXCEPTION(system_error{ec});
+            if(zs.avail_out > 0 && j.flush != Flush::finish)
+                break;
+            j.out.resize(2 * j.out.size());
+        }
+        j.out.resize(n);
+    }
+};
+
+parallel_deflate_stream::
+parallel_deflate_stream(
+    unsigned threads,
+    std::size_t block_size)
+    : block_size_(block_size)
+    , opts_{6, 15, 8, Strategy::normal}
+{
+    if(block_size_ == 0)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid block_size"});
+    if(threads == 0)
+        threads = (std::max)(
+            std::thread::hardware_concurrency(), 1U);
+    threads_.reserve(threads);
+    try
+    {
+        while(threads--)
+            threads_.emplace_back(
+                &parallel_deflate_stream::run, this);
+    }
+    catch(...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_work_.notify_all();
+        for(auto& t : threads_)
+            t.join();
+        throw;
+    }
+}
+
+parallel_deflate_stream::
+~parallel_deflate_stream()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+        queue_.clear();
+    }
+    cv_work_.notify_all();
+    for(auto& t : threads_)
+        t.join();
+    threads_.clear();
+}
+
+void
+parallel_deflate_stream::
+reset(
+    int level,
+    int windowBits,
+    int memLevel,
+    Strategy strategy)
+{
+    settings const opts{level, windowBits, memLevel, strategy};
+    // Validate the settings the same way deflate_stream does
+    compressor{}.check(opts);
+    reset();
+    opts_ = opts;
+}
+
+void
+parallel_deflate_stream::
+reset()
+{
+    cancel();
+    block_.clear();
+    dict_size_ = 0;
+    finishing_ = false;
+}
+
+void
+parallel_deflate_stream::
+write(
+    z_params& zs,
+    Flush flush,
+    error_code& ec)
+{
+    if(zs.next_out == nullptr ||
+        (zs.next_in == nullptr && zs.avail_in != 0) ||
+        (finishing_ && flush != Flush::finish))
+    {
+        ec = error::stream_error;
+        return;
+    }
+
+    // Output already compressed goes out first
+    bool progress = deliver(zs, jobs_.size());
+
+    if(! finishing_)
+    {
+        auto const limit = 2 * threads_.size();
+        for(;;)
+        {
+            if(block_.size() - dict_size_ == block_size_)
+            {
+                if(jobs_.size() >= limit)
+                {
+                    // The oldest block's output must
+                    // go somewhere before we go on.
+                    if(zs.avail_out == 0)
+                        break;
+                    progress = deliver(zs, limit - 1) || progress;
+                    if(jobs_.size() >= limit)
+                        break;
+                }
+                submit(Flush::none);
+            }
+            if(zs.avail_in == 0)
+                break;
+            auto const n = (std::min)(zs.avail_in,
+                block_size_ - (block_.size() - dict_size_));
+            auto const p =
+                static_cast<std::uint8_t const*>(zs.next_in);
+            block_.insert(block_.end(), p, p + n);
+            zs.next_in = p + n;
+            zs.avail_in -= n;
+            zs.total_in += n;
+            progress = true;
+        }
+
+        // Flushing applies once all input is consumed
+        if(flush != Flush::none && zs.avail_in == 0)
+        {
+            if(flush == Flush::finish)
+            {
+                submit(Flush::finish);
+                finishing_ = true;
+                progress = true;
+            }
+            else if(block_.size() > dict_size_)
+            {
+                submit(flush);
+                progress = true;
+            }
+            else if(flush == Flush::full)
+            {
+                block_.clear();
+                dict_size_ = 0;
+            }
+        }
+    }
+
+    if(flush != Flush::none && zs.avail_in == 0)
+        progress = deliver(zs, 0) || progress;
+
+    if(finishing_ && jobs_.empty())
+        ec = error::end_of_stream;
+    else if(! progress)
+        ec = error::need_buffers;
+}
+
+void
+parallel_deflate_stream::
+run()
+{
+    compressor c;
+    std::unique_lock<std::mutex> lock(m_);
+    for(;;)
+    {
+        cv_work_.wait(lock,
+            [this]
+            {
+                return stop_ || ! queue_.empty();
+            });
+        if(stop_)
+            return;
+        auto const j = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        try
+        {
+            c.compress(*j);
+        }
+        catch(...)
+        {
+            j->ep = std::current_exception();
+        }
+        lock.lock();
+        j->done = true;
+        cv_done_.notify_all();
+    }
+}
+
+// Hand the current block to the workers,
+// and begin the next with its dictionary.
+void
+parallel_deflate_stream::
+submit(Flush flush)
+{
+    std::unique_ptr<job> j(new job);
+    j->opts = opts_;
+    j->flush = flush == Flush::finish ?
+        Flush::finish : Flush::sync;
+    j->dict_size = dict_size_;
+    j->in = std::move(block_);
+
+    block_ = {};
+    block_.reserve(
+        (std::size_t{1} << opts_.windowBits) + block_size_);
+    if(flush != Flush::full && flush != Flush::finish)
+    {
+        auto const n = (std::min)(j->in.size(),
+            std::size_t{1} << opts_.windowBits);
+        block_.assign(j->in.end() - n, j->in.end());
+    }
+    dict_size_ = block_.size();
+
+    auto const p = j.get();
+    jobs_.push_back(std::move(j));
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        queue_.push_back(p);
+    }
+    cv_work_.notify_one();
+}
+
+// Copy finished output in order, waiting while
+// more than `keep` blocks are outstanding.
+bool
+parallel_deflate_stream::
+deliver(z_params& zs, std::size_t keep)
+{
+    bool progress = false;
+    while(! jobs_.empty() && zs.avail_out > 0)
+    {
+        auto& j = *jobs_.front();
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            if(! j.done)
+            {
+                if(jobs_.size() <= keep)
+                    break;
+                cv_done_.wait(lock,
+                    [&j]
+                    {
+                        return j.done;
+                    });
+            }
+        }
+        if(j.ep)
+        {
+            auto const ep = j.ep;
+            jobs_.pop_front();
+            std::rethrow_exception(ep);
+        }
+        auto const n = (std::min)(
+            zs.avail_out, j.out.size() - j.out_pos);
+        if(n > 0)
+        {
+            std::memcpy(zs.next_out, j.out.data() + j.out_pos, n);
+            zs.next_out = static_cast<std::uint8_t*>(zs.next_out) + n;
+            zs.avail_out -= n;
+            zs.total_out += n;
+            j.out_pos += n;
+            progress = true;
+        }
+        if(j.out_pos == j.out.size())
+            jobs_.pop_front();
+    }
+    return progress;
+}
+
+// Abandon blocks not yet started
+// and wait for the rest.
+void
+parallel_deflate_stream::
+cancel()
+{
+    std::unique_lock<std::mutex> lock(m_);
+    for(auto j : queue_)
+        j->done = true;
+    queue_.clear();
+    cv_done_.wait(lock,
+        [this]
+        {
+            for(auto const& j : jobs_)
+                if(! j->done)
+                    return false;
+            return true;
+        });
+    lock.unlock();
+    jobs_.clear();
+}
+
+} // zlib
+} // beast
+} // boost
+
+#endif
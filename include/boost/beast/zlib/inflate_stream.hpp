@@ -96,7 +96,9 @@ public:
 
     /** Put the stream in a newly constructed state.
 
-        All dynamically allocated memory is de-allocated.
+        The window size is left unchanged. Memory already
+        allocated is kept for the next stream; call @ref shrink
+        to release it.
     */
     void
     clear()
@@ -104,6 +106,92 @@ public:
         doClear();
     }
 
+    /** Put the stream in a newly constructed state and release its memory.
+
+        All dynamically allocated memory is de-allocated. The
+        window size is left unchanged. This is meant for streams
+        which are expected to stay idle for a while; the memory
+        is allocated again when it is next needed.
+    */
+    void
+    shrink()
+    {
+        doShrink();
+    }
+
+    /** Returns the memory used by the stream, in bytes.
+
+        This is the size of the object plus the memory it has
+        allocated. The sliding window, sized by the window bits,
+        is allocated when output is first kept for later blocks,
+        and the space for decoding tables when the first block
+        with dynamic tables arrives. Both are kept by @ref reset
+        and @ref clear, and freed by @ref shrink.
+    */
+    std::size_t
+    memory_usage() const
+    {
+        return sizeof(*this) + doAllocated();
+    }
+
+    /** Initialize the decompression dictionary.
+
+        This function loads the same preset dictionary the compressor
+        was given with @ref deflate_stream::set_dictionary, so that
+        references into it can be resolved. Only the last window size
+        bytes of the dictionary are kept.
+
+        This function should be called after @ref reset and before the
+        first call to @ref write. It may also be called between
+        deflate blocks, such as after a flush, to follow a compressor
+        which started over from the dictionary.
+
+        @param dict A pointer to the dictionary.
+
+        @param size The size of the dictionary in bytes.
+
+        @param ec Set to `error::stream_error` if the stream is in
+        the middle of a deflate block.
+    */
+    void
+    set_dictionary(
+        void const* dict,
+        std::size_t size,
+        error_code& ec)
+    {
+        doDictionary(static_cast<
+            std::uint8_t const*>(dict), size, ec);
+    }
+
+    /** Set whether output is kept in place.
+
+        Normally each call to @ref write copies its most recent output
+        into the stream's sliding window, so that later output may
+        refer back to it. When this setting is `true`, the caller
+        instead promises to leave the output of each call in place
+        until the next call to @ref write, @ref set_dictionary or this
+        function. Back-references are then resolved directly against
+        the output buffer, and as long as each call continues at the
+        `zs.next_out` where the previous one stopped, nothing is copied
+        into the window, which need not be allocated at all. When a
+        call starts elsewhere, the output of the previous call is first
+        copied into the window.
+
+        This suits decompressing whole messages into one contiguous
+        buffer, as permessage-deflate without context takeover does.
+
+        Setting `false` copies the most recent output into the window,
+        after which the output buffer may be reused. The setting is
+        kept by @ref reset and @ref clear.
+
+        @param value `true` to keep output in place.
+    */
+    void
+    in_place(bool value)
+    {
+        doInPlace(value);
+    }
+
     /** Decompress input and produce output.
 
         This function decompresses as much data as possible, and stops when
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_PARALLEL_DEFLATE_STREAM_HPP
+#define BOOST_BEAST_ZLIB_PARALLEL_DEFLATE_STREAM_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/zlib/error.hpp>
+#include <boost/beast/zlib/zlib.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/** Raw deflate compressor which uses several threads.
+
+    This compresses large inputs faster than @ref deflate_stream by
+    splitting them into blocks which are compressed independently on
+    a set of worker threads owned by the object, in the manner of pigz.
+    Each block is primed with the window of input preceding it as a
+    preset dictionary, so matches may still reach back across block
+    boundaries, and each block but the last ends with a sync flush.
+    The concatenated output is a single standard raw deflate stream,
+    which any inflater can decompress.
+
+    Compared to @ref deflate_stream the output is slightly larger,
+    by the flush markers and the matches which the dictionary does
+    not allow for, and up to two blocks per thread of input are
+    buffered before output is produced. For bodies smaller than a
+    few blocks there is nothing to gain; use @ref deflate_stream.
+
+    The interface follows @ref deflate_stream::write, including the
+    meaning of the flush parameter. A write may block while waiting
+    for the workers: when the limit of blocks in flight is reached,
+    and when flushing.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+*/
+class parallel_deflate_stream
+{
+    struct settings
+    {
+        int level;
+        int windowBits;
+        int memLevel;
+        Strategy strategy;
+    };
+
+    struct job
+    {
+        settings opts;
+        std::vector<std::uint8_t> in;   // dictionary, then data
+        std::size_t dict_size = 0;
+        Flush flush;
+        std::vector<std::uint8_t> out;
+        std::size_t out_pos = 0;        // bytes delivered
+        std::exception_ptr ep;
+        bool done = false;
+    };
+
+    class compressor;
+
+    std::size_t block_size_;
+    settings opts_;
+
+    std::mutex m_;
+    std::condition_variable cv_work_;
+    std::condition_variable cv_done_;
+    std::deque<job*> queue_;                    // not started
+    std::deque<std::unique_ptr<job>> jobs_;     // in output order
+    std::vector<std::thread> threads_;
+    bool stop_ = false;
+
+    std::vector<std::uint8_t> block_;           // dictionary, then data
+    std::size_t dict_size_ = 0;
+    bool finishing_ = false;
+
+public:
+    /// The default number of input bytes per block
+    static std::size_t constexpr default_block_size = 128 * 1024;
+
+    /** Constructor
+
+        The compression settings are the defaults of
+        @ref deflate_stream.
+
+        @param threads The number of worker threads to start. If
+        this is zero, the number of hardware threads is used.
+
+        @param block_size The number of input bytes to compress as
+        a unit. Larger blocks lose less compression to the block
+        boundaries; smaller blocks spread shorter inputs over more
+        threads.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    parallel_deflate_stream(
+        unsigned threads = 0,
+        std::size_t block_size = default_block_size);
+
+    /** Destructor
+
+        Unfinished work is abandoned, and the worker
+        threads are joined.
+    */
+    BOOST_BEAST_DECL
+    ~parallel_deflate_stream();
+
+    parallel_deflate_stream(parallel_deflate_stream const&) = delete;
+    parallel_deflate_stream& operator=(parallel_deflate_stream const&) = delete;
+
+    /// Return the number of worker threads
+    std::size_t
+    threads() const noexcept
+    {
+        return threads_.size();
+    }
+
+    /** Reset the stream and compression settings.
+
+        The settings have the same meaning and limits as for
+        @ref deflate_stream::reset.
+
+        @note Any unprocessed input or pending output from
+        previous calls are discarded.
+
+        @throws std::invalid_argument if a setting is out of range.
+    */
+    BOOST_BEAST_DECL
+    void
+    reset(
+        int level,
+        int windowBits,
+        int memLevel,
+        Strategy strategy);
+
+    /** Reset the stream, keeping the compression settings.
+
+        @note Any unprocessed input or pending output from
+        previous calls are discarded.
+    */
+    BOOST_BEAST_DECL
+    void
+    reset();
+
+    /** Compress input and write output.
+
+        This behaves as @ref deflate_stream::write. `Flush::partial`
+        and `Flush::block` are treated as `Flush::sync`, since every
+        block ends on a byte boundary.
+
+        `error::need_buffers` is set when no progress was possible,
+        and `error::end_of_stream` once all output is delivered after
+        `Flush::finish`.
+    */
+    BOOST_BEAST_DECL
+    void
+    write(
+        z_params& zs,
+        Flush flush,
+        error_code& ec);
+
+private:
+    BOOST_BEAST_DECL void run();
+    BOOST_BEAST_DECL void submit(Flush flush);
+    BOOST_BEAST_DECL bool deliver(z_params& zs, std::size_t keep);
+    BOOST_BEAST_DECL void cancel();
+};
+
+} // zlib
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/zlib/impl/parallel_deflate_stream.ipp>
+#endif
+
+#endif
@@ -0,0 +1,374 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/_experimental/http/client_pool.hpp>
+
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class client_pool_test : public beast::unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+    using pool_type = client_pool<tcp_stream>;
+
+    // Responds to each request with its target. The target
+    // "/close" closes the connection, "/drop" closes it without
+    // saying so, and "/hangup" closes it without responding
+    // unless it is the first request on the connection.
+    class server
+    {
+        struct session : std::enable_shared_from_this<session>
+        {
+            server& srv;
+            tcp_stream stream;
+            flat_buffer buffer;
+            request<string_body> req;
+            response<string_body> res;
+            std::size_t n = 0;
+
+            session(server& srv_, tcp::socket&& s)
+                : srv(srv_)
+                , stream(std::move(s))
+            {
+            }
+
+            void
+            do_read()
+            {
+                req = {};
+                http::async_read(stream, buffer, req,
+                    bind_front_handler(&session::on_read,
+                        this->shared_from_this()));
+            }
+
+            void
+            on_read(error_code ec, std::size_t)
+            {
+                if(ec)
+                    return do_close();
+                ++srv.requests;
+                if(++n > 1 && req.target() == "/hangup")
+                    return do_close();
+                res = {};
+                res.version(11);
+                res.result(status::ok);
+                res.body() = std::string(req.target());
+                res.keep_alive(
+                    req.keep_alive() && req.target() != "/close");
+                res.prepare_payload();
+                http::async_write(stream, res,
+                    bind_front_handler(&session::on_write,
+                        this->shared_from_this()));
+            }
+
+            void
+            on_write(error_code ec, std::size_t)
+            {
+                if(ec || ! res.keep_alive() || req.target() == "/drop")
+                    return do_close();
+                do_read();
+            }
+
+            void
+            do_close()
+            {
+                error_code ec;
+                stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+                stream.close();
+                ++srv.closed;
+            }
+        };
+
+        tcp::acceptor a_;
+
+        void
+        do_accept()
+        {
+            a_.async_accept(
+                [this](error_code ec, tcp::socket s)
+                {
+                    if(ec)
+                        return;
+                    ++accepts;
+                    std::make_shared<session>(
+                        *this, std::move(s))->do_read();
+                    do_accept();
+                });
+        }
+
+    public:
+        std::size_t accepts = 0;
+        std::size_t requests = 0;
+        std::size_t closed = 0;
+
+        explicit
+        server(net::io_context& ioc)
+            : a_(ioc, {net::ip::address_v4::loopback(), 0})
+        {
+            do_accept();
+        }
+
+        std::string
+        port() const
+        {
+            return std::to_string(a_.local_endpoint().port());
+        }
+    };
+
+    struct result
+    {
+        bool done = false;
+        error_code ec;
+        std::string body;
+    };
+
+    net::io_context ioc_;
+
+    template<class Pred>
+    void
+    run_until(Pred const& pred)
+    {
+        while(! pred())
+            if(! BEAST_EXPECT(ioc_.run_one() > 0))
+                return;
+    }
+
+    // Start a request, the result is stored in r
+    void
+    start(pool_type& pool, server& srv, string_view target,
+        std::shared_ptr<result> const& r,
+        verb method = verb::get)
+    {
+        auto req = std::make_shared<request<string_body>>(
+            method, target, 11);
+        req->set(field::host, "localhost");
+        auto res = std::make_shared<response<string_body>>();
+        pool.async_request("127.0.0.1", srv.port(), *req, *res,
+            [r, req, res](error_code ec, std::size_t)
+            {
+                r->done = true;
+                r->ec = ec;
+                r->body = res->body();
+            });
+    }
+
+    std::shared_ptr<result>
+    send(pool_type& pool, server& srv,
+        string_view target, verb method = verb::get)
+    {
+        auto r = std::make_shared<result>();
+        start(pool, srv, target, r, method);
+        run_until([&]{ return r->done; });
+        return r;
+    }
+
+    // Close the connections, so no session outlives its server
+    void
+    finish(pool_type& pool, server& srv)
+    {
+        pool.clear();
+        BEAST_EXPECT(pool.size() == 0);
+        run_until([&]{ return srv.closed == srv.accepts; });
+    }
+
+    void
+    testReuse()
+    {
+        server srv(ioc_);
+        pool_type pool(ioc_.get_executor());
+        for(int i = 0; i < 3; ++i)
+        {
+            auto r = send(pool, srv, "/a");
+            BEAST_EXPECTS(! r->ec, r->ec.message());
+            BEAST_EXPECT(r->body == "/a");
+        }
+        BEAST_EXPECT(srv.accepts == 1);
+        BEAST_EXPECT(pool.size() == 1);
+        pool.clear();
+        BEAST_EXPECT(pool.size() == 0);
+        BEAST_EXPECT(! send(pool, srv, "/a")->ec);
+        BEAST_EXPECT(srv.accepts == 2);
+
+        // Expired idle connections are not reused
+        pool.idle_timeout(pool_type::duration::zero());
+        BEAST_EXPECT(! send(pool, srv, "/a")->ec);
+        BEAST_EXPECT(srv.accepts == 3);
+        BEAST_EXPECT(pool.size() == 1);
+        finish(pool, srv);
+    }
+
+    void
+    testClose()
+    {
+        server srv(ioc_);
+        pool_type pool(ioc_.get_executor());
+
+        // Connection: close
+        BEAST_EXPECT(! send(pool, srv, "/close")->ec);
+        BEAST_EXPECT(pool.size() == 0);
+        BEAST_EXPECT(! send(pool, srv, "/a")->ec);
+        BEAST_EXPECT(srv.accepts == 2);
+
+        // Closed by the server while idle
+        BEAST_EXPECT(! send(pool, srv, "/drop")->ec);
+        run_until([&]{ return srv.closed == 2; });
+        auto r = send(pool, srv, "/a");
+        BEAST_EXPECTS(! r->ec, r->ec.message());
+        BEAST_EXPECT(srv.accepts == 3);
+        BEAST_EXPECT(pool.size() == 1);
+        finish(pool, srv);
+    }
+
+    void
+    testRetry()
+    {
+        server srv(ioc_);
+        pool_type pool(ioc_.get_executor());
+
+        // An idempotent request is sent again on a new connection
+        BEAST_EXPECT(! send(pool, srv, "/a")->ec);
+        auto r = send(pool, srv, "/hangup");
+        BEAST_EXPECTS(! r->ec, r->ec.message());
+        BEAST_EXPECT(r->body == "/hangup");
+        BEAST_EXPECT(srv.accepts == 2);
+        BEAST_EXPECT(srv.requests == 3);
+
+        // Others are not
+        r = send(pool, srv, "/hangup", verb::post);
+        BEAST_EXPECT(r->ec == error::end_of_stream);
+        BEAST_EXPECT(srv.accepts == 2);
+        BEAST_EXPECT(pool.size() == 0);
+
+        // Nothing listening
+        std::string port;
+        {
+            tcp::acceptor a(ioc_, {net::ip::address_v4::loopback(), 0});
+            port = std::to_string(a.local_endpoint().port());
+        }
+        request<string_body> req(verb::get, "/", 11);
+        response<string_body> res;
+        error_code ec;
+        bool done = false;
+        pool.async_request("127.0.0.1", port, req, res,
+            [&](error_code ec_, std::size_t)
+            {
+                ec = ec_;
+                done = true;
+            });
+        run_until([&]{ return done; });
+        BEAST_EXPECT(ec == net::error::connection_refused);
+        BEAST_EXPECT(pool.size() == 0);
+        finish(pool, srv);
+    }
+
+    void
+    testLimit()
+    {
+        server srv(ioc_);
+        pool_type pool(ioc_.get_executor());
+        try
+        {
+            pool.max_connections(0);
+            fail("", __FILE__, __LINE__);
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+        pool.max_connections(2);
+        std::vector<std::shared_ptr<result>> v;
+        for(int i = 0; i < 5; ++i)
+        {
+            v.emplace_back(std::make_shared<result>());
+            start(pool, srv, "/" + std::to_string(i), v.back());
+        }
+        run_until([&]{ return v.back()->done; });
+        for(std::size_t i = 0; i < v.size(); ++i)
+        {
+            BEAST_EXPECT(v[i]->done);
+            BEAST_EXPECTS(! v[i]->ec, v[i]->ec.message());
+            BEAST_EXPECT(v[i]->body == "/" + std::to_string(i));
+        }
+        BEAST_EXPECT(srv.accepts == 2);
+        BEAST_EXPECT(pool.size() == 2);
+        finish(pool, srv);
+    }
+
+    void
+    testPipelining()
+    {
+        server srv(ioc_);
+        pool_type pool(ioc_.get_executor());
+        pool.max_connections(1);
+        pool.pipelining(true);
+        BEAST_EXPECT(! send(pool, srv, "/a")->ec);
+        std::vector<std::shared_ptr<result>> v;
+        for(int i = 0; i < 5; ++i)
+        {
+            v.emplace_back(std::make_shared<result>());
+            start(pool, srv, "/" + std::to_string(i), v.back());
+        }
+        run_until([&]{ return v.back()->done; });
+        for(std::size_t i = 0; i < v.size(); ++i)
+        {
+            BEAST_EXPECTS(! v[i]->ec, v[i]->ec.message());
+            BEAST_EXPECT(v[i]->body == "/" + std::to_string(i));
+        }
+        BEAST_EXPECT(srv.accepts == 1);
+
+        // Requests behind a Connection: close go on a new connection
+        v.clear();
+        for(auto target : {"/close", "/b", "/c"})
+        {
+            v.emplace_back(std::make_shared<result>());
+            start(pool, srv, target, v.back());
+        }
+        run_until([&]{
+            return v[0]->done && v[1]->done && v[2]->done; });
+        BEAST_EXPECT(! v[0]->ec && v[0]->body == "/close");
+        BEAST_EXPECTS(! v[1]->ec, v[1]->ec.message());
+        BEAST_EXPECT(v[1]->body == "/b");
+        BEAST_EXPECTS(! v[2]->ec, v[2]->ec.message());
+        BEAST_EXPECT(v[2]->body == "/c");
+        BEAST_EXPECT(srv.accepts == 2);
+        BEAST_EXPECT(pool.size() == 1);
+        finish(pool, srv);
+    }
+
+    void
+    run() override
+    {
+        testReuse();
+        testClose();
+        testRetry();
+        testLimit();
+        testPipelining();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,client_pool);
+
+} // http
+} // beast
+} // boost
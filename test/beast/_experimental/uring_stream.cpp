@@ -0,0 +1,432 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/_experimental/core/uring_stream.hpp>
+
+#if BOOST_BEAST_HAS_IO_URING
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/write.hpp>
+#include <array>
+#include <functional>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+class uring_stream_test : public beast::unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+
+    struct result
+    {
+        bool done = false;
+        error_code ec;
+        std::size_t n = 0;
+
+        std::function<void(error_code, std::size_t)>
+        handler()
+        {
+            return
+                [this](error_code ec_, std::size_t n_)
+                {
+                    done = true;
+                    ec = ec_;
+                    n = n_;
+                };
+        }
+    };
+
+    net::io_context ioc_;
+
+    template<class Pred>
+    void
+    run_until(Pred const& pred)
+    {
+        ioc_.restart();
+        while(! pred())
+            if(! BEAST_EXPECT(ioc_.run_one() > 0))
+                return;
+    }
+
+    // Connect s to a plain socket
+    void
+    connect(uring_stream& s, tcp::socket& peer)
+    {
+        tcp::acceptor a(ioc_, {net::ip::address_v4::loopback(), 0});
+        peer.connect(a.local_endpoint());
+        a.accept(s.socket());
+    }
+
+    std::string
+    read(tcp::socket& peer, std::size_t n)
+    {
+        std::string s(n, 0);
+        net::read(peer, net::buffer(&s[0], n));
+        return s;
+    }
+
+    void
+    testReadWrite()
+    {
+        uring_stream s(ioc_);
+        tcp::socket peer(ioc_);
+        connect(s, peer);
+
+        result r;
+        s.async_write_some(net::buffer("hello", 5), r.handler());
+        BEAST_EXPECT(! r.done);
+        run_until([&]{ return r.done; });
+        BEAST_EXPECTS(! r.ec, r.ec.message());
+        BEAST_EXPECT(r.n == 5);
+        BEAST_EXPECT(read(peer, 5) == "hello");
+
+        net::write(peer, net::buffer("world", 5));
+        char buf[16];
+        r = {};
+        s.async_read_some(net::buffer(buf), r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECTS(! r.ec, r.ec.message());
+        BEAST_EXPECT(string_view(buf, r.n) == "world");
+
+        // Several buffers
+        std::array<net::const_buffer, 3> cb{{
+            net::buffer("ab", 2),
+            net::const_buffer{},
+            net::buffer("cde", 3)}};
+        r = {};
+        s.async_write_some(cb, r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec && r.n == 5);
+        BEAST_EXPECT(read(peer, 5) == "abcde");
+
+        net::write(peer, net::buffer("12345", 5));
+        char b1[2];
+        char b2[8];
+        std::array<net::mutable_buffer, 2> mb{{
+            net::buffer(b1), net::buffer(b2)}};
+        r = {};
+        s.async_read_some(mb, r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec && r.n == 5);
+        BEAST_EXPECT(string_view(b1, 2) == "12");
+        BEAST_EXPECT(string_view(b2, 3) == "345");
+
+        // Empty buffers complete at once, but not inline
+        r = {};
+        s.async_read_some(net::mutable_buffer{}, r.handler());
+        BEAST_EXPECT(! r.done);
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec && r.n == 0);
+
+        // End of stream
+        peer.close();
+        r = {};
+        s.async_read_some(net::buffer(buf), r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECTS(r.ec == net::error::eof, r.ec.message());
+
+        // Closed
+        s.close();
+        r = {};
+        s.async_read_some(net::buffer(buf), r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(r.ec == net::error::bad_descriptor);
+    }
+
+    void
+    testCancel()
+    {
+        uring_stream s(ioc_);
+        tcp::socket peer(ioc_);
+        connect(s, peer);
+        char buf[16];
+        for(bool multishot : {false, true})
+        {
+            s.multishot(multishot);
+            BEAST_EXPECT(s.multishot() == multishot);
+            result r;
+            s.async_read_some(net::buffer(buf), r.handler());
+            net::post(ioc_, [&]{ s.cancel(); });
+            run_until([&]{ return r.done; });
+            BEAST_EXPECTS(r.ec == net::error::operation_aborted,
+                r.ec.message());
+        }
+
+        // The stream remains usable
+        s.multishot(false);
+        net::write(peer, net::buffer("x", 1));
+        result r;
+        s.async_read_some(net::buffer(buf), r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec && r.n == 1 && buf[0] == 'x');
+
+        // Destroyed with a read outstanding
+        r = {};
+        tcp::socket peer2(ioc_);
+        {
+            uring_stream s2(ioc_);
+            connect(s2, peer2);
+            s2.async_read_some(net::buffer(buf), r.handler());
+        }
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(r.ec == net::error::operation_aborted);
+    }
+
+    void
+    testMultishot()
+    {
+        uring_stream s(ioc_);
+        tcp::socket peer(ioc_);
+        connect(s, peer);
+        s.multishot(true);
+
+        std::string got;
+        char buf[2];
+        auto const read_some =
+            [&]
+            {
+                result r;
+                s.async_read_some(net::buffer(buf), r.handler());
+                run_until([&]{ return r.done; });
+                if(! r.ec)
+                    got.append(buf, r.n);
+                return r.ec;
+            };
+        net::write(peer, net::buffer("abc", 3));
+        while(got.size() < 3)
+            if(! BEAST_EXPECT(! read_some()))
+                return;
+        net::write(peer, net::buffer("defgh", 5));
+        while(got.size() < 8)
+            if(! BEAST_EXPECT(! read_some()))
+                return;
+        BEAST_EXPECT(got == "abcdefgh");
+
+        // More than the provided buffers hold
+        std::string const big(1024 * 1024, '*');
+        std::size_t total = 0;
+        std::string in(65536, 0);
+        result w;
+        net::async_write(peer, net::buffer(big), w.handler());
+        while(total < big.size())
+        {
+            result r;
+            s.async_read_some(net::buffer(&in[0], in.size()),
+                r.handler());
+            run_until([&]{ return r.done; });
+            if(! BEAST_EXPECTS(! r.ec, r.ec.message()))
+                return;
+            total += r.n;
+        }
+        run_until([&]{ return w.done; });
+        BEAST_EXPECT(total == big.size());
+
+        peer.shutdown(tcp::socket::shutdown_send);
+        BEAST_EXPECT(read_some() == net::error::eof);
+        BEAST_EXPECT(read_some() == net::error::eof);
+    }
+
+    void
+    testHttp()
+    {
+        uring_stream s(ioc_);
+        tcp::socket peer(ioc_);
+        connect(s, peer);
+
+        flat_buffer b;
+        b.reserve(4096);
+        s.register_buffer(b.prepare(4096));
+
+        std::string const req =
+            "GET / HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "hello";
+        net::write(peer, net::buffer(req));
+
+        http::request<http::string_body> m;
+        result r;
+        http::async_read(s, b, m, r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECTS(! r.ec, r.ec.message());
+        BEAST_EXPECT(m.target() == "/");
+        BEAST_EXPECT(m.body() == "hello");
+
+        http::response<http::string_body> res{http::status::ok, 11};
+        res.body() = "world";
+        res.prepare_payload();
+        r = {};
+        http::async_write(s, res, r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec);
+
+        flat_buffer pb;
+        http::response<http::string_body> got;
+        http::read(peer, pb, got);
+        BEAST_EXPECT(got.body() == "world");
+        s.unregister_buffer();
+    }
+
+    void
+    testShutdown()
+    {
+        // Destroying the io_context with a read pending on a
+        // registered buffer waits for the read to be canceled.
+        tcp::socket peer(ioc_);
+        std::string buf(64, '.');
+        {
+            net::io_context ioc;
+            {
+                uring_stream s(ioc);
+                connect(s, peer);
+                s.register_buffer(net::buffer(&buf[0], buf.size()));
+                s.async_read_some(net::buffer(&buf[0], buf.size()),
+                    [](error_code, std::size_t)
+                    {
+                    });
+                ioc.poll();
+            }
+        }
+        net::write(peer, net::buffer("hello", 5));
+        BEAST_EXPECT(buf == std::string(64, '.'));
+    }
+
+    void
+    testWebsocket()
+    {
+        websocket::stream<uring_stream> ws(ioc_);
+        websocket::stream<tcp::socket> peer(ioc_);
+        connect(ws.next_layer(), peer.next_layer());
+        ws.next_layer().multishot(true);
+
+        result ra;
+        result rh;
+        peer.async_accept(
+            [&](error_code ec)
+            {
+                ra.done = true;
+                ra.ec = ec;
+            });
+        ws.async_handshake("localhost", "/",
+            [&](error_code ec)
+            {
+                rh.done = true;
+                rh.ec = ec;
+            });
+        run_until([&]{ return ra.done && rh.done; });
+        BEAST_EXPECTS(! ra.ec, ra.ec.message());
+        BEAST_EXPECTS(! rh.ec, rh.ec.message());
+
+        flat_buffer b;
+        result rr;
+        peer.async_read(b, rr.handler());
+        result rw;
+        ws.async_write(net::buffer("ping", 4), rw.handler());
+        run_until([&]{ return rr.done && rw.done; });
+        BEAST_EXPECT(! rr.ec && ! rw.ec);
+        BEAST_EXPECT(buffers_to_string(b.data()) == "ping");
+
+        flat_buffer b2;
+        rr = {};
+        ws.async_read(b2, rr.handler());
+        rw = {};
+        peer.async_write(net::buffer("pong", 4), rw.handler());
+        run_until([&]{ return rr.done && rw.done; });
+        BEAST_EXPECT(! rr.ec && ! rw.ec);
+        BEAST_EXPECT(buffers_to_string(b2.data()) == "pong");
+
+        result rc;
+        rr = {};
+        peer.async_read(b, rr.handler());
+        ws.async_close({},
+            [&](error_code ec)
+            {
+                rc.done = true;
+                rc.ec = ec;
+            });
+        run_until([&]{ return rc.done && rr.done; });
+        BEAST_EXPECTS(! rc.ec, rc.ec.message());
+        BEAST_EXPECT(rr.ec == websocket::error::closed);
+    }
+
+    void
+    testStrand()
+    {
+        basic_uring_stream<net::strand<
+            net::io_context::executor_type>> s(
+                net::make_strand(ioc_));
+        tcp::socket peer(ioc_);
+        tcp::acceptor a(ioc_, {net::ip::address_v4::loopback(), 0});
+        peer.connect(a.local_endpoint());
+        a.accept(s.socket());
+        net::write(peer, net::buffer("x", 1));
+        char c;
+        result r;
+        s.async_read_some(net::buffer(&c, 1), r.handler());
+        run_until([&]{ return r.done; });
+        BEAST_EXPECT(! r.ec && c == 'x');
+
+        // Only an io_context can run the ring
+        try
+        {
+            net::thread_pool tp(1);
+            basic_uring_stream<net::thread_pool::executor_type> s2(
+                tp.get_executor());
+            fail("", __FILE__, __LINE__);
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    run() override
+    {
+        try
+        {
+            uring_stream s(ioc_);
+        }
+        catch(system_error const& e)
+        {
+            log << "io_uring unavailable: " << e.what() << std::endl;
+            return;
+        }
+        testReadWrite();
+        testCancel();
+        testMultishot();
+        testHttp();
+        testShutdown();
+        testWebsocket();
+        testStrand();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,uring_stream);
+
+} // beast
+} // boost
+
+#endif
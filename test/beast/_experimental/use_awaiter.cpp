@@ -0,0 +1,330 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/_experimental/core/use_awaiter.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+
+#if BOOST_BEAST_HAS_CO_AWAIT
+
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+
+#endif
+
+namespace boost {
+namespace beast {
+
+class use_awaiter_test : public unit_test::suite
+{
+public:
+#if BOOST_BEAST_HAS_CO_AWAIT
+    struct counts
+    {
+        int requests = 0;
+        std::size_t bytes = 0;
+        std::string body;
+        error_code ec;
+        bool done = false;
+    };
+
+    static
+    detached_task
+    serve_http(test::stream& s, counts& c)
+    {
+        flat_buffer b;
+        for(;;)
+        {
+            error_code ec;
+            http::request<http::string_body> req;
+            std::size_t const n = co_await http::async_read(
+                s, b, req, use_awaiter[ec]);
+            if(ec)
+            {
+                c.ec = ec;
+                break;
+            }
+            c.bytes += n;
+            http::response<http::string_body> res{
+                http::status::ok, req.version()};
+            res.body() = req.body();
+            res.prepare_payload();
+            co_await http::async_write(s, res, use_awaiter[ec]);
+            if(ec)
+                break;
+            ++c.requests;
+        }
+        c.done = true;
+    }
+
+    static
+    detached_task
+    request_http(test::stream& s, int repeat, counts& c)
+    {
+        flat_buffer b;
+        for(int i = 0; i < repeat; ++i)
+        {
+            http::request<http::string_body> req{
+                http::verb::post, "/", 11};
+            req.body() = std::to_string(i);
+            req.prepare_payload();
+            c.bytes += co_await http::async_write(s, req, use_awaiter);
+            http::response<http::string_body> res;
+            co_await http::async_read(s, b, res, use_awaiter);
+            c.body += res.body();
+        }
+        s.close();
+        c.done = true;
+    }
+
+    void
+    testHttp()
+    {
+        net::io_context ioc;
+        test::stream ts(ioc);
+        auto tr = test::connect(ts);
+        counts server;
+        counts client;
+        serve_http(ts, server);
+        request_http(tr, 3, client);
+        BEAST_EXPECT(! server.done);
+        BEAST_EXPECT(! client.done);
+        ioc.run();
+        BEAST_EXPECT(server.done);
+        BEAST_EXPECT(client.done);
+        BEAST_EXPECT(server.requests == 3);
+        BEAST_EXPECT(server.bytes == client.bytes);
+        BEAST_EXPECT(server.ec == http::error::end_of_stream);
+        BEAST_EXPECT(client.body == "012");
+    }
+
+    static
+    detached_task
+    read_throws(test::stream& s, counts& c)
+    {
+        flat_buffer b;
+        http::request<http::string_body> req;
+        try
+        {
+            co_await http::async_read(s, b, req, use_awaiter);
+        }
+        catch(system_error const& e)
+        {
+            c.ec = e.code();
+        }
+        c.done = true;
+    }
+
+    void
+    testThrow()
+    {
+        net::io_context ioc;
+        test::stream ts(ioc, "GET / HTTP/1.1\r\n");
+        ts.close_remote();
+        counts c;
+        read_throws(ts, c);
+        ioc.run();
+        BEAST_EXPECT(c.done);
+        BEAST_EXPECT(c.ec == http::error::partial_message);
+    }
+
+    static
+    detached_task
+    wait_timer(net::steady_timer& t, counts& c)
+    {
+        co_await t.async_wait(use_awaiter[c.ec]);
+        c.done = true;
+    }
+
+    void
+    testAsio()
+    {
+        net::io_context ioc;
+        {
+            net::steady_timer t(ioc);
+            t.expires_after(std::chrono::milliseconds(1));
+            counts c;
+            wait_timer(t, c);
+            ioc.run();
+            BEAST_EXPECT(c.done);
+            BEAST_EXPECT(! c.ec);
+        }
+        ioc.restart();
+        {
+            net::steady_timer t(ioc);
+            t.expires_after(std::chrono::hours(1));
+            counts c;
+            wait_timer(t, c);
+            ioc.poll();
+            BEAST_EXPECT(! c.done);
+            t.cancel();
+            ioc.run();
+            BEAST_EXPECT(c.done);
+            BEAST_EXPECT(c.ec == net::error::operation_aborted);
+        }
+    }
+
+    static
+    detached_task
+    serve_websocket(
+        websocket::stream<test::stream>& ws, counts& c)
+    {
+        co_await ws.async_accept(use_awaiter);
+        flat_buffer b;
+        for(;;)
+        {
+            error_code ec;
+            co_await ws.async_read(b, use_awaiter[ec]);
+            if(ec)
+            {
+                c.ec = ec;
+                break;
+            }
+            ws.text(ws.got_text());
+            c.bytes += co_await ws.async_write(b.data(), use_awaiter);
+            b.consume(b.size());
+            ++c.requests;
+        }
+        c.done = true;
+    }
+
+    static
+    detached_task
+    request_websocket(
+        websocket::stream<test::stream>& ws, counts& c)
+    {
+        co_await ws.async_handshake("localhost", "/", use_awaiter);
+        flat_buffer b;
+        co_await ws.async_write(net::buffer("Hello", 5), use_awaiter);
+        co_await ws.async_read(b, use_awaiter);
+        c.body = buffers_to_string(b.data());
+        b.consume(b.size());
+
+        // A buffer sequence too large to be
+        // stored in the awaiter itself
+        std::array<net::const_buffer, 16> v;
+        for(auto& cb : v)
+            cb = net::buffer(", world", 7);
+        co_await ws.async_write(v, use_awaiter);
+        co_await ws.async_read(b, use_awaiter);
+        c.body += buffers_to_string(b.data());
+        co_await ws.async_close({}, use_awaiter);
+        c.done = true;
+    }
+
+    void
+    testWebsocket()
+    {
+        net::io_context ioc;
+        websocket::stream<test::stream> ws1(ioc);
+        websocket::stream<test::stream> ws2(ioc);
+        test::connect(ws1.next_layer(), ws2.next_layer());
+        counts server;
+        counts client;
+        serve_websocket(ws1, server);
+        request_websocket(ws2, client);
+        ioc.run();
+        BEAST_EXPECT(server.done);
+        BEAST_EXPECT(client.done);
+        BEAST_EXPECT(server.requests == 2);
+        BEAST_EXPECT(server.bytes == 5 + 16 * 7);
+        BEAST_EXPECT(server.ec == websocket::error::closed);
+        std::string s = "Hello";
+        for(int i = 0; i < 16; ++i)
+            s += ", world";
+        BEAST_EXPECT(client.body == s);
+    }
+
+    void
+    testUnawaited()
+    {
+        // Destroying an awaiter which was
+        // not awaited starts nothing.
+        net::io_context ioc;
+        test::stream ts(ioc, "GET / HTTP/1.1\r\n\r\n");
+        flat_buffer b;
+        http::request<http::string_body> req;
+        {
+            auto a = http::async_read(ts, b, req, use_awaiter);
+        }
+        {
+            std::array<net::const_buffer, 16> v;
+            auto a = ts.async_write_some(v, use_awaiter);
+        }
+        BEAST_EXPECT(ioc.poll() == 0);
+        BEAST_EXPECT(b.size() == 0);
+        http::read(ts, b, req);
+        BEAST_EXPECT(req.target() == "/");
+    }
+
+    void
+    testArena()
+    {
+        detail::awaiter_arena<64> a;
+        auto const p1 = a.allocate(16, 8);
+        auto const p2 = a.allocate(8, 8);
+        BEAST_EXPECT(static_cast<char*>(p2) ==
+            static_cast<char*>(p1) + 16);
+        a.deallocate(p2, 8, 8);
+        auto const p3 = a.allocate(24, 16);
+        BEAST_EXPECT(p3 == p2);
+
+        // does not fit
+        auto const p4 = a.allocate(48, 8);
+        BEAST_EXPECT(
+            static_cast<char*>(p4) < static_cast<char*>(p1) ||
+            static_cast<char*>(p4) >= static_cast<char*>(p1) + 64);
+        a.deallocate(p4, 48, 8);
+
+        // over-aligned
+        auto const p5 = a.allocate(32, 128);
+        BEAST_EXPECT(reinterpret_cast<std::uintptr_t>(p5) % 128 == 0);
+        a.deallocate(p5, 32, 128);
+
+        a.deallocate(p1, 16, 8);
+        a.deallocate(p3, 24, 16);
+
+        // empty again
+        BEAST_EXPECT(a.allocate(64, 8) == p1);
+    }
+
+    void
+    run() override
+    {
+        testHttp();
+        testThrow();
+        testAsio();
+        testWebsocket();
+        testUnawaited();
+        testArena();
+    }
+#else
+    void
+    run() override
+    {
+        pass();
+    }
+#endif
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,use_awaiter);
+
+} // beast
+} // boost
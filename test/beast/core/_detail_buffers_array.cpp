@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/detail/buffers_array.hpp>
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <array>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+class buffers_array_test : public beast::unit_test::suite
+{
+public:
+    template<class ConstBufferSequence>
+    static
+    std::size_t
+    count(ConstBufferSequence const& buffers)
+    {
+        std::size_t n = 0;
+        for(auto it = net::buffer_sequence_begin(buffers);
+            it != net::buffer_sequence_end(buffers); ++it)
+            if(net::const_buffer(*it).size() > 0)
+                ++n;
+        return n;
+    }
+
+    // Flatten and compare against the iterators
+    template<std::size_t N, class ConstBufferSequence>
+    void
+    check(ConstBufferSequence const& buffers)
+    {
+        buffers_array<N> ba;
+        auto const fit = ba.assign(buffers);
+        auto const n = count(buffers);
+        BEAST_EXPECT(fit == (n <= N));
+        if(fit)
+        {
+            BEAST_EXPECT(ba.size() == n);
+            BEAST_EXPECT(buffers_to_string(ba) ==
+                buffers_to_string(buffers));
+        }
+        else
+        {
+            BEAST_EXPECT(ba.size() == N);
+        }
+        for(auto b : ba)
+            BEAST_EXPECT(b.size() > 0);
+    }
+
+    void
+    testBufferSequence()
+    {
+        string_view s = "Hello, world!";
+        buffers_array<3> ba(buffers_cat(
+            net::const_buffer(s.data(), 5),
+            net::const_buffer(s.data() + 5, 8)));
+        test_buffer_sequence(ba);
+        BEAST_EXPECT(ba.size() == 2);
+        BEAST_EXPECT(ba.capacity() == 3);
+        BEAST_EXPECT(buffers_to_string(ba) == s);
+    }
+
+    void
+    testViews()
+    {
+        string_view s = "Hello, world!";
+        for(std::size_t i = 0; i <= s.size(); ++i)
+        for(std::size_t j = i; j <= s.size(); ++j)
+        {
+            std::array<net::const_buffer, 3> v{{
+                net::const_buffer(s.data(),     i),
+                net::const_buffer(s.data() + i, j - i),
+                net::const_buffer(s.data() + j, s.size() - j) }};
+            auto const cv = buffers_cat(
+                net::const_buffer(s.data(), 0), v,
+                buffers_cat(v, net::const_buffer("!", 1)));
+            check<8>(v);
+            check<2>(v);
+            check<8>(cv);
+            check<3>(cv);
+            for(std::size_t k = 0; k <= 2 * s.size() + 1; ++k)
+            {
+                buffers_suffix<decltype(cv)> cs(cv);
+                cs.consume(k);
+                check<8>(cs);
+                check<2>(cs);
+                for(std::size_t m = 0; m <= buffer_bytes(cs); ++m)
+                {
+                    auto const pv = buffers_prefix(
+                        m, make_buffers_ref(cs));
+                    check<8>(pv);
+                    check<1>(pv);
+
+                    buffers_array<8> ba;
+                    BEAST_EXPECT(ba.assign(cs, m));
+                    BEAST_EXPECT(buffers_to_string(ba) ==
+                        buffers_to_string(pv));
+                }
+            }
+        }
+    }
+
+    void
+    run() override
+    {
+        testBufferSequence();
+        testViews();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,buffers_array);
+
+} // detail
+} // beast
+} // boost
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/detail/op_cache.hpp>
+
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <memory>
+#include <set>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+class op_cache_test : public beast::unit_test::suite
+{
+public:
+    struct counts
+    {
+        std::size_t allocs = 0;
+        std::size_t frees = 0;
+    };
+
+    // Counts the allocations made through it
+    template<class T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        counts* c;
+
+        explicit
+        counting_allocator(counts* c_) noexcept
+            : c(c_)
+        {
+        }
+
+        template<class U>
+        counting_allocator(
+            counting_allocator<U> const& other) noexcept
+            : c(other.c)
+        {
+        }
+
+        T*
+        allocate(std::size_t n)
+        {
+            ++c->allocs;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void
+        deallocate(T* p, std::size_t n)
+        {
+            ++c->frees;
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template<class U>
+        bool
+        operator==(counting_allocator<U> const& other) const noexcept
+        {
+            return c == other.c;
+        }
+
+        template<class U>
+        bool
+        operator!=(counting_allocator<U> const& other) const noexcept
+        {
+            return c != other.c;
+        }
+    };
+
+    // A completion handler with its own allocator
+    struct counted_handler
+    {
+        counts* c;
+        error_code* ec;
+        std::size_t* n;
+
+        using allocator_type = counting_allocator<void>;
+
+        allocator_type
+        get_allocator() const noexcept
+        {
+            return allocator_type(c);
+        }
+
+        void
+        operator()(error_code ec_, std::size_t bytes_transferred)
+        {
+            *ec = ec_;
+            *n += bytes_transferred;
+        }
+    };
+
+    void
+    testCache()
+    {
+        // blocks are recycled
+        {
+            op_cache c;
+            op_cache::allocator<char> a(c.get_allocator());
+            auto p = a.allocate(100);
+            a.deallocate(p, 100);
+            BEAST_EXPECT(c.idle() == 1);
+            {
+                std::set<char*> blocks;
+                for(int i = 0; i < 100; ++i)
+                {
+                    auto p1 = a.allocate(10);
+                    auto p2 = a.allocate(64);
+                    blocks.insert(p1);
+                    blocks.insert(p2);
+                    a.deallocate(p1, 10);
+                    a.deallocate(p2, 64);
+                }
+                // one block was needed in addition
+                BEAST_EXPECT(blocks.size() == 2);
+                BEAST_EXPECT(blocks.count(p) == 1);
+            }
+            BEAST_EXPECT(c.idle() == 2);
+            BEAST_EXPECT(c.allocated() == 2);
+
+            // a larger request leaves small blocks alone
+            p = a.allocate(1000);
+            BEAST_EXPECT(c.idle() == 2);
+            BEAST_EXPECT(c.allocated() == 3);
+            a.deallocate(p, 1000);
+            BEAST_EXPECT(c.idle() == 3);
+        }
+
+        // blocks outlive the cache
+        {
+            op_cache::allocator<int> a(nullptr);
+            int* p;
+            {
+                op_cache c;
+                a = op_cache::allocator<int>(c.get_allocator());
+                p = a.allocate(4);
+                p[3] = 42;
+            }
+            BEAST_EXPECT(p[3] == 42);
+            a.deallocate(p, 4);
+        }
+
+        // rebind and equality
+        {
+            op_cache c1;
+            op_cache c2;
+            op_cache::allocator<int> a1(c1.get_allocator());
+            op_cache::allocator<char> a2(a1);
+            BEAST_EXPECT(op_cache::allocator<char>(
+                c1.get_allocator()) == a2);
+            BEAST_EXPECT(op_cache::allocator<char>(
+                c2.get_allocator()) != a2);
+        }
+    }
+
+    void
+    testStream()
+    {
+        using tcp = net::ip::tcp;
+
+        net::io_context ioc;
+        tcp::acceptor a(ioc);
+        tcp::endpoint ep(net::ip::make_address_v4("127.0.0.1"), 0);
+        a.open(ep.protocol());
+        a.bind(ep);
+        a.listen();
+        tcp_stream s1(ioc);
+        tcp_stream s2(ioc);
+        s1.connect(a.local_endpoint());
+        a.accept(s2.socket());
+
+        char const out[] = "Hello, world!";
+        char in[sizeof(out)];
+        auto const round_trip =
+            [&](counts* c)
+            {
+                error_code ec1;
+                error_code ec2;
+                std::size_t n = 0;
+                s1.expires_after(std::chrono::seconds(30));
+                s2.expires_after(std::chrono::seconds(30));
+                if(c)
+                {
+                    s1.async_write_some(net::buffer(out),
+                        counted_handler{c, &ec1, &n});
+                    s2.async_read_some(net::buffer(in),
+                        counted_handler{c, &ec2, &n});
+                }
+                else
+                {
+                    s1.async_write_some(net::buffer(out),
+                        [&](error_code ec, std::size_t bytes_transferred)
+                        {
+                            ec1 = ec;
+                            n += bytes_transferred;
+                        });
+                    s2.async_read_some(net::buffer(in),
+                        [&](error_code ec, std::size_t bytes_transferred)
+                        {
+                            ec2 = ec;
+                            n += bytes_transferred;
+                        });
+                }
+                ioc.run();
+                ioc.restart();
+                BEAST_EXPECTS(! ec1, ec1.message());
+                BEAST_EXPECTS(! ec2, ec2.message());
+                BEAST_EXPECT(n == 2 * sizeof(out));
+            };
+
+        auto const allocated =
+            [&]
+            {
+                return
+                    s1.impl_->cache.allocated() +
+                    s2.impl_->cache.allocated();
+            };
+
+        // handlers without an allocator of their own
+        // stop reaching the heap after warm-up
+        for(int i = 0; i < 10; ++i)
+            round_trip(nullptr);
+        auto const n = allocated();
+        BEAST_EXPECT(n > 0);
+        for(int i = 0; i < 100; ++i)
+            round_trip(nullptr);
+        BEAST_EXPECTS(allocated() == n,
+            std::to_string(allocated()) + " " + std::to_string(n));
+
+        // a handler's own allocator takes precedence
+        counts c;
+        for(int i = 0; i < 100; ++i)
+            round_trip(&c);
+        BEAST_EXPECT(c.allocs >= 100);
+        BEAST_EXPECT(c.allocs == c.frees);
+        BEAST_EXPECT(allocated() == n);
+    }
+
+    void
+    run() override
+    {
+        testCache();
+        testStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,op_cache);
+
+} // detail
+} // beast
+} // boost
@@ -10,14 +10,17 @@
 // Test that header file is self-contained.
 #include <boost/beast/core/buffered_read_stream.hpp>
 
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/test/yield_to.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
 #include <boost/asio/spawn.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/optional.hpp>
@@ -202,6 +205,122 @@ public:
         BEAST_EXPECT(n < limit);
     }
 
+    void testFill()
+    {
+        net::io_context ioc;
+        std::string const s(65536, '*');
+        char buf[4096];
+
+        // large reads bypass the internal buffer
+        {
+            test::stream ts(ioc, s);
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            srs.capacity(1024);
+            BEAST_EXPECT(srs.read_some(
+                net::buffer(buf, sizeof(buf))) == sizeof(buf));
+            BEAST_EXPECT(srs.buffer().size() == 0);
+            BEAST_EXPECT(srs.read_some(net::buffer(buf, 10)) == 10);
+            BEAST_EXPECT(srs.buffer().size() == 502);
+        }
+
+        // fill size grows while reads fill the buffer
+        {
+            test::stream ts(ioc, s);
+            ts.close_remote();
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            srs.capacity(s.size());
+            std::size_t n = 0;
+            error_code ec;
+            for(;;)
+            {
+                n += srs.read_some(net::buffer(buf, 100), ec);
+                if(ec)
+                    break;
+            }
+            BEAST_EXPECT(ec == net::error::eof);
+            BEAST_EXPECT(n == s.size());
+            BEAST_EXPECT(ts.nread() < 16);
+        }
+
+        // async
+        {
+            test::stream ts(ioc, s);
+            ts.close_remote();
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            srs.capacity(s.size());
+            std::size_t n = 0;
+            error_code ec;
+            std::function<void(error_code, std::size_t)> f =
+                [&](error_code ec_, std::size_t bytes_transferred)
+                {
+                    n += bytes_transferred;
+                    ec = ec_;
+                    if(! ec)
+                        srs.async_read_some(net::buffer(buf, 100), f);
+                };
+            srs.async_read_some(net::buffer(buf, 100), f);
+            ioc.run();
+            BEAST_EXPECT(ec == net::error::eof);
+            BEAST_EXPECT(n == s.size());
+            BEAST_EXPECT(ts.nread() < 16);
+        }
+    }
+
+    void testLend()
+    {
+        net::io_context ioc;
+        std::string const s =
+            "GET / HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "\r\n"
+            "extra";
+
+        BOOST_STATIC_ASSERT(net::is_dynamic_buffer<
+            buffered_read_stream<test::stream, flat_buffer>::
+                lent_buffer>::value);
+
+        // The borrower consumes buffered data in place
+        {
+            test::stream ts(ioc, s.substr(10));
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            srs.capacity(1024);
+            srs.buffer().commit(net::buffer_copy(
+                srs.buffer().prepare(10), net::buffer(s, 10)));
+            auto const n = net::read_until(
+                srs, srs.lend(), "\r\n\r\n");
+            BEAST_EXPECT(n == s.size() - 5);
+            BEAST_EXPECT(buffers_to_string(srs.buffer().data()) == s);
+            srs.buffer().consume(n);
+            // The rest is read normally once the loan ends
+            char buf[16];
+            BEAST_EXPECT(srs.read_some(
+                net::buffer(buf, sizeof(buf))) == 5);
+            BEAST_EXPECT(string_view(buf, 5) == "extra");
+        }
+
+        // async
+        {
+            test::stream ts(ioc, s);
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            srs.capacity(1024);
+            std::size_t n = 0;
+            net::async_read_until(srs, srs.lend(), "\r\n\r\n",
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n = bytes_transferred;
+                });
+            ioc.run();
+            BEAST_EXPECT(n == s.size() - 5);
+            BEAST_EXPECT(srs.buffer().size() == s.size());
+        }
+    }
+
     struct copyable_handler
     {
         template<class... Args>
@@ -221,6 +340,8 @@ public:
         });
 
         testAsyncLoop();
+        testFill();
+        testLend();
     }
 };
 
@@ -15,7 +15,10 @@
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/core/role.hpp>
+#include <array>
 #include <initializer_list>
+#include <limits>
+#include <string>
 #include <vector>
 
 namespace boost {
@@ -209,11 +212,123 @@ public:
         check({1,2,3,4},    3,    3, true);
     }
 
+    void
+    testAdaptive()
+    {
+        auto const check =
+            [&](
+                std::initializer_list<std::size_t> v0,
+                std::size_t limit,
+                std::size_t size,
+                std::size_t count,
+                bool copy)
+            {
+                std::vector<net::const_buffer> v;
+                v.reserve(v0.size());
+                for(auto const n : v0)
+                    v.emplace_back("", n);
+                auto const result =
+                    boost::beast::detail::flat_stream_base::flatten(
+                        v, limit, true);
+                BEAST_EXPECT(result.size == size);
+                BEAST_EXPECT(result.count == count);
+                BEAST_EXPECT(result.flatten == copy);
+            };
+        check({},               16384,     0, 0, false);
+        check({1,2,3},          16384,     6, 3, true);
+        check({20000},          16384, 20000, 1, false);
+        check({20000,10},       16384, 16384, 1, false);
+        check({40000,10},       16384, 32768, 1, false);
+        check({16384,10},       16384, 16384, 1, false);
+        check({20000,10},       32768, 20010, 2, true);
+
+        using history =
+            boost::beast::detail::flat_stream_base::size_history;
+        history h;
+        BEAST_EXPECT(h.threshold() == (std::numeric_limits<
+            std::size_t>::max)());
+        for(int i = 0; i < 40; ++i)
+            h.insert(500);
+        BEAST_EXPECT(h.threshold() == 1024);
+        for(int i = 0; i < 5; ++i)
+            h.insert(6000);
+        BEAST_EXPECT(h.threshold() == 1024);
+        for(int i = 0; i < 40; ++i)
+            h.insert(6000);
+        BEAST_EXPECT(h.threshold() == 8192);
+        for(int i = 0; i < 100; ++i)
+            h.insert(1000000);
+        BEAST_EXPECT(h.threshold() == (std::numeric_limits<
+            std::size_t>::max)());
+
+        // Mostly small writes stop the large one from being copied
+        net::io_context ioc;
+        flat_stream<test::stream> s(ioc);
+        test::stream ts(ioc);
+        s.next_layer().connect(ts);
+        s.adaptive_flatten(true);
+        std::string const big(3000, '*');
+        std::array<net::const_buffer, 2> bs{{
+            net::buffer(big), net::buffer(big) }};
+        BEAST_EXPECT(s.write_some(bs) == 6000);
+        std::array<net::const_buffer, 2> small{{
+            net::const_buffer("ab", 2),
+            net::const_buffer("cd", 2) }};
+        for(int i = 0; i < 20; ++i)
+            BEAST_EXPECT(s.write_some(small) == 4);
+        BEAST_EXPECT(s.write_some(bs) == 3000);
+        s.adaptive_flatten(false);
+        BEAST_EXPECT(s.write_some(bs) == 6000);
+    }
+
+    void
+    testOptions()
+    {
+        net::io_context ioc;
+        flat_stream<test::stream> s(ioc);
+        test::stream ts(ioc);
+        s.next_layer().connect(ts);
+        BEAST_EXPECT(s.flatten_limit() ==
+            detail::flat_stream_base::max_size);
+        BEAST_EXPECT(! s.adaptive_flatten());
+        BEAST_EXPECT(s.coalesced() == 0);
+
+        std::array<net::const_buffer, 3> bs{{
+            net::const_buffer("Hello", 5),
+            net::const_buffer(", ", 2),
+            net::const_buffer("world!", 6) }};
+        BEAST_EXPECT(s.write_some(bs) == 13);
+        BEAST_EXPECT(s.coalesced() == 3);
+        BEAST_EXPECT(ts.str() == "Hello, world!");
+
+        s.flatten_limit(0);
+        BEAST_EXPECT(s.flatten_limit() == 0);
+        BEAST_EXPECT(s.write_some(bs) == 5);
+        BEAST_EXPECT(s.coalesced() == 3);
+
+        s.flatten_limit(7);
+        s.adaptive_flatten(true);
+        BEAST_EXPECT(s.adaptive_flatten());
+        std::size_t n = 0;
+        s.async_write_some(bs,
+            [&](error_code ec, std::size_t bytes_transferred)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                n = bytes_transferred;
+            });
+        ioc.run();
+        BEAST_EXPECT(n == 7);
+        BEAST_EXPECT(s.coalesced() == 5);
+        BEAST_EXPECT(ts.str() == "Hello, world!HelloHello, ");
+    }
+
     void
     run() override
     {
         testMembers();
         testSplit();
+        testAdaptive();
+        testOptions();
     }
 };
 
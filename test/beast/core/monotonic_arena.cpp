@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/monotonic_arena.hpp>
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class monotonic_arena_test : public beast::unit_test::suite
+{
+public:
+    using alloc_type = arena_allocator<char>;
+
+    static
+    bool
+    aligned(void* p, std::size_t align)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+    }
+
+    void
+    testArena()
+    {
+        // alignment
+        {
+            monotonic_arena a(100);
+            BEAST_EXPECT(a.capacity() == 0);
+            a.allocate(1, 1);
+            for(std::size_t align = 1; align <= 64; align *= 2)
+            {
+                BEAST_EXPECT(aligned(a.allocate(3, align), align));
+                BEAST_EXPECT(aligned(a.allocate(1), alignof(std::max_align_t)));
+            }
+            BEAST_EXPECT(a.size() >= 13);
+        }
+
+        // deallocate the most recent allocation
+        {
+            monotonic_arena a;
+            auto const p1 = a.allocate(10, 1);
+            auto const p2 = a.allocate(10, 1);
+            auto const n = a.size();
+            a.deallocate(p1, 10);
+            BEAST_EXPECT(a.size() == n);
+            a.deallocate(p2, 10);
+            BEAST_EXPECT(a.size() == n - 10);
+            BEAST_EXPECT(a.allocate(10, 1) == p2);
+        }
+
+        // growth, reset, shrink_to_fit
+        {
+            monotonic_arena a(64);
+            for(int i = 0; i < 100; ++i)
+                a.allocate(50, 1);
+            BEAST_EXPECT(a.size() == 5000);
+            auto const cap = a.capacity();
+            BEAST_EXPECT(cap >= 5000);
+            a.reset();
+            BEAST_EXPECT(a.size() == 0);
+            BEAST_EXPECT(a.capacity() < cap);
+            auto const kept = a.capacity();
+            for(int i = 0; i < 10; ++i)
+                a.allocate(kept / 16, 1);
+            BEAST_EXPECT(a.capacity() == kept);
+            a.shrink_to_fit();
+            BEAST_EXPECT(a.capacity() == 0);
+            BEAST_EXPECT(a.allocate(1000, 1) != nullptr);
+        }
+
+        // caller provided storage
+        {
+            char buf[256];
+            monotonic_arena a(buf, sizeof(buf));
+            BEAST_EXPECT(a.capacity() == sizeof(buf));
+            auto const p = static_cast<char*>(a.allocate(100, 1));
+            BEAST_EXPECT(p >= buf && p + 100 <= buf + sizeof(buf));
+            a.allocate(200, 1);
+            BEAST_EXPECT(a.capacity() > sizeof(buf));
+            a.reset();
+            BEAST_EXPECT(a.allocate(100, 1) == buf);
+        }
+
+        // large allocations
+        {
+            monotonic_arena a(16);
+            auto const p = a.allocate(100000);
+            BEAST_EXPECT(p != nullptr);
+            BEAST_EXPECT(a.capacity() >= 100000);
+            try
+            {
+                a.allocate(std::size_t(-1) - 8);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(std::bad_alloc const&)
+            {
+                pass();
+            }
+        }
+    }
+
+    void
+    testAllocator()
+    {
+        monotonic_arena a1;
+        monotonic_arena a2;
+        alloc_type al1(a1);
+        arena_allocator<int> al2(al1);
+        BEAST_EXPECT(al1 == al2);
+        BEAST_EXPECT(&al2.arena() == &a1);
+        BEAST_EXPECT(al1 != alloc_type(a2));
+
+        std::vector<int, arena_allocator<int>> v(al2);
+        for(int i = 0; i < 1000; ++i)
+            v.push_back(i);
+        BEAST_EXPECT(v.size() == 1000);
+        BEAST_EXPECT(v[999] == 999);
+        BEAST_EXPECT(a1.size() >= 1000 * sizeof(int));
+        BEAST_EXPECT(a2.size() == 0);
+
+        std::basic_string<char, std::char_traits<char>, alloc_type> s(al1);
+        s.assign(1000, '*');
+        BEAST_EXPECT(s.size() == 1000);
+    }
+
+    void
+    testDynamicBuffer()
+    {
+        monotonic_arena a;
+        test_dynamic_buffer(basic_flat_buffer<alloc_type>(alloc_type(a)));
+        test_dynamic_buffer(basic_multi_buffer<alloc_type>(alloc_type(a)));
+    }
+
+    void
+    testHttp()
+    {
+        using string_body = http::basic_string_body<
+            char, std::char_traits<char>, alloc_type>;
+        using dynamic_body = http::basic_dynamic_body<
+            basic_multi_buffer<alloc_type>>;
+        using fields = http::basic_fields<alloc_type>;
+
+        net::io_context ioc;
+        monotonic_arena arena;
+        std::size_t cap = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            {
+                test::stream ts(ioc,
+                    "POST / HTTP/1.1\r\n"
+                    "Host: localhost\r\n"
+                    "User-Agent: test\r\n"
+                    "Content-Length: 5\r\n"
+                    "\r\n"
+                    "*****");
+                test::stream tr(ioc);
+                ts.connect(tr);
+
+                basic_flat_buffer<alloc_type> b{alloc_type(arena)};
+                http::request<string_body, fields> req(
+                    std::piecewise_construct,
+                    std::make_tuple(alloc_type(arena)),
+                    std::make_tuple(alloc_type(arena)));
+                http::read(ts, b, req);
+                BEAST_EXPECT(req[http::field::user_agent] == "test");
+                BEAST_EXPECT(req.body() == "*****");
+
+                http::response<dynamic_body, fields> res(
+                    std::piecewise_construct,
+                    std::make_tuple(alloc_type(arena)),
+                    std::make_tuple(alloc_type(arena)));
+                res.result(http::status::ok);
+                res.set(http::field::server, "test");
+                ostream(res.body()) << req.body();
+                res.prepare_payload();
+                http::write(ts, res);
+                BEAST_EXPECT(tr.str() ==
+                    "HTTP/1.1 200 OK\r\n"
+                    "Server: test\r\n"
+                    "Content-Length: 5\r\n"
+                    "\r\n"
+                    "*****");
+                BEAST_EXPECT(arena.size() > 0);
+            }
+            arena.reset();
+            BEAST_EXPECT(arena.size() == 0);
+
+            // After the first request no more memory is needed
+            if(i == 1)
+                cap = arena.capacity();
+            else if(i > 1)
+                BEAST_EXPECT(arena.capacity() == cap);
+        }
+    }
+
+    void
+    run() override
+    {
+        testArena();
+        testAllocator();
+        testDynamicBuffer();
+        testHttp();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,monotonic_arena);
+
+} // beast
+} // boost
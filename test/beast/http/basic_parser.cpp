@@ -19,11 +19,14 @@
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/ostream.hpp>
+#include <boost/beast/http/buffer_body.hpp>
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/test/fuzz.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 
+#include <vector>
+
 namespace boost {
 namespace beast {
 namespace http {
@@ -1284,6 +1287,212 @@ public:
         bad ("ffffffffffffffffffffff\r\n");
     }
 
+    void
+    testChunkSize()
+    {
+        // The bounded parse_hex reads eight octets at a
+        // time, and must agree with the unbounded one.
+        using base = detail::basic_parser_base;
+        auto const check =
+            [&](string_view s)
+            {
+                std::string const in =
+                    std::string(s) + "\r\n0123456789";
+                std::uint64_t v0 = 0;
+                std::uint64_t v1 = 0;
+                auto it0 = in.data();
+                auto it1 = in.data();
+                auto const r0 = base::parse_hex(it0, v0);
+                auto const r1 = base::parse_hex(
+                    it1, in.data() + in.size(), v1);
+                BEAST_EXPECTS(r0 == r1, s);
+                if(r0 && r1)
+                {
+                    BEAST_EXPECTS(v0 == v1, s);
+                    BEAST_EXPECTS(it0 == it1, s);
+                }
+            };
+        check("0");
+        check("5");
+        check("a");
+        check("F");
+        check("1f");
+        check("0004");
+        check("abcdef");
+        check("ABCDEF");
+        check("1234567");
+        check("12345678");
+        check("123456789");
+        check("7fffffffffffffff");
+        check("ffffffffffffffff");
+        check("10000000000000000");
+        check("4;ext=1");
+        check("");
+        check(";");
+        check("g");
+        check("G");
+        check("@");
+        check("`");
+        check("/");
+        check(":");
+        check("\xb0");
+        check("3\xb0");
+
+        // every digit in every position
+        std::string const digits =
+            "0123456789abcdefABCDEF";
+        for(std::size_t n = 1; n <= 8; ++n)
+            for(auto c : digits)
+                for(std::size_t i = 0; i < n; ++i)
+                {
+                    std::string s(n, '1');
+                    s[i] = c;
+                    check(s);
+                }
+
+        {
+            std::uint64_t v;
+            string_view s = "2f;a=b\r\n";
+            auto it = s.data();
+            BEAST_EXPECT(base::parse_hex(
+                it, s.data() + s.size(), v));
+            BEAST_EXPECT(v == 47);
+            BEAST_EXPECT(*it == ';');
+        }
+    }
+
+    struct coalescing_parser : test_parser<false>
+    {
+        coalescing_parser()
+        {
+            this->coalesce_chunks(true);
+        }
+
+        explicit
+        coalescing_parser(test::fail_count& fc)
+            : test_parser<false>(fc)
+        {
+            this->coalesce_chunks(true);
+        }
+    };
+
+    void
+    testCoalesceChunks()
+    {
+        std::string const big(5000, '*');
+        std::string const msg =
+            "HTTP/1.1 200 OK\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "1\r\na\r\n"
+            "2;x=y\r\nbc\r\n"
+            "3\r\ndef\r\n"
+            "1388\r\n" + big + "\r\n"
+            "4\r\nghij\r\n"
+            "0\r\n"
+            "Expires: never\r\n"
+            "\r\n";
+
+        {
+            error_code ec;
+            coalescing_parser p;
+            BEAST_EXPECT(p.coalesce_chunks());
+            p.eager(true);
+            auto const n = p.put(net::buffer(msg), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == msg.size());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(p.body == "abcdef" + big + "ghij");
+            BEAST_EXPECT(p.got_on_chunk == 6);
+            BEAST_EXPECT(p.got_on_chunk_body == 3);
+            BEAST_EXPECT(p.got_on_complete == 1);
+        }
+        {
+            // without eager, each chunk is still delivered
+            error_code ec;
+            coalescing_parser p;
+            std::size_t used = 0;
+            while(! p.is_done())
+            {
+                used += p.put(net::buffer(
+                    msg.data() + used, msg.size() - used), ec);
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    break;
+            }
+            BEAST_EXPECT(p.body == "abcdef" + big + "ghij");
+        }
+        {
+            error_code ec;
+            test_parser<false> p;
+            p.eager(true);
+            BEAST_EXPECT(! p.coalesce_chunks());
+            p.put(net::buffer(msg), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.got_on_chunk_body == 5);
+        }
+
+        // split at every position
+        parsegrind<coalescing_parser>(msg,
+            [&](coalescing_parser const& p)
+            {
+                BEAST_EXPECT(p.body == "abcdef" + big + "ghij");
+                BEAST_EXPECT(p.got_on_chunk == 6);
+                BEAST_EXPECT(p.fields.at("Expires") == "never");
+            });
+
+        // errors from the body are reported
+        for(std::size_t i = 0; i < 100; ++i)
+        {
+            test::fail_count fc(i);
+            coalescing_parser p(fc);
+            p.eager(true);
+            error_code ec;
+            p.put(net::buffer(msg), ec);
+            if(! ec)
+            {
+                BEAST_EXPECT(p.is_done());
+                break;
+            }
+            BEAST_EXPECTS(ec == test::error::test_failure,
+                ec.message());
+        }
+
+        // a body which consumes part of the held back octets
+        for(std::size_t size : {1, 3, 7, 4096})
+        {
+            response_parser<buffer_body> p;
+            p.eager(true);
+            p.coalesce_chunks(true);
+            std::size_t headers = 0;
+            auto cb =
+                [&headers](std::uint64_t, string_view, error_code&)
+                {
+                    ++headers;
+                };
+            p.on_chunk_header(cb);
+            std::vector<char> buf(size);
+            std::string body;
+            std::size_t used = 0;
+            error_code ec;
+            while(! p.is_done())
+            {
+                p.get().body().data = buf.data();
+                p.get().body().size = buf.size();
+                used += p.put(net::buffer(
+                    msg.data() + used, msg.size() - used), ec);
+                if(ec == error::need_buffer)
+                    ec = {};
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    break;
+                body.append(buf.data(),
+                    buf.size() - p.get().body().size);
+            }
+            BEAST_EXPECT(used == msg.size());
+            BEAST_EXPECT(body == "abcdef" + big + "ghij");
+            BEAST_EXPECT(headers == 6);
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void
@@ -1310,6 +1519,8 @@ public:
         testRegression1();
         testIssue1211();
         testIssue1267();
+        testChunkSize();
+        testCoalesceChunks();
     }
 };
 
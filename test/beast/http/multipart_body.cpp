@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/multipart_body.hpp>
+
+#include <boost/beast/core/file_stdio.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class multipart_body_test : public beast::unit_test::suite
+{
+public:
+    net::io_context ioc_;
+
+    struct result
+    {
+        std::string name;
+        std::string filename;
+        std::string type;
+        std::string data;
+        std::uint64_t size = 0;
+    };
+
+    static
+    std::string
+    make_body(std::string const& boundary,
+        std::string const& big)
+    {
+        return
+            "preamble\r\n"
+            "--" + boundary + "\r\n"
+            "Content-Disposition: form-data; name=\"field\"\r\n"
+            "\r\n"
+            "value\r\n"
+            "--" + boundary + "  \r\n"
+            "Content-Disposition: form-data; name=\"file\"; filename=\"a.txt\"\r\n"
+            "Content-Type: text/plain\r\n"
+            "\r\n" +
+            big + "\r\n"
+            "--" + boundary + "\r\n"
+            "\r\n"
+            "\r\n--" + boundary.substr(0, 4) + "\r\n"
+            "--" + boundary + "--\r\n"
+            "epilogue";
+    }
+
+    static
+    std::string
+    make_message(std::string const& body,
+        std::string const& content_type, bool chunked)
+    {
+        std::string s =
+            "POST /upload HTTP/1.1\r\n"
+            "Content-Type: " + content_type + "\r\n";
+        if(! chunked)
+            return s +
+                "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                "\r\n" + body;
+        s += "Transfer-Encoding: chunked\r\n\r\n";
+        // Chunks whose edges fall inside the delimiters
+        for(std::size_t pos = 0; pos < body.size();)
+        {
+            auto const n = (std::min<std::size_t>)(
+                body.size() - pos, 3 + pos % 17);
+            char buf[20];
+            std::snprintf(buf, sizeof(buf), "%x\r\n",
+                static_cast<unsigned>(n));
+            s += buf;
+            s.append(body, pos, n);
+            s += "\r\n";
+            pos += n;
+        }
+        return s + "0\r\n\r\n";
+    }
+
+    error_code
+    doRead(std::string const& msg,
+        std::size_t read_size,
+        std::vector<result>& v,
+        std::string const& path = {})
+    {
+        test::stream ts{ioc_, msg};
+        ts.read_size(read_size);
+        request_parser<multipart_body> p;
+        p.body_limit((std::numeric_limits<std::uint64_t>::max)());
+        auto& body = p.get().body();
+        body.on_part(
+            [&](multipart_body::part& part, error_code& ec)
+            {
+                v.emplace_back();
+                v.back().name = part.name();
+                v.back().filename = part.filename();
+                v.back().type = std::string(
+                    part.header()[field::content_type]);
+                if(! path.empty() && ! part.filename().empty())
+                    part.open(path.c_str(), ec);
+                else
+                    part.on_data(
+                        [&v](string_view s, error_code&)
+                        {
+                            v.back().data.append(s.data(), s.size());
+                        });
+            });
+        body.on_part_end(
+            [&](multipart_body::part& part, error_code&)
+            {
+                v.back().size = part.size();
+            });
+        flat_buffer b;
+        error_code ec;
+        read(ts, b, p, ec);
+        return ec;
+    }
+
+    void
+    testParse()
+    {
+        std::string const boundary = "----WebKitFormBoundary7MA4YWxk";
+        std::string big;
+        for(int i = 0; big.size() < 100000; ++i)
+            big += "line " + std::to_string(i) + "\r\n-\r\n--";
+        auto const body = make_body(boundary, big);
+        for(bool chunked : {false, true})
+        {
+            auto const msg = make_message(body,
+                "multipart/form-data; boundary=" + boundary, chunked);
+            for(std::size_t read_size : {1, 7, 64, 4096, 65536})
+            {
+                std::vector<result> v;
+                auto const ec = doRead(msg, read_size, v);
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    continue;
+                if(! BEAST_EXPECT(v.size() == 3))
+                    continue;
+                BEAST_EXPECT(v[0].name == "field");
+                BEAST_EXPECT(v[0].filename.empty());
+                BEAST_EXPECT(v[0].data == "value");
+                BEAST_EXPECT(v[0].size == 5);
+                BEAST_EXPECT(v[1].name == "file");
+                BEAST_EXPECT(v[1].filename == "a.txt");
+                BEAST_EXPECT(v[1].type == "text/plain");
+                BEAST_EXPECT(v[1].data == big);
+                BEAST_EXPECT(v[1].size == big.size());
+                BEAST_EXPECT(v[2].name.empty());
+                BEAST_EXPECT(v[2].data ==
+                    "\r\n--" + boundary.substr(0, 4));
+            }
+        }
+        {
+            // Quoted boundary, body begins with a delimiter
+            std::string const s =
+                "--xyz\r\n"
+                "\r\n"
+                "1\r\n"
+                "--xyz--";
+            std::vector<result> v;
+            auto const ec = doRead(make_message(s,
+                "Multipart/Mixed; charset=utf-8; boundary=\"xyz\"",
+                false), 3, v);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(v.size() == 1 && v[0].data == "1");
+        }
+    }
+
+    void
+    testFile()
+    {
+        auto const temp = boost::filesystem::unique_path();
+        auto const path = temp.string<std::string>();
+        std::string const boundary = "abcdefgh";
+        std::string big(300000, '*');
+        for(std::size_t i = 0; i < big.size(); i += 1000)
+            big[i] = '\r';
+        auto const msg = make_message(make_body(boundary, big),
+            "multipart/form-data; boundary=abcdefgh", false);
+        std::vector<result> v;
+        auto const ec = doRead(msg, 8192, v, path);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(BEAST_EXPECT(v.size() == 3))
+        {
+            BEAST_EXPECT(v[1].data.empty());
+            BEAST_EXPECT(v[1].size == big.size());
+        }
+        file_stdio f;
+        error_code ec2;
+        f.open(path.c_str(), file_mode::read, ec2);
+        if(BEAST_EXPECTS(! ec2, ec2.message()))
+        {
+            std::string s;
+            s.resize(static_cast<std::size_t>(f.size(ec2)));
+            BEAST_EXPECT(f.read(&s[0], s.size(), ec2) == s.size());
+            BEAST_EXPECT(s == big);
+            f.close(ec2);
+        }
+        boost::filesystem::remove(temp, ec2);
+    }
+
+    void
+    testErrors()
+    {
+        auto const check =
+            [&](std::string const& body,
+                std::string const& content_type,
+                error_code const& expected)
+            {
+                std::vector<result> v;
+                auto const ec = doRead(
+                    make_message(body, content_type, false), 1024, v);
+                BEAST_EXPECTS(ec == expected, ec.message());
+            };
+        std::string const ok = "--b\r\n\r\nx\r\n--b--";
+        check(ok, "multipart/form-data; boundary=b", {});
+        check(ok, "multipart/form-data", error::bad_multipart);
+        check(ok, "text/plain; boundary=b", error::bad_multipart);
+        check(ok, "multipart/form-data; boundary=\"b@\"",
+            error::bad_multipart);
+        check(ok, "multipart/form-data; boundary=" +
+            std::string(71, 'b'), error::bad_multipart);
+        // Missing close delimiter
+        check("--b\r\n\r\nx\r\n--b\r\n",
+            "multipart/form-data; boundary=b", error::bad_multipart);
+        check("no delimiter",
+            "multipart/form-data; boundary=b", error::bad_multipart);
+        // Bad delimiter line
+        check("--b\r\n\r\nx\r\n--bc\r\n\r\n--b--",
+            "multipart/form-data; boundary=b", error::bad_multipart);
+        // Bad part header
+        check("--b\r\nbad header\r\n\r\nx\r\n--b--",
+            "multipart/form-data; boundary=b", error::bad_multipart);
+        check("--b\r\n: x\r\n\r\nx\r\n--b--",
+            "multipart/form-data; boundary=b", error::bad_multipart);
+        // Part header too large
+        check("--b\r\nX: " + std::string(9000, 'x') +
+            "\r\n\r\nx\r\n--b--",
+            "multipart/form-data; boundary=b", error::header_limit);
+        {
+            // Error from a callback
+            test::stream ts{ioc_, make_message(ok,
+                "multipart/form-data; boundary=b", false)};
+            request_parser<multipart_body> p;
+            p.get().body().on_part(
+                [](multipart_body::part& part, error_code&)
+                {
+                    part.on_data(
+                        [](string_view, error_code& ec)
+                        {
+                            ec = net::error::no_buffer_space;
+                        });
+                });
+            flat_buffer b;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(ec == net::error::no_buffer_space, ec.message());
+        }
+    }
+
+    void
+    run() override
+    {
+        testParse();
+        testFile();
+        testErrors();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,multipart_body);
+
+} // http
+} // beast
+} // boost
@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/prepared_message.hpp>
+
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class prepared_message_test : public beast::unit_test::suite
+{
+public:
+    net::io_context ioc_;
+
+    static
+    response<string_body>
+    make_response()
+    {
+        response<string_body> res{status::ok, 11};
+        res.set(field::server, "test");
+        res.set(field::date, "Thu, 01 Jan 1970 00:00:00 GMT");
+        res.set(field::content_type, "application/json");
+        res.body() = "{\"status\":\"ok\"}";
+        res.prepare_payload();
+        return res;
+    }
+
+    template<bool isRequest, class Body, class Fields>
+    static
+    std::string
+    to_string(message<isRequest, Body, Fields> const& m)
+    {
+        std::stringstream ss;
+        ss << m;
+        return ss.str();
+    }
+
+    static
+    std::string
+    replace(std::string s,
+        std::string const& from, std::string const& to)
+    {
+        auto const pos = s.find(from);
+        if(pos != std::string::npos)
+            s.replace(pos, from.size(), to);
+        return s;
+    }
+
+    template<class F>
+    void
+    expectInvalid(F const& f)
+    {
+        try
+        {
+            f();
+            fail("", __FILE__, __LINE__);
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testPrepare()
+    {
+        {
+            prepared_message m;
+            BEAST_EXPECT(m.size() == 0);
+            BEAST_EXPECT(buffer_bytes(m.buffers()) == 0);
+        }
+        {
+            auto const res = make_response();
+            prepared_message m{res};
+            BEAST_EXPECT(buffers_to_string(m.buffers()) ==
+                to_string(res));
+            BEAST_EXPECT(m.size() == to_string(res).size());
+        }
+        {
+            // Chunked
+            request<string_body> req{verb::post, "/", 11};
+            req.body() = "*****";
+            req.chunked(true);
+            prepared_message m{req};
+            BEAST_EXPECT(buffers_to_string(m.buffers()) ==
+                to_string(req));
+            expectInvalid([&]
+            {
+                prepared_message{req, {field::transfer_encoding}};
+            });
+        }
+        {
+            auto const res = make_response();
+            expectInvalid([&]
+            {
+                prepared_message{res, {field::location}};
+            });
+            expectInvalid([&]
+            {
+                prepared_message{res, {field::date, field::date}};
+            });
+            expectInvalid([&]
+            {
+                prepared_message{res, {field::content_length}};
+            });
+            expectInvalid([&]
+            {
+                prepared_message{res, {
+                    field::date, field::server, field::content_type,
+                    field::cache_control, field::connection}};
+            });
+            prepared_message m{res, {field::date}};
+            expectInvalid([&]
+            {
+                m.set(field::server, "x");
+            });
+        }
+    }
+
+    void
+    testSet()
+    {
+        auto const res = make_response();
+        prepared_message const m0{res, {
+            field::content_type, field::date, field::server}};
+        BEAST_EXPECT(buffers_to_string(m0.buffers()) ==
+            to_string(res));
+
+        prepared_message m1{m0};
+        m1.set(field::date, "Fri, 02 Jan 1970 00:00:00 GMT");
+        prepared_message m2{m0};
+        m2.set(field::content_type, "text/plain");
+        m2.set(field::server, "Beast");
+        m2.set(field::date, "");
+
+        // Other copies are unchanged
+        BEAST_EXPECT(buffers_to_string(m0.buffers()) ==
+            to_string(res));
+
+        auto const s1 = replace(to_string(res),
+            "Thu, 01", "Fri, 02");
+        BEAST_EXPECT(buffers_to_string(m1.buffers()) == s1);
+        BEAST_EXPECT(m1.size() == s1.size());
+
+        auto const s = buffers_to_string(m2.buffers());
+        BEAST_EXPECT(s.size() == m2.size());
+        BEAST_EXPECT(s.find("Content-Type: text/plain\r\n") !=
+            std::string::npos);
+        BEAST_EXPECT(s.find("Server: Beast\r\n") !=
+            std::string::npos);
+        BEAST_EXPECT(s.find("Content-Length: 15\r\n") !=
+            std::string::npos);
+        BEAST_EXPECT(s.find("Date: \r\n") != std::string::npos);
+
+        m2.clear();
+        BEAST_EXPECT(buffers_to_string(m2.buffers()) ==
+            buffers_to_string(m0.buffers()));
+    }
+
+    void
+    testWrite()
+    {
+        auto const res = make_response();
+        prepared_message const m{res, {field::date}};
+        {
+            test::stream ts{ioc_}, tr{ioc_};
+            ts.connect(tr);
+            write(ts, m);
+            BEAST_EXPECT(tr.str() == to_string(res));
+        }
+        {
+            test::stream ts{ioc_}, tr{ioc_};
+            ts.connect(tr);
+            ts.close();
+            error_code ec;
+            write(ts, m, ec);
+            BEAST_EXPECT(ec);
+        }
+        {
+            // Many concurrent writes, each
+            // with its own value of a field
+            std::vector<std::unique_ptr<test::stream>> v;
+            std::size_t done = 0;
+            for(int i = 0; i < 10; ++i)
+            {
+                v.emplace_back(new test::stream{ioc_});
+                v.emplace_back(new test::stream{ioc_});
+                v[v.size() - 2]->connect(*v.back());
+                v[v.size() - 2]->write_size(7);
+                prepared_message mc{m};
+                mc.set(field::date, std::to_string(i));
+                async_write(*v[v.size() - 2], mc,
+                    [&](error_code ec, std::size_t n)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        BEAST_EXPECT(n > 0);
+                        ++done;
+                    });
+            }
+            ioc_.run();
+            ioc_.restart();
+            BEAST_EXPECT(done == 10);
+            for(int i = 0; i < 10; ++i)
+            {
+                BEAST_EXPECT(v[2 * i + 1]->str() ==
+                    replace(to_string(res),
+                        "Thu, 01 Jan 1970 00:00:00 GMT",
+                        std::to_string(i)));
+            }
+        }
+    }
+
+    void
+    run() override
+    {
+        testPrepare();
+        testSet();
+        testWrite();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,prepared_message);
+
+} // http
+} // beast
+} // boost
@@ -12,12 +12,15 @@
 
 #include "test_parser.hpp"
 
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/empty_body.hpp>
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/vector_body.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/test/yield_to.hpp>
@@ -25,6 +28,8 @@
 #include <boost/asio/strand.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <atomic>
+#include <string>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -424,6 +429,168 @@ public:
         BEAST_EXPECTS(! ec, ec.message());
     }
 
+    static
+    std::string
+    to_string(std::string const& s)
+    {
+        return s;
+    }
+
+    static
+    std::string
+    to_string(std::vector<char> const& v)
+    {
+        return {v.data(), v.size()};
+    }
+
+    static
+    std::string
+    to_string(multi_buffer const& b)
+    {
+        return buffers_to_string(b.data());
+    }
+
+    template<class Body>
+    void
+    doDirectBody(std::size_t read_size, yield_context do_yield)
+    {
+        std::string body(100000, 0);
+        for(std::size_t i = 0; i < body.size(); ++i)
+            body[i] = static_cast<char>('a' + i % 26);
+        std::string const s =
+            "POST / HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body +
+            "GET / HTTP/1.1\r\n"
+            "\r\n";
+        auto const check =
+            [&](request_parser<Body>& p,
+                flat_buffer& b, test::stream& ts)
+            {
+                BEAST_EXPECT(p.is_done());
+                BEAST_EXPECT(to_string(p.get().body()) == body);
+                // The next message is still available
+                request_parser<empty_body> p2;
+                error_code ec;
+                read(ts, b, p2, ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(p2.get().method() == verb::get);
+            };
+        {
+            test::stream ts{ioc_, s};
+            ts.read_size(read_size);
+            flat_buffer b;
+            request_parser<Body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            auto const n = read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == s.size() - ts.buffer().size());
+            check(p, b, ts);
+        }
+        {
+            test::stream ts{ioc_, s};
+            ts.read_size(read_size);
+            flat_buffer b;
+            request_parser<Body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            auto const n = async_read(ts, b, p, do_yield[ec]);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == s.size() - ts.buffer().size());
+            check(p, b, ts);
+        }
+
+        // Truncated body
+        auto const t = s.substr(0, s.size() - 5000 - 18);
+        {
+            test::stream ts{ioc_, t};
+            ts.read_size(read_size);
+            ts.close_remote();
+            flat_buffer b;
+            request_parser<Body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+            // Only the octets received are in the body
+            BEAST_EXPECT(to_string(p.get().body()) ==
+                body.substr(0, body.size() - 5000));
+        }
+        {
+            test::stream ts{ioc_, t};
+            ts.read_size(read_size);
+            ts.close_remote();
+            flat_buffer b;
+            request_parser<Body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            async_read(ts, b, p, do_yield[ec]);
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+            BEAST_EXPECT(to_string(p.get().body()) ==
+                body.substr(0, body.size() - 5000));
+        }
+    }
+
+    // Counts the body octets copied in through put
+    struct counted_body
+    {
+        using value_type = std::string;
+
+        static
+        std::size_t&
+        count()
+        {
+            static std::size_t n = 0;
+            return n;
+        }
+
+        class reader : public string_body::reader
+        {
+        public:
+            using string_body::reader::reader;
+
+            template<class ConstBufferSequence>
+            std::size_t
+            put(ConstBufferSequence const& buffers,
+                error_code& ec)
+            {
+                count() += buffer_bytes(buffers);
+                return string_body::reader::put(buffers, ec);
+            }
+        };
+    };
+
+    void
+    testDirectBody(yield_context do_yield)
+    {
+        {
+            // Only octets received with the header are copied
+            std::string const body(100000, '*');
+            test::stream ts{ioc_,
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: 100000\r\n"
+                "\r\n" + body};
+            flat_buffer b;
+            request_parser<counted_body> p;
+            p.body_limit(body.size());
+            counted_body::count() = 0;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == body);
+            BEAST_EXPECT(counted_body::count() > 0);
+            BEAST_EXPECT(counted_body::count() < 1024);
+        }
+
+        for(std::size_t n : { 100, 4096, 65536, 200000 })
+        {
+            doDirectBody<string_body>(n, do_yield);
+            doDirectBody<vector_body<char>>(n, do_yield);
+            doDirectBody<dynamic_body>(n, do_yield);
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     template<class Parser, class Pred>
@@ -547,6 +714,10 @@ public:
         {
             testEof(yield);
         });
+        yield_to([&](yield_context yield)
+        {
+            testDirectBody(yield);
+        });
 
         testIoService();
         testRegression430();
@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/relay.hpp>
+
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class relay_test : public beast::unit_test::suite
+{
+public:
+    net::io_context ioc_;
+
+    // Adds a field to every relayed header
+    struct via
+    {
+        template<bool isRequest>
+        void
+        operator()(
+            message<isRequest, buffer_body, fields>& m,
+            error_code& ec) const
+        {
+            m.set(field::via, "1.1 relay");
+            ec = {};
+        }
+    };
+
+    static
+    std::string
+    make_body(std::size_t n)
+    {
+        std::string s(n, 0);
+        for(std::size_t i = 0; i < n; ++i)
+            s[i] = static_cast<char>('a' + i % 26);
+        return s;
+    }
+
+    template<bool isRequest>
+    void
+    check(string_view s, string_view body)
+    {
+        test::stream ts{ioc_, s};
+        ts.close_remote();
+        flat_buffer b;
+        message<isRequest, string_body> m;
+        error_code ec;
+        read(ts, b, m, ec);
+        if(! BEAST_EXPECTS(! ec, ec.message()))
+            return;
+        BEAST_EXPECT(m[field::via] == "1.1 relay");
+        BEAST_EXPECT(m.body() == body);
+    }
+
+    template<bool isRequest>
+    void
+    doBuffered(std::string const& s,
+        string_view body, std::size_t read_size)
+    {
+        test::stream in{ioc_, s};
+        in.read_size(read_size);
+        test::stream out{ioc_}, peer{ioc_};
+        out.connect(peer);
+        multi_buffer b;
+        error_code ec = test::error::test_failure;
+        std::size_t n = 0;
+        async_relay<isRequest>(out, in, b, via{},
+            [&](error_code ec_, std::size_t n_)
+            {
+                ec = ec_;
+                n = n_;
+            });
+        ioc_.run();
+        ioc_.restart();
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(n == peer.str().size());
+        check<isRequest>(peer.str(), body);
+    }
+
+    void
+    testBuffered()
+    {
+        auto const body = make_body(20000);
+        for(std::size_t n : { 1, 7, 1000, 100000 })
+        {
+            doBuffered<true>(
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: 20000\r\n"
+                "\r\n" + body, body, n);
+            doBuffered<true>(
+                "GET / HTTP/1.1\r\n"
+                "\r\n", "", n);
+            doBuffered<false>(
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "4\r\nabcd\r\n"
+                "3\r\nefg\r\n"
+                "0\r\n\r\n", "abcdefg", n);
+        }
+    }
+
+    // Returns two connected loopback sockets
+    static
+    void
+    connect(
+        net::ip::tcp::socket& s1,
+        net::ip::tcp::socket& s2)
+    {
+        net::ip::tcp::acceptor a(s1.get_executor(),
+            {net::ip::address_v4::loopback(), 0});
+        s1.connect(a.local_endpoint());
+        a.accept(s2);
+    }
+
+    void
+    doSockets(std::string const& s,
+        string_view body, std::size_t prefix, bool partial)
+    {
+        using net::ip::tcp;
+        tcp::socket client{ioc_}, in{ioc_};
+        tcp::socket out{ioc_}, server{ioc_};
+        connect(client, in);
+        connect(out, server);
+
+        // Part of the message is already buffered
+        flat_buffer b;
+        b.commit(net::buffer_copy(b.prepare(prefix),
+            net::buffer(s.data(), prefix)));
+        net::async_write(client,
+            net::buffer(s.data() + prefix, s.size() - prefix),
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                client.shutdown(tcp::socket::shutdown_send, ec);
+            });
+
+        auto const in_nb = in.native_non_blocking();
+        auto const out_nb = out.native_non_blocking();
+        error_code ec = test::error::test_failure;
+        async_relay<true>(out, in, b, via{},
+            [&](error_code ec_, std::size_t)
+            {
+                ec = ec_;
+                // The caller's modes are restored
+                BEAST_EXPECT(in.native_non_blocking() == in_nb);
+                BEAST_EXPECT(out.native_non_blocking() == out_nb);
+                out.shutdown(tcp::socket::shutdown_send, ec_);
+            });
+
+        flat_buffer rb;
+        request_parser<string_body> p;
+        p.body_limit(body.size());
+        error_code rec = test::error::test_failure;
+        async_read(server, rb, p,
+            [&](error_code ec_, std::size_t)
+            {
+                rec = ec_;
+            });
+        ioc_.run();
+        ioc_.restart();
+        if(partial)
+        {
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+            BEAST_EXPECTS(rec == error::partial_message, rec.message());
+            return;
+        }
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECTS(! rec, rec.message());
+        BEAST_EXPECT(p.get()[field::via] == "1.1 relay");
+        BEAST_EXPECT(p.get().body() == body);
+    }
+
+    void
+    testSockets()
+    {
+        auto const body = make_body(3000000);
+        std::string const s =
+            "POST / HTTP/1.1\r\n"
+            "Content-Length: 3000000\r\n"
+            "\r\n" + body;
+        auto const header = s.size() - body.size();
+        doSockets(s, body, 0, false);
+        doSockets(s, body, header, false);
+        doSockets(s, body, header + 10000, false);
+        doSockets(s, body, s.size(), false);
+        doSockets(s.substr(0, s.size() - 100000),
+            body, header + 100, true);
+
+        // Chunked bodies are not spliced
+        doSockets(
+            "POST / HTTP/1.1\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "4\r\nabcd\r\n"
+            "0\r\n\r\n", "abcd", 10, false);
+    }
+
+    void
+    run() override
+    {
+        testBuffered();
+        testSockets();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,relay);
+
+} // http
+} // beast
+} // boost
@@ -0,0 +1,382 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/serialize.hpp>
+
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/vector_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/static_buffer.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <sstream>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class serialize_test : public beast::unit_test::suite
+{
+public:
+    // A body which only a non-const writer can produce
+    struct mutable_body
+    {
+        using value_type = std::string;
+
+        static
+        std::uint64_t
+        size(value_type const& body)
+        {
+            return body.size();
+        }
+
+        class writer
+        {
+            value_type& body_;
+
+        public:
+            using const_buffers_type =
+                net::const_buffer;
+
+            template<bool isRequest, class Fields>
+            writer(
+                header<isRequest, Fields>&,
+                value_type& b)
+                : body_(b)
+            {
+            }
+
+            void
+            init(error_code& ec)
+            {
+                ec = {};
+            }
+
+            boost::optional<std::pair<const_buffers_type, bool>>
+            get(error_code& ec)
+            {
+                ec = {};
+                return {{const_buffers_type{
+                    body_.data(), body_.size()}, false}};
+            }
+        };
+    };
+
+    // A body whose size need not match what its writer produces
+    struct wrong_size_body
+    {
+        struct value_type
+        {
+            std::string s;
+            std::uint64_t size = 0;
+        };
+
+        static
+        std::uint64_t
+        size(value_type const& body)
+        {
+            return body.size;
+        }
+
+        class writer
+        {
+            value_type const& body_;
+
+        public:
+            using const_buffers_type =
+                net::const_buffer;
+
+            template<bool isRequest, class Fields>
+            writer(
+                header<isRequest, Fields> const&,
+                value_type const& b)
+                : body_(b)
+            {
+            }
+
+            void
+            init(error_code& ec)
+            {
+                ec = {};
+            }
+
+            boost::optional<std::pair<const_buffers_type, bool>>
+            get(error_code& ec)
+            {
+                ec = {};
+                return {{const_buffers_type{
+                    body_.s.data(), body_.s.size()}, false}};
+            }
+        };
+    };
+
+    template<bool isRequest, class Body, class Fields>
+    static
+    std::string
+    to_string(message<isRequest, Body, Fields> const& m)
+    {
+        std::stringstream ss;
+        ss << m;
+        return ss.str();
+    }
+
+    template<class Message>
+    std::string
+    serialized(Message& m)
+    {
+        flat_buffer b;
+        auto const n = serialize(m, b);
+        BEAST_EXPECT(n == b.size());
+        return buffers_to_string(b.data());
+    }
+
+    void
+    testSized()
+    {
+        {
+            response<string_body> res{status::ok, 11};
+            res.set(field::server, "test");
+            res.body() = "Hello, world!";
+            res.prepare_payload();
+            BEAST_EXPECT(serialized(res) == to_string(res));
+            auto const& cres = res;
+            BEAST_EXPECT(serialized(cres) == to_string(res));
+        }
+        {
+            request<string_body> req{verb::post, "/path", 11};
+            req.set(field::user_agent, "test");
+            req.body() = std::string(5000, '*');
+            req.prepare_payload();
+            BEAST_EXPECT(serialized(req) == to_string(req));
+        }
+        {
+            request<empty_body> req;
+            req.method_string("PURGE");
+            req.target("/");
+            req.version(10);
+            BEAST_EXPECT(serialized(req) ==
+                "PURGE / HTTP/1.0\r\n\r\n");
+        }
+        {
+            response<empty_body> res{status::not_found, 11};
+            res.reason("Gone Fishing");
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 404 Gone Fishing\r\n\r\n");
+        }
+        {
+            // chunked, as one chunk
+            response<vector_body<char>> res{status::ok, 11};
+            res.body().assign(300, 'x');
+            res.chunked(true);
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "12c\r\n" + std::string(300, 'x') + "\r\n"
+                "0\r\n\r\n");
+        }
+        {
+            response<string_body> res{status::ok, 11};
+            res.chunked(true);
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "0\r\n\r\n");
+        }
+        {
+            response<mutable_body> res{status::ok, 11};
+            res.body() = "*";
+            res.prepare_payload();
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 1\r\n"
+                "\r\n"
+                "*");
+        }
+    }
+
+    void
+    testUnsized()
+    {
+        std::string const s = "Hello";
+        {
+            response<buffer_body> res{status::ok, 11};
+            res.body().data = const_cast<char*>(s.data());
+            res.body().size = s.size();
+            res.body().more = false;
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 200 OK\r\n"
+                "\r\n"
+                "Hello");
+        }
+        {
+            response<buffer_body> res{status::ok, 11};
+            res.body().data = const_cast<char*>(s.data());
+            res.body().size = s.size();
+            res.body().more = false;
+            res.chunked(true);
+            BEAST_EXPECT(serialized(res) ==
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "5\r\nHello\r\n"
+                "0\r\n\r\n");
+        }
+    }
+
+    void
+    testBuffers()
+    {
+        response<string_body> res{status::ok, 11};
+        res.set(field::server, "test");
+        res.body() = std::string(1000, '*');
+        res.prepare_payload();
+        auto const expected = to_string(res);
+
+        // appends to what is there
+        {
+            flat_buffer b;
+            b.commit(net::buffer_copy(
+                b.prepare(3), net::buffer("abc", 3)));
+            auto const n = serialize(res, b);
+            BEAST_EXPECT(n == expected.size());
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                "abc" + expected);
+        }
+
+        // output split across buffers
+        {
+            multi_buffer b(2048);
+            b.commit(net::buffer_copy(
+                b.prepare(100), net::buffer(std::string(100, '-'))));
+            b.prepare(1000);
+            b.commit(0);
+            auto const n = serialize(res, b);
+            BEAST_EXPECT(n == expected.size());
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                std::string(100, '-') + expected);
+        }
+
+        {
+            std::string s;
+            auto b = net::dynamic_buffer(s);
+            serialize(res, b);
+            BEAST_EXPECT(s == expected);
+        }
+
+        // too small
+        {
+            static_buffer<64> b;
+            try
+            {
+                serialize(res, b);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(std::length_error const&)
+            {
+                pass();
+            }
+            BEAST_EXPECT(b.size() == 0);
+        }
+    }
+
+    void
+    testError()
+    {
+        response<buffer_body> res{status::ok, 11};
+        res.body().data = nullptr;
+        res.body().more = true;
+        {
+            flat_buffer b;
+            error_code ec;
+            serialize(res, b, ec);
+            BEAST_EXPECT(ec == error::need_buffer);
+        }
+        {
+            flat_buffer b;
+            try
+            {
+                serialize(res, b);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(system_error const& e)
+            {
+                BEAST_EXPECT(e.code() == error::need_buffer);
+            }
+        }
+    }
+
+    void
+    testWrongSize()
+    {
+        auto const check =
+            [&](std::uint64_t size, bool chunked)
+            {
+                response<wrong_size_body> res{status::ok, 11};
+                res.body().s = "Hello, world!";
+                res.body().size = size;
+                res.chunked(chunked);
+                {
+                    flat_buffer b;
+                    b.commit(net::buffer_copy(
+                        b.prepare(3), net::buffer("abc", 3)));
+                    error_code ec;
+                    auto const n = serialize(res, b, ec);
+                    BEAST_EXPECTS(ec == error::bad_content_length,
+                        ec.message());
+                    BEAST_EXPECT(n == 0);
+                    BEAST_EXPECT(buffers_to_string(b.data()) == "abc");
+                }
+                {
+                    // output split across buffers
+                    multi_buffer b(2048);
+                    b.commit(net::buffer_copy(
+                        b.prepare(100),
+                        net::buffer(std::string(100, '-'))));
+                    b.prepare(1000);
+                    b.commit(0);
+                    error_code ec;
+                    auto const n = serialize(res, b, ec);
+                    BEAST_EXPECTS(ec == error::bad_content_length,
+                        ec.message());
+                    BEAST_EXPECT(n == 0);
+                    BEAST_EXPECT(buffers_to_string(b.data()) ==
+                        std::string(100, '-'));
+                }
+            };
+        for(bool chunked : {false, true})
+        {
+            check(5, chunked);
+            check(20, chunked);
+        }
+    }
+
+    void
+    run() override
+    {
+        testSized();
+        testUnsized();
+        testBuffers();
+        testError();
+        testWrongSize();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,serialize);
+
+} // http
+} // beast
+} // boost
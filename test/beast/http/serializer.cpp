@@ -11,8 +11,12 @@
 #include <boost/beast/http/serializer.hpp>
 
 #include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <sstream>
+#include <string>
 
 namespace boost {
 namespace beast {
@@ -116,10 +120,116 @@ public:
         }
     }
 
+    struct flat_lambda
+    {
+        std::string s;
+        std::size_t count = 0;
+        std::size_t size = 0;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            count = 0;
+            for(auto it = net::buffer_sequence_begin(buffers);
+                it != net::buffer_sequence_end(buffers); ++it)
+                ++count;
+            size = buffer_bytes(buffers);
+            s.append(buffers_to_string(buffers));
+        }
+    };
+
+    template<bool isRequest, class Body, class Fields>
+    static
+    std::string
+    to_string(message<isRequest, Body, Fields> const& m)
+    {
+        std::stringstream ss;
+        ss << m;
+        return ss.str();
+    }
+
+    template<bool isRequest, class Body, class Fields>
+    void
+    doFlatten(
+        message<isRequest, Body, Fields> const& m,
+        std::size_t flatten_limit,
+        std::size_t limit,
+        bool single)
+    {
+        flat_lambda visit;
+        error_code ec;
+        serializer<isRequest, Body, Fields> sr{m};
+        sr.flatten_limit(flatten_limit);
+        sr.limit(limit);
+        std::size_t calls = 0;
+        do
+        {
+            sr.next(ec, visit);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            if(single)
+                BEAST_EXPECT(visit.count == 1);
+            sr.consume(visit.size);
+            ++calls;
+        }
+        while(! sr.is_done());
+        BEAST_EXPECT(sr.is_header_done());
+        BEAST_EXPECT(visit.s == to_string(m));
+        if(single && limit == 0)
+            BEAST_EXPECT(calls == 1);
+    }
+
+    void
+    testFlatten()
+    {
+        response<string_body> res{status::ok, 11};
+        res.set(field::server, "test");
+        res.set(field::content_type, "text/plain");
+        res.body() = "Hello, world!";
+        res.prepare_payload();
+        auto const size = to_string(res).size();
+        {
+            serializer<false, string_body> sr{res};
+            BEAST_EXPECT(sr.flatten_limit() == 0);
+        }
+
+        doFlatten(res, size, 0, true);
+        doFlatten(res, 4096, 0, true);
+        doFlatten(res, size - 1, 0, false);
+        doFlatten(res, 0, 0, false);
+        doFlatten(res, 4096, 7, true);
+
+        // chunked
+        res.chunked(true);
+        doFlatten(res, 4096, 0, true);
+        doFlatten(res, 4096, 5, true);
+
+        // empty body
+        request<string_body> req{verb::get, "/", 11};
+        doFlatten(req, 4096, 0, true);
+
+        // split is not flattened
+        {
+            flat_lambda visit;
+            error_code ec;
+            serializer<false, string_body> sr{res};
+            sr.flatten_limit(4096);
+            sr.split(true);
+            sr.next(ec, visit);
+            BEAST_EXPECT(visit.s.find("\r\n\r\n") !=
+                std::string::npos);
+            BEAST_EXPECT(visit.s.find("Hello") ==
+                std::string::npos);
+        }
+    }
+
     void
     run() override
     {
         testWriteLimit();
+        testFlatten();
     }
 };
 
@@ -41,6 +41,7 @@ public:
     int got_on_body        = 0;
     int got_content_length = 0;
     int got_on_chunk       = 0;
+    int got_on_chunk_body  = 0;
     int got_on_complete    = 0;
     std::unordered_map<
         std::string, std::string> fields;
@@ -138,6 +139,7 @@ public:
         string_view s,
         error_code& ec)
     {
+        ++got_on_chunk_body;
         body.append(s.data(), s.size());
         if(fc_)
             fc_->fail(ec);
@@ -12,6 +12,7 @@
 
 #include "test.hpp"
 
+#include <boost/beast/_experimental/test/handler.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
@@ -634,6 +635,112 @@ public:
         }
     }
 
+    void
+    testInflateInPlace()
+    {
+        // Repeats from far back, so that references reach
+        // past the buffers of earlier reads in the message
+        std::string msg;
+        {
+            std::mt19937 g;
+            std::string block;
+            for(int i = 0; i < 3000; ++i)
+                block.push_back(static_cast<char>('a' + g() % 26));
+            while(msg.size() < 40000)
+            {
+                block[g() % block.size()] = '*';
+                msg += block;
+            }
+        }
+
+        auto const check =
+            [&](permessage_deflate const& pmd, int how)
+            {
+                net::io_context ioc;
+                stream<test::stream> ws1(ioc);
+                stream<test::stream> ws2(ioc);
+                ws1.set_option(pmd);
+                ws2.set_option(pmd);
+                test::connect(ws1.next_layer(), ws2.next_layer());
+                ws1.async_handshake("test", "/", test::success_handler());
+                ws2.async_accept(test::success_handler());
+                ioc.run();
+                ioc.restart();
+                for(int i = 0; i < 3; ++i)
+                {
+                    ws1.write(net::buffer(msg));
+                    std::string s;
+                    if(how == 0)
+                    {
+                        // one contiguous buffer
+                        flat_buffer b;
+                        ws2.read(b);
+                        s = buffers_to_string(b.data());
+                    }
+                    else if(how == 1)
+                    {
+                        // small buffers, reused
+                        char buf[7];
+                        do
+                        {
+                            auto const n = ws2.read_some(
+                                net::buffer(buf));
+                            s.append(buf, n);
+                            std::memset(buf, '#', sizeof(buf));
+                        }
+                        while(! ws2.is_message_done());
+                    }
+                    else if(how == 2)
+                    {
+                        // two buffers in each read
+                        char buf[1000];
+                        do
+                        {
+                            std::array<net::mutable_buffer, 2> bs{{
+                                net::buffer(buf, 300),
+                                net::buffer(buf + 400, 600)}};
+                            auto const n = ws2.read_some(bs);
+                            s.append(buf, (std::min<std::size_t>)(n, 300));
+                            if(n > 300)
+                                s.append(buf + 400, n - 300);
+                            std::memset(buf, '#', sizeof(buf));
+                        }
+                        while(! ws2.is_message_done());
+                    }
+                    else
+                    {
+                        // asynchronous, small buffers
+                        char buf[1500];
+                        do
+                        {
+                            ws2.async_read_some(net::buffer(buf),
+                                [&](error_code ec, std::size_t n)
+                                {
+                                    BEAST_EXPECTS(! ec, ec.message());
+                                    s.append(buf, n);
+                                });
+                            ioc.run();
+                            ioc.restart();
+                            std::memset(buf, '#', sizeof(buf));
+                        }
+                        while(! ws2.is_message_done());
+                    }
+                    BEAST_EXPECT(s == msg);
+                }
+            };
+
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        for(int i = 0; i < 4; ++i)
+        {
+            pmd.client_no_context_takeover = (i & 1) != 0;
+            pmd.server_no_context_takeover = (i & 2) != 0;
+            for(int how = 0; how < 4; ++how)
+                check(pmd, how);
+        }
+    }
+
     void
     run() override
     {
@@ -645,6 +752,7 @@ public:
         testIssueBF2();
         testMoveOnly();
         testAsioHandlerInvoke();
+        testInflateInPlace();
     }
 };
 
@@ -13,6 +13,7 @@
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/test/tcp.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
@@ -20,8 +21,9 @@ namespace boost {
 namespace beast {
 namespace websocket {
 
-struct timer_test : unit_test::suite
+class timer_test : public unit_test::suite
 {
+public:
     using tcp = boost::asio::ip::tcp;
 
     void
@@ -85,10 +87,98 @@ struct timer_test : unit_test::suite
         test::run(ioc);
     }
 
+    void
+    testIdleShrink()
+    {
+        net::io_context ioc;
+
+        // an idle ping releases the inflate memory,
+        // which the next message allocates again
+
+        std::string s;
+        for(int i = 0; i < 4000; ++i)
+            s += static_cast<char>('a' + (i * i + i / 7) % 26);
+
+        for(int i = 0; i < 2; ++i)
+        {
+            permessage_deflate pmd;
+            pmd.client_enable = true;
+            pmd.server_enable = true;
+            pmd.client_no_context_takeover = true;
+            pmd.server_no_context_takeover = true;
+            if(i == 1)
+                pmd.dictionary = s.substr(0, 1000);
+            stream<tcp::socket> ws1(ioc);
+            stream<tcp::socket> ws2(ioc);
+            ws1.set_option(pmd);
+            ws2.set_option(pmd);
+            test::connect(ws1.next_layer(), ws2.next_layer());
+            ws1.async_accept(test::success_handler());
+            ws2.async_handshake("test", "/", test::success_handler());
+            test::run(ioc);
+
+            auto const memory =
+                [&ws2]
+                {
+                    auto const& zi = ws2.impl_->pmd_->zi;
+                    return zi.memory_usage() - sizeof(zi);
+                };
+
+            ws2.set_option(stream_base::timeout{
+                stream_base::none(),
+                std::chrono::milliseconds(100),
+                true});
+            flat_buffer b1;
+            flat_buffer b2;
+            int received = 0;
+            std::size_t used = 0;
+            bool pinged = false;
+            ws1.control_callback(
+                [&pinged](frame_type ft, string_view)
+                {
+                    pinged = ft == frame_type::ping;
+                });
+            ws1.async_read(b1, test::fail_handler(
+                net::error::operation_aborted));
+            ws1.async_write(net::buffer(s), test::success_handler());
+            ws2.async_read(b2,
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(buffers_to_string(b2.data()) == s);
+                    ++received;
+                    used = memory();
+                    b2.clear();
+                    ws2.async_read(b2,
+                        [&](error_code ec, std::size_t)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                            BEAST_EXPECT(
+                                buffers_to_string(b2.data()) == s);
+                            ++received;
+                            used = memory();
+                        });
+                });
+            test::run_for(ioc, std::chrono::milliseconds(200));
+            BEAST_EXPECT(received == 1);
+            BEAST_EXPECT(pinged);
+            BEAST_EXPECT(used > 0);
+            BEAST_EXPECT(memory() == 0);
+            used = 0;
+            ws1.async_write(net::buffer(s), test::success_handler());
+            test::run_for(ioc, std::chrono::milliseconds(50));
+            BEAST_EXPECT(received == 2);
+            BEAST_EXPECT(used > 0);
+        }
+
+        test::run(ioc);
+    }
+
     void
     run() override
     {
         testIdlePing();
+        testIdleShrink();
     }
 };
 
@@ -10,6 +10,7 @@
 // Test that header file is self-contained.
 #include <boost/beast/websocket/stream.hpp>
 
+#include <boost/beast/_experimental/test/handler.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
 
@@ -245,6 +246,18 @@ public:
             w.read(ws, b);
             BEAST_EXPECT(buffers_to_string(b.data()) == s);
         });
+
+        // deflate, quick strategy
+        pmd.client_no_context_takeover = false;
+        pmd.strategy = zlib::Strategy::quick;
+        doTest(pmd, [&](ws_type& ws)
+        {
+            std::string const s(2000, '*');
+            w.write(ws, net::buffer(s));
+            flat_buffer b;
+            w.read(ws, b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        });
     }
 
     void
@@ -262,6 +275,61 @@ public:
         });
     }
 
+    void
+    testCompressed()
+    {
+        // Returns the octets sent by the client
+        auto const check =
+            [&](permessage_deflate const& pmd)
+            {
+                net::io_context ioc;
+                stream<test::stream> ws1(ioc);
+                stream<test::stream> ws2(ioc);
+                ws1.set_option(pmd);
+                ws2.set_option(pmd);
+                test::connect(ws1.next_layer(), ws2.next_layer());
+                ws1.async_handshake("test", "/", test::success_handler());
+                ws2.async_accept(test::success_handler());
+                ioc.run();
+                std::string const s(2000, '*');
+                ws1.write(net::buffer(s));
+                auto const wire = buffers_to_string(
+                    ws2.next_layer().buffer().data());
+                flat_buffer b;
+                ws2.read(b);
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                return wire;
+            };
+
+        permessage_deflate pmd;
+        {
+            auto const wire = check(pmd);
+            BEAST_EXPECT(wire.size() > 2000);
+            BEAST_EXPECT((wire[0] & 0x40) == 0);
+        }
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        {
+            // RSV1 marks a compressed message
+            auto const wire = check(pmd);
+            BEAST_EXPECT(wire.size() < 2000);
+            BEAST_EXPECT((wire[0] & 0x40) != 0);
+        }
+        pmd.strategy = zlib::Strategy::quick;
+        {
+            auto const wire = check(pmd);
+            BEAST_EXPECT(wire.size() < 2000);
+            BEAST_EXPECT((wire[0] & 0x40) != 0);
+        }
+        pmd.compLevel = 0;
+        {
+            // level 0 sends stored blocks
+            auto const wire = check(pmd);
+            BEAST_EXPECT(wire.size() > 2000);
+            BEAST_EXPECT((wire[0] & 0x40) != 0);
+        }
+    }
+
     void
     testPausationAbandoning()
     {
@@ -609,6 +677,109 @@ public:
         }
     }
 
+    void
+    testDictionary()
+    {
+        // Short messages which resemble each other
+        auto const msg =
+            [](int i)
+            {
+                return
+                    "{\"id\":" + std::to_string(i) +
+                    ",\"type\":\"trade\",\"symbol\":\"BEAST\""
+                    ",\"price\":" + std::to_string(100 + i) +
+                    ",\"size\":10,\"side\":\"buy\"}";
+            };
+
+        // Returns the number of bytes sent by the client
+        auto const check =
+            [&](permessage_deflate const& pmd)
+            {
+                net::io_context ioc;
+                stream<test::stream> ws1(ioc);
+                stream<test::stream> ws2(ioc);
+                ws1.set_option(pmd);
+                ws2.set_option(pmd);
+                test::connect(ws1.next_layer(), ws2.next_layer());
+                ws1.async_handshake("test", "/", test::success_handler());
+                ws2.async_accept(test::success_handler());
+                ioc.run();
+                std::size_t n = 0;
+                for(int i = 0; i < 4; ++i)
+                {
+                    auto const s = msg(i);
+                    ws1.write(net::buffer(s));
+                    n += ws2.next_layer().buffer().size();
+                    flat_buffer b;
+                    ws2.read(b);
+                    BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                    ws2.write(net::buffer(s));
+                    b.clear();
+                    ws1.read(b);
+                    BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                }
+                return n;
+            };
+
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        for(int i = 0; i < 4; ++i)
+        {
+            pmd.client_no_context_takeover = (i & 1) != 0;
+            pmd.server_no_context_takeover = (i & 2) != 0;
+            pmd.dictionary.clear();
+            auto const n0 = check(pmd);
+            pmd.dictionary = msg(0);
+            auto const n1 = check(pmd);
+            BEAST_EXPECTS(n1 < n0,
+                std::to_string(n1) + " " + std::to_string(n0));
+        }
+    }
+
+    void
+    testCache()
+    {
+        net::io_context ioc;
+        stream<test::stream> ws1(ioc);
+        stream<test::stream> ws2(ioc);
+        test::connect(ws1.next_layer(), ws2.next_layer());
+        ws1.async_handshake("test", "/", test::success_handler());
+        ws2.async_accept(test::success_handler());
+        ioc.run();
+        ioc.restart();
+
+        std::string const s = "Hello, world!";
+        auto const round_trip =
+            [&]
+            {
+                flat_buffer b;
+                ws1.async_write(net::buffer(s),
+                    test::success_handler());
+                ws2.async_read(b, test::success_handler());
+                ioc.run();
+                ioc.restart();
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+            };
+        auto const allocated =
+            [&]
+            {
+                return
+                    ws1.impl_->cache.allocated() +
+                    ws2.impl_->cache.allocated();
+            };
+
+        // messages stop reaching the heap after warm-up
+        for(int i = 0; i < 10; ++i)
+            round_trip();
+        auto const n = allocated();
+        BEAST_EXPECT(n > 0);
+        for(int i = 0; i < 100; ++i)
+            round_trip();
+        BEAST_EXPECTS(allocated() == n,
+            std::to_string(allocated()) + " " + std::to_string(n));
+    }
+
     /*
         https://github.com/boostorg/beast/issues/300
 
@@ -679,9 +850,12 @@ public:
     run() override
     {
         testWrite();
+        testCompressed();
         testPausationAbandoning();
         testWriteSuspend();
         testAsyncWriteFrame();
+        testDictionary();
+        testCache();
         testIssue300();
         testMoveOnly();
     }
@@ -162,6 +162,7 @@ public:
         case 2: return Strategy::huffman;
         case 3: return Strategy::rle;
         case 4: return Strategy::fixed;
+        case 5: return Strategy::quick;
         }
     }
 
@@ -284,7 +285,7 @@ public:
                 // zlib has a bug with windowBits==8
                 if(windowBits == 8)
                     continue;
-                for(int strategy = 0; strategy <= 4; ++strategy)
+                for(int strategy = 0; strategy <= 5; ++strategy)
                 {
                     (this->*pmf)(
                         level, windowBits, strategy, check);
@@ -302,6 +303,151 @@ public:
         doMatrix(corpus1(1024), &self::doDeflate1_beast);
     }
 
+    void
+    testQuick()
+    {
+        auto const compress =
+            [&](std::string const& check, int level)
+            {
+                deflate_stream ds;
+                ds.reset(level, 15, 8, Strategy::quick);
+                std::string out;
+                out.resize(ds.upper_bound(check.size()));
+                z_params zs;
+                zs.next_in = check.data();
+                zs.avail_in = check.size();
+                zs.next_out = &out[0];
+                zs.avail_out = out.size();
+                error_code ec;
+                ds.write(zs, Flush::finish, ec);
+                BEAST_EXPECTS(! ec || ec == error::end_of_stream,
+                    ec.message());
+                out.resize(zs.total_out);
+                BEAST_EXPECT(decompress(out) == check);
+                return out.size();
+            };
+
+        auto const text = corpus1(4096);
+        auto const noise = corpus2(4096);
+
+        // level 0 still produces stored blocks
+        BEAST_EXPECT(compress(text, 0) > text.size());
+        BEAST_EXPECT(compress(text, 1) < text.size());
+        BEAST_EXPECT(compress(text, 9) == compress(text, 1));
+
+        // blocks which the static trees would make
+        // longer are stored instead
+        BEAST_EXPECT(compress(noise, 1) <
+            noise.size() + noise.size() / 64);
+    }
+
+    void
+    testDictionary()
+    {
+        std::string const dict =
+            "{\"id\":0,\"type\":\"trade\",\"symbol\":\"\",\"price\":0}";
+        std::string const in =
+            "{\"id\":42,\"type\":\"trade\",\"symbol\":\"BEAST\",\"price\":7}";
+
+        auto const compress =
+            [&](bool with_dict)
+            {
+                deflate_stream ds;
+                error_code ec;
+                if(with_dict)
+                {
+                    ds.set_dictionary(dict.data(), dict.size(), ec);
+                    BEAST_EXPECTS(! ec, ec.message());
+                }
+                std::string out;
+                out.resize(ds.upper_bound(in.size()));
+                z_params zs;
+                zs.next_in = in.data();
+                zs.avail_in = in.size();
+                zs.next_out = &out[0];
+                zs.avail_out = out.size();
+                ds.write(zs, Flush::finish, ec);
+                BEAST_EXPECT(ec == error::end_of_stream);
+                out.resize(zs.total_out);
+                return out;
+            };
+
+        auto const out = compress(true);
+        BEAST_EXPECT(out.size() < compress(false).size());
+
+        // zlib resolves the references into the dictionary
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        BEAST_EXPECT(inflateInit2(&zs, -15) == Z_OK);
+        BEAST_EXPECT(inflateSetDictionary(&zs,
+            (Bytef const*)dict.data(),
+            static_cast<uInt>(dict.size())) == Z_OK);
+        std::string s;
+        s.resize(in.size() + 1);
+        zs.next_in = (Bytef*)out.data();
+        zs.avail_in = static_cast<uInt>(out.size());
+        zs.next_out = (Bytef*)&s[0];
+        zs.avail_out = static_cast<uInt>(s.size());
+        BEAST_EXPECT(inflate(&zs, Z_FINISH) == Z_STREAM_END);
+        s.resize(zs.total_out);
+        inflateEnd(&zs);
+        BEAST_EXPECT(s == in);
+
+        // not while input is pending
+        {
+            deflate_stream ds;
+            std::string buf;
+            buf.resize(1000);
+            z_params zp;
+            zp.next_in = in.data();
+            zp.avail_in = in.size();
+            zp.next_out = &buf[0];
+            zp.avail_out = buf.size();
+            error_code ec;
+            ds.write(zp, Flush::none, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            ds.set_dictionary(dict.data(), dict.size(), ec);
+            BEAST_EXPECT(ec == error::stream_error);
+        }
+    }
+
+    void
+    testMemory()
+    {
+        auto const compress =
+            [](deflate_stream& ds, std::string const& in)
+            {
+                std::string out;
+                out.resize(ds.upper_bound(in.size()));
+                z_params zs;
+                zs.next_in = in.data();
+                zs.avail_in = in.size();
+                zs.next_out = &out[0];
+                zs.avail_out = out.size();
+                error_code ec;
+                ds.write(zs, Flush::sync, ec);
+                return ec;
+            };
+        auto const in = corpus1(1000);
+
+        deflate_stream ds;
+        ds.reset(6, 15, 8, Strategy::normal);
+        BEAST_EXPECT(ds.memory_usage() == sizeof(ds));
+        BEAST_EXPECT(! compress(ds, in));
+        auto const large = ds.memory_usage();
+        BEAST_EXPECT(large > sizeof(ds));
+        ds.reset();
+        BEAST_EXPECT(ds.memory_usage() == large);
+        ds.clear();
+        BEAST_EXPECT(ds.memory_usage() == sizeof(ds));
+
+        // buffers are sized by the window bits and memory level
+        ds.reset(6, 9, 1, Strategy::normal);
+        BEAST_EXPECT(! compress(ds, in));
+        BEAST_EXPECT(ds.memory_usage() > sizeof(ds));
+        BEAST_EXPECT(ds.memory_usage() < large / 16);
+    }
+
     void
     run() override
     {
@@ -310,6 +456,9 @@ public:
             sizeof(deflate_stream) << std::endl;
 
         testDeflate();
+        testQuick();
+        testDictionary();
+        testMemory();
     }
 };
 
@@ -13,7 +13,9 @@
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <chrono>
+#include <cstring>
 #include <random>
+#include <vector>
 
 #include "zlib-1.2.11/zlib.h"
 
@@ -63,6 +65,31 @@ public:
         return s;
     }
 
+    // Runs of short repeating patterns
+    static
+    std::string
+    corpus3(std::size_t n)
+    {
+        std::string s;
+        s.reserve(n + 300);
+        std::mt19937 g;
+        std::uniform_int_distribution<std::uint32_t> d0{0, 255};
+        std::uniform_int_distribution<std::size_t> d1{1, 20};
+        std::uniform_int_distribution<std::size_t> d2{1, 300};
+        while(s.size() < n)
+        {
+            auto const period = d1(g);
+            auto const len = d2(g);
+            auto const pos = s.size();
+            for(std::size_t i = 0; i < period; ++i)
+                s.push_back(static_cast<char>(d0(g)));
+            for(std::size_t i = 0; i < len; ++i)
+                s.push_back(s[pos + i % period]);
+        }
+        s.resize(n);
+        return s;
+    }
+
     static
     std::string
     compress(
@@ -309,6 +336,11 @@ public:
             auto const check = corpus2(5000);
             m(Beast{half, half}, check);
         }
+        {
+            Matrix m{*this};
+            auto const check = corpus3(20000);
+            m(Beast{half, half}, check);
+        }
         {
             Matrix m{*this};
             auto const check = corpus1(1000);
@@ -362,6 +394,306 @@ public:
 #endif
     }
 
+    // A complete stream inflates in one call,
+    // however the final codes line up with the
+    // end of the input.
+    void
+    testFinish()
+    {
+        auto const check = corpus1(3000) + corpus3(3000);
+        int failures = 0;
+        for(int window = 9; window <= 15; ++window)
+        for(int memLevel = 1; memLevel <= 9; ++memLevel)
+        for(std::size_t size = 1000; size <= check.size(); size += 500)
+        {
+            auto const in = check.substr(0, size);
+            std::string out;
+            {
+                z_stream zs;
+                std::memset(&zs, 0, sizeof(zs));
+                deflateInit2(&zs, 6, Z_DEFLATED,
+                    -window, memLevel, Z_DEFAULT_STRATEGY);
+                out.resize(deflateBound(&zs,
+                    static_cast<uLong>(in.size())));
+                zs.next_in = (Bytef*)in.data();
+                zs.avail_in = static_cast<uInt>(in.size());
+                zs.next_out = (Bytef*)&out[0];
+                zs.avail_out = static_cast<uInt>(out.size());
+                deflate(&zs, Z_FINISH);
+                out.resize(zs.total_out);
+                deflateEnd(&zs);
+            }
+            inflate_stream is;
+            is.reset(window);
+            std::string s;
+            s.resize(in.size());
+            z_params zs;
+            zs.next_in = out.data();
+            zs.avail_in = out.size();
+            zs.next_out = &s[0];
+            zs.avail_out = s.size();
+            error_code ec;
+            is.write(zs, Flush::finish, ec);
+            if(ec != error::end_of_stream || s != in)
+                ++failures;
+        }
+        BEAST_EXPECTS(failures == 0, std::to_string(failures));
+    }
+
+    void
+    testDictionary()
+    {
+        std::string const dict = corpus1(1000);
+        std::string const in = dict.substr(500, 200) + dict.substr(100, 300);
+
+        // compress with zlib and a preset dictionary
+        std::string out;
+        {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            BEAST_EXPECT(deflateInit2(&zs, Z_DEFAULT_COMPRESSION,
+                Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+            BEAST_EXPECT(deflateSetDictionary(&zs,
+                (Bytef const*)dict.data(),
+                static_cast<uInt>(dict.size())) == Z_OK);
+            out.resize(deflateBound(&zs,
+                static_cast<uLong>(in.size())));
+            zs.next_in = (Bytef*)in.data();
+            zs.avail_in = static_cast<uInt>(in.size());
+            zs.next_out = (Bytef*)&out[0];
+            zs.avail_out = static_cast<uInt>(out.size());
+            BEAST_EXPECT(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+            out.resize(zs.total_out);
+            deflateEnd(&zs);
+        }
+        BEAST_EXPECT(out.size() < 100);
+
+        auto const decompress =
+            [&](std::size_t chunk)
+            {
+                inflate_stream is;
+                error_code ec;
+                is.set_dictionary(dict.data(), dict.size(), ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                std::string s;
+                s.resize(in.size());
+                z_params zs;
+                zs.next_in = out.data();
+                zs.avail_in = 0;
+                zs.next_out = &s[0];
+                zs.avail_out = s.size();
+                std::size_t pos = 0;
+                while(! ec)
+                {
+                    auto const n = (std::min)(chunk, out.size() - pos);
+                    zs.next_in = out.data() + pos;
+                    zs.avail_in = n;
+                    pos += n;
+                    is.write(zs, Flush::none, ec);
+                    pos -= zs.avail_in;
+                    if(ec == error::need_buffers && pos < out.size())
+                        ec = {};
+                }
+                BEAST_EXPECTS(ec == error::end_of_stream, ec.message());
+                BEAST_EXPECT(s == in);
+            };
+        decompress(out.size());
+        decompress(1);
+
+        // not in the middle of a block
+        {
+            inflate_stream is;
+            std::string s;
+            s.resize(in.size());
+            z_params zs;
+            zs.next_in = out.data();
+            zs.avail_in = 2;
+            zs.next_out = &s[0];
+            zs.avail_out = s.size();
+            error_code ec;
+            is.write(zs, Flush::none, ec);
+            is.set_dictionary(dict.data(), dict.size(), ec);
+            BEAST_EXPECT(ec == error::stream_error);
+        }
+    }
+
+    void
+    testMemory()
+    {
+        auto const compress =
+            [](std::string const& in, int strategy)
+            {
+                std::string out;
+                z_stream zs;
+                std::memset(&zs, 0, sizeof(zs));
+                deflateInit2(&zs, 6, Z_DEFLATED,
+                    -10, 8, strategy);
+                out.resize(deflateBound(&zs,
+                    static_cast<uLong>(in.size())));
+                zs.next_in = (Bytef*)in.data();
+                zs.avail_in = static_cast<uInt>(in.size());
+                zs.next_out = (Bytef*)&out[0];
+                zs.avail_out = static_cast<uInt>(out.size());
+                deflate(&zs, Z_SYNC_FLUSH);
+                out.resize(zs.total_out);
+                deflateEnd(&zs);
+                return out;
+            };
+        auto const decompress =
+            [this](inflate_stream& is,
+                std::string const& in, std::string const& check)
+            {
+                std::string s;
+                s.resize(check.size());
+                z_params zs;
+                zs.next_in = in.data();
+                zs.avail_in = in.size();
+                zs.next_out = &s[0];
+                zs.avail_out = s.size();
+                error_code ec;
+                is.write(zs, Flush::sync, ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(s == check);
+            };
+        auto const check = corpus1(5000);
+        auto const fixed = compress(check, Z_FIXED);
+        auto const dynamic = compress(check, Z_DEFAULT_STRATEGY);
+
+        inflate_stream is;
+        is.reset(10);
+        BEAST_EXPECT(is.memory_usage() == sizeof(is));
+
+        // a fixed block needs only the window
+        decompress(is, fixed, check);
+        auto const window = is.memory_usage();
+        BEAST_EXPECT(window == sizeof(is) + 1024);
+
+        // dynamic tables are allocated once
+        is.reset();
+        decompress(is, dynamic, check);
+        auto const tables = is.memory_usage();
+        BEAST_EXPECT(tables > window);
+        is.reset();
+        BEAST_EXPECT(is.memory_usage() == tables);
+        decompress(is, dynamic, check);
+        BEAST_EXPECT(is.memory_usage() == tables);
+
+        // clear keeps the memory for the next stream
+        is.clear();
+        BEAST_EXPECT(is.memory_usage() == tables);
+        decompress(is, dynamic, check);
+        BEAST_EXPECT(is.memory_usage() == tables);
+
+        // shrink frees everything and keeps the window size
+        is.shrink();
+        BEAST_EXPECT(is.memory_usage() == sizeof(is));
+        decompress(is, fixed, check);
+        BEAST_EXPECT(is.memory_usage() == window);
+    }
+
+    void
+    testInPlace()
+    {
+        auto const check = corpus1(20000) + corpus1(20000);
+        std::string in;
+        {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            deflateInit2(&zs, 6, Z_DEFLATED,
+                -15, 8, Z_FIXED);
+            in.resize(deflateBound(&zs,
+                static_cast<uLong>(check.size())));
+            zs.next_in = (Bytef*)check.data();
+            zs.avail_in = static_cast<uInt>(check.size());
+            zs.next_out = (Bytef*)&in[0];
+            zs.avail_out = static_cast<uInt>(in.size());
+            deflate(&zs, Z_SYNC_FLUSH);
+            in.resize(zs.total_out);
+            deflateEnd(&zs);
+        }
+
+        // Inflates chunk bytes of output at a time, starting
+        // each call in a fresh buffer when moved is true.
+        auto const decompress =
+            [&](inflate_stream& is, std::size_t chunk, bool moved)
+            {
+                std::vector<std::string> parts;
+                std::string s;
+                s.resize(check.size());
+                z_params zs;
+                zs.next_in = in.data();
+                zs.avail_in = in.size();
+                zs.next_out = &s[0];
+                while(zs.total_out < check.size())
+                {
+                    if(moved)
+                    {
+                        parts.emplace_back(chunk, '\0');
+                        zs.next_out = &parts.back()[0];
+                        zs.avail_out = chunk;
+                    }
+                    else
+                    {
+                        zs.avail_out = (std::min)(chunk,
+                            check.size() - zs.total_out);
+                    }
+                    error_code ec;
+                    is.write(zs, Flush::sync, ec);
+                    if(! BEAST_EXPECTS(! ec, ec.message()))
+                        return;
+                }
+                if(moved)
+                {
+                    s.clear();
+                    for(auto const& p : parts)
+                        s += p;
+                    s.resize(check.size());
+                }
+                BEAST_EXPECT(s == check);
+            };
+
+        inflate_stream is;
+        is.in_place(true);
+
+        // contiguous output never touches the window
+        decompress(is, check.size(), false);
+        is.reset();
+        decompress(is, 1000, false);
+        BEAST_EXPECT(is.memory_usage() == sizeof(is));
+        is.reset();
+        decompress(is, 1, false);
+        BEAST_EXPECT(is.memory_usage() == sizeof(is));
+
+        // output which moves is kept in the window
+        is.reset();
+        decompress(is, 1000, true);
+        BEAST_EXPECT(is.memory_usage() > sizeof(is));
+
+        // turning it off keeps the output so far
+        {
+            inflate_stream is2;
+            is2.in_place(true);
+            std::string s;
+            s.resize(check.size());
+            z_params zs;
+            zs.next_in = in.data();
+            zs.avail_in = in.size();
+            zs.next_out = &s[0];
+            zs.avail_out = 25000;
+            error_code ec;
+            is2.write(zs, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            is2.in_place(false);
+            auto const n = zs.total_out;
+            std::string prefix = s.substr(0, n);
+            std::fill(&s[0], &s[n], '#');
+            zs.avail_out = s.size() - n;
+            is2.write(zs, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(prefix + s.substr(n) == check);
+        }
+    }
+
     void
     run() override
     {
@@ -369,6 +701,10 @@ public:
             "sizeof(inflate_stream) == " <<
             sizeof(inflate_stream) << std::endl;
         testInflate();
+        testFinish();
+        testDictionary();
+        testMemory();
+        testInPlace();
     }
 };
 
@@ -0,0 +1,325 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/zlib/parallel_deflate_stream.hpp>
+
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "zlib-1.2.11/zlib.h"
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+class parallel_deflate_stream_test : public beast::unit_test::suite
+{
+public:
+    // Repeats at every distance, so that blocks
+    // depend on the dictionary of the one before.
+    static
+    std::string
+    corpus(std::size_t n)
+    {
+        std::string s;
+        s.reserve(n + 300);
+        std::mt19937 g;
+        std::uniform_int_distribution<std::uint32_t> d0{0, 255};
+        std::uniform_int_distribution<std::size_t> d1{3, 258};
+        std::uniform_int_distribution<std::size_t> d2{0, 3};
+        while(s.size() < n)
+        {
+            if(s.size() < 300 || d2(g) == 0)
+            {
+                s.push_back(static_cast<char>(d0(g) & 0x3f));
+                continue;
+            }
+            std::uniform_int_distribution<std::size_t> d3{
+                1, (std::min)(s.size(), std::size_t{32768})};
+            auto const dist = d3(g);
+            auto len = d1(g);
+            while(len--)
+                s.push_back(s[s.size() - dist]);
+        }
+        s.resize(n);
+        return s;
+    }
+
+    // Inflate a complete raw deflate stream with zlib
+    static
+    bool
+    decompress(string_view in, std::string& out)
+    {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if(inflateInit2(&zs, -15) != Z_OK)
+            return false;
+        out.clear();
+        zs.next_in = (Bytef*)in.data();
+        zs.avail_in = static_cast<uInt>(in.size());
+        int result;
+        for(;;)
+        {
+            out.resize(zs.total_out + 65536);
+            zs.next_out = (Bytef*)&out[zs.total_out];
+            zs.avail_out = static_cast<uInt>(
+                out.size() - zs.total_out);
+            result = inflate(&zs, Z_NO_FLUSH);
+            if(result != Z_OK)
+                break;
+        }
+        out.resize(zs.total_out);
+        inflateEnd(&zs);
+        return result == Z_STREAM_END && zs.avail_in == 0;
+    }
+
+    // Compress `in` feeding and draining `step` bytes at a time,
+    // with a sync or full flush every `every` bytes if nonzero.
+    static
+    std::string
+    compress(
+        parallel_deflate_stream& ds,
+        string_view in,
+        std::size_t step,
+        std::size_t every = 0,
+        Flush flush = Flush::sync)
+    {
+        std::string out;
+        out.resize(step);
+        z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = 0;
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        std::size_t fed = 0;
+        std::size_t mark = every;
+        for(;;)
+        {
+            if(zs.avail_in == 0 && fed < in.size())
+            {
+                auto n = (std::min)(step, in.size() - fed);
+                if(every > 0)
+                    n = (std::min)(n, mark - fed);
+                zs.avail_in = n;
+                fed += n;
+            }
+            Flush f = Flush::none;
+            if(fed == in.size())
+                f = Flush::finish;
+            else if(every > 0 && fed == mark)
+                f = flush;
+            error_code ec;
+            ds.write(zs, f, ec);
+            if(ec == error::end_of_stream)
+                break;
+            if(ec && ec != error::need_buffers)
+                throw system_error{ec};
+            if(f != Flush::none && f != Flush::finish &&
+                zs.avail_in == 0 && zs.avail_out > 0)
+                mark += every;
+            if(zs.avail_out == 0)
+            {
+                out.resize(out.size() + step);
+                zs.next_out = &out[out.size() - step];
+                zs.avail_out = step;
+            }
+        }
+        out.resize(out.size() - zs.avail_out);
+        return out;
+    }
+
+    void
+    check(
+        parallel_deflate_stream& ds,
+        std::string const& in,
+        std::size_t step,
+        std::size_t every = 0,
+        Flush flush = Flush::sync)
+    {
+        auto const out = compress(ds, in, step, every, flush);
+        std::string s;
+        BEAST_EXPECT(decompress(out, s));
+        BEAST_EXPECT(s == in);
+        ds.reset();
+    }
+
+    void
+    testRoundTrip()
+    {
+        auto const in = corpus(300000);
+        for(unsigned threads : {1, 4})
+        {
+            parallel_deflate_stream ds(threads, 20000);
+            BEAST_EXPECT(ds.threads() == threads);
+            check(ds, in, in.size());
+            check(ds, in, 65536);
+            check(ds, in, 777);
+            check(ds, "", 100);
+            check(ds, "*", 1);
+            check(ds, in.substr(0, 20000), 1000);
+            check(ds, in, 4096, 50000);
+            check(ds, in, 4096, 3000);
+            check(ds, in, 4096, 30000, Flush::full);
+            for(int level = 0; level <= 9; level += 3)
+            {
+                ds.reset(level, 15, 8, Strategy::normal);
+                check(ds, in, 65536);
+            }
+            ds.reset(6, 9, 8, Strategy::normal);
+            check(ds, in, 65536);
+            ds.reset(6, 10, 4, Strategy::quick);
+            check(ds, in, 65536);
+            ds.reset(6, 15, 8, Strategy::rle);
+            check(ds, in, 65536);
+        }
+    }
+
+    void
+    testDictionary()
+    {
+        // Each block matches across the boundary,
+        // so it compresses as well as one stream.
+        std::string in;
+        {
+            std::mt19937 g;
+            std::uniform_int_distribution<std::uint32_t> d0{0, 255};
+            std::string unit;
+            for(int i = 0; i < 8192; ++i)
+                unit.push_back(static_cast<char>(d0(g)));
+            while(in.size() < 200000)
+                in += unit;
+        }
+        parallel_deflate_stream ds(2, 16384);
+        auto const out = compress(ds, in, 65536);
+        std::string s;
+        BEAST_EXPECT(decompress(out, s));
+        BEAST_EXPECT(s == in);
+        BEAST_EXPECTS(out.size() < 2 * 8192, std::to_string(out.size()));
+
+        // A full flush drops the dictionary
+        ds.reset();
+        auto const out2 = compress(ds, in, 65536, 16384, Flush::full);
+        BEAST_EXPECT(decompress(out2, s));
+        BEAST_EXPECT(s == in);
+        BEAST_EXPECT(out2.size() > 8 * 8192);
+    }
+
+    void
+    testFlush()
+    {
+        // Everything written before a sync flush can be inflated
+        auto const in = corpus(100000);
+        parallel_deflate_stream ds(3, 10000);
+        inflate_stream is;
+        std::string out;
+        out.resize(in.size());
+        z_params zo;
+        zo.next_out = &out[0];
+        zo.avail_out = out.size();
+        std::string buf;
+        buf.resize(in.size() + 1000);
+        std::size_t pos = 0;
+        for(std::size_t n : {1, 5000, 25000, 69999})
+        {
+            z_params zs;
+            zs.next_in = in.data() + pos;
+            zs.avail_in = n;
+            zs.next_out = &buf[0];
+            zs.avail_out = buf.size();
+            error_code ec;
+            ds.write(zs, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(zs.avail_in == 0);
+            pos += n;
+
+            zo.next_in = buf.data();
+            zo.avail_in = buf.size() - zs.avail_out;
+            is.write(zo, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(zo.avail_in == 0);
+            BEAST_EXPECT(zo.total_out == pos);
+
+            // A second flush without input makes no progress
+            ds.write(zs, Flush::sync, ec);
+            BEAST_EXPECT(ec == error::need_buffers);
+        }
+        BEAST_EXPECT(out == in);
+    }
+
+    void
+    testInvalid()
+    {
+        try
+        {
+            parallel_deflate_stream ds(1, 0);
+            fail();
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+        parallel_deflate_stream ds(1);
+        try
+        {
+            ds.reset(6, 16, 8, Strategy::normal);
+            fail();
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+
+        // finish must be repeated until the end
+        std::string out;
+        out.resize(100);
+        z_params zs;
+        zs.next_in = nullptr;
+        zs.avail_in = 0;
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        ds.write(zs, Flush::finish, ec);
+        BEAST_EXPECT(ec == error::end_of_stream);
+        ds.write(zs, Flush::none, ec);
+        BEAST_EXPECT(ec == error::stream_error);
+
+        // destroying with work in flight
+        {
+            auto const in = corpus(500000);
+            parallel_deflate_stream ds2(4, 10000);
+            zs.next_in = in.data();
+            zs.avail_in = in.size();
+            zs.next_out = &out[0];
+            zs.avail_out = 1;
+            ec = {};
+            ds2.write(zs, Flush::none, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+        }
+    }
+
+    void
+    run() override
+    {
+        testRoundTrip();
+        testDictionary();
+        testFlush();
+        testInvalid();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,zlib,parallel_deflate_stream);
+
+} // zlib
+} // beast
+} // boost
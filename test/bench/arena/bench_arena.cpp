@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/monotonic_arena.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/throw_exception.hpp>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+class arena_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    inline
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        using namespace std::chrono;
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    // Produces allocators for one request/response pair
+    struct std_policy
+    {
+        using allocator_type = std::allocator<char>;
+
+        allocator_type
+        get() const
+        {
+            return {};
+        }
+
+        void
+        reset()
+        {
+        }
+    };
+
+    struct arena_policy
+    {
+        using allocator_type = arena_allocator<char>;
+
+        monotonic_arena arena;
+
+        allocator_type
+        get()
+        {
+            return allocator_type(arena);
+        }
+
+        void
+        reset()
+        {
+            arena.reset();
+        }
+    };
+
+    static
+    std::string
+    make_request(std::size_t fields, std::size_t body)
+    {
+        std::string s =
+            "POST /index.html HTTP/1.1\r\n"
+            "Host: www.example.com\r\n";
+        for(std::size_t i = 0; i < fields; ++i)
+            s += "X-Field-" + std::to_string(i) + ": " +
+                std::string(24, 'a' + i % 26) + "\r\n";
+        s += "Content-Length: " + std::to_string(body) + "\r\n\r\n";
+        s.append(body, '*');
+        return s;
+    }
+
+    // Adds up the bytes produced by a serializer
+    template<class Serializer>
+    struct visit
+    {
+        Serializer& sr;
+        size_type& total;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&, ConstBufferSequence const& buffers)
+        {
+            auto const n = buffer_bytes(buffers);
+            total += n;
+            sr.consume(n);
+        }
+    };
+
+    // One keep-alive request: read the request, build a
+    // response echoing the body, and serialize it.
+    template<class Policy>
+    size_type
+    do_requests(std::size_t repeat, std::string const& input)
+    {
+        using alloc_type = typename Policy::allocator_type;
+        using string_body = http::basic_string_body<
+            char, std::char_traits<char>, alloc_type>;
+        using dynamic_body = http::basic_dynamic_body<
+            basic_multi_buffer<alloc_type>>;
+        using fields = http::basic_fields<alloc_type>;
+
+        Policy policy;
+        timer t;
+        size_type bytes = 0;
+        for(auto i = repeat; i--;)
+        {
+            {
+                auto const a = policy.get();
+                basic_flat_buffer<alloc_type> b(a);
+                b.commit(net::buffer_copy(b.prepare(input.size()),
+                    net::buffer(input)));
+
+                http::request_parser<string_body, alloc_type> p(
+                    std::piecewise_construct,
+                    std::make_tuple(a),
+                    std::make_tuple(a));
+                error_code ec;
+                b.consume(p.put(b.data(), ec));
+                if(ec)
+                    BOOST_THROW_EXCEPTION(system_error{ec});
+                auto const& req = p.get();
+
+                http::response<dynamic_body, fields> res(
+                    std::piecewise_construct,
+                    std::make_tuple(a),
+                    std::make_tuple(a));
+                res.result(http::status::ok);
+                res.set(http::field::server, "Beast");
+                res.set(http::field::content_type, "text/plain");
+                for(auto const& f : req)
+                    if(f.name() == http::field::unknown)
+                        res.insert(f.name_string(), f.value());
+                ostream(res.body()) << req.body();
+                res.prepare_payload();
+
+                using serializer_type =
+                    http::response_serializer<dynamic_body, fields>;
+                serializer_type sr(res);
+                do
+                {
+                    sr.next(ec, visit<serializer_type>{sr, bytes});
+                }
+                while(! ec && ! sr.is_done());
+            }
+            policy.reset();
+        }
+        BEAST_EXPECT(bytes > 0);
+        return throughput(t.elapsed(), repeat);
+    }
+
+    static
+    inline
+    void
+    do_trials_1(bool)
+    {
+    }
+
+    template<class F0, class... FN>
+    void
+    do_trials_1(bool print, F0&& f, FN... fn)
+    {
+        if(print)
+        {
+            log << std::right << std::setw(10) <<
+                f() << " req/s";
+            log.flush();
+        }
+        else
+        {
+            f();
+        }
+        do_trials_1(print, fn...);
+    }
+
+    template<class F0, class... FN>
+    void
+    do_trials(string_view name,
+        std::size_t trials, F0&& f0, FN... fn)
+    {
+        using namespace std::chrono;
+        // warm-up
+        do_trials_1(false, f0, fn...);
+        while(trials--)
+        {
+            timer t;
+            log << std::left << std::setw(24) << name << ":";
+            log.flush();
+            do_trials_1(true, f0, fn...);
+            log << "   " <<
+                duration_cast<milliseconds>(t.elapsed()).count() << "ms";
+            log << std::endl;
+        }
+    }
+
+    void
+    run() override
+    {
+        static std::size_t constexpr trials = 3;
+        static std::size_t constexpr repeat = 2000;
+        log << std::endl;
+        log << std::left << std::setw(24) << "request/response" << " " <<
+            std::right << std::setw(15) << "std::allocator" <<
+            std::right << std::setw(15) << "arena" <<
+            std::endl;
+        for(auto const& param : {
+            std::make_pair(4, 64),
+            std::make_pair(16, 1024),
+            std::make_pair(48, 16384) })
+        {
+            auto const s = "fields=" + std::to_string(param.first) +
+                ", body=" + std::to_string(param.second);
+            auto const input = make_request(param.first, param.second);
+            do_trials(s, trials,
+                 [&](){ return do_requests<std_policy>  (repeat, input); }
+                ,[&](){ return do_requests<arena_policy>(repeat, input); }
+            );
+        }
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,arena);
+
+} // beast
+} // boost
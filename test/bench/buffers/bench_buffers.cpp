@@ -7,11 +7,15 @@
 // Official repository: https://github.com/boostorg/beast
 //
 
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/core/detail/buffers_array.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/asio/streambuf.hpp>
 #include <algorithm>
@@ -145,6 +149,70 @@ public:
         return throughput(t.elapsed(), total);
     }
 
+    // Copy a sequence into an iovec-style array the
+    // way a stream implementation does before writev.
+    template<class ConstBufferSequence>
+    static
+    std::size_t
+    to_iovec(ConstBufferSequence const& buffers)
+    {
+        net::const_buffer iov[64];
+        std::size_t n = 0;
+        std::size_t bytes = 0;
+        auto it = net::buffer_sequence_begin(buffers);
+        auto const last = net::buffer_sequence_end(buffers);
+        for(; it != last && n < 64; ++it)
+        {
+            iov[n] = *it;
+            bytes += iov[n++].size();
+        }
+        return bytes;
+    }
+
+    // Shaped like the serializer's chunked output: a
+    // header with `fields` buffers, then a chunk.
+    template<bool Flatten>
+    size_type
+    do_nested(std::size_t repeat, std::size_t fields)
+    {
+        std::string const s(64, 'x');
+        std::vector<net::const_buffer> fv(fields,
+            net::const_buffer(s.data(), 24));
+        auto const header = buffers_cat(
+            net::const_buffer(s.data(), 4),
+            net::const_buffer(s.data(), 1),
+            net::const_buffer(s.data(), 9),
+            fv,
+            net::const_buffer(s.data(), 2));
+        auto const cv = buffers_cat(
+            header,
+            net::const_buffer(s.data(), 6),
+            net::const_buffer(s.data(), 0),
+            net::const_buffer(s.data(), 2),
+            net::const_buffer(s.data(), 64),
+            net::const_buffer(s.data(), 2));
+        buffers_suffix<decltype(cv)> const cs(cv);
+        timer t;
+        size_type total = 0;
+        for(auto i = repeat; i--;)
+        {
+            if(Flatten)
+            {
+                beast::detail::buffers_array<64> ba;
+                ba.assign(cs, 65536);
+                total += to_iovec(ba);
+                total += to_iovec(ba);
+            }
+            else
+            {
+                auto const pv = buffers_prefix(65536, cs);
+                total += to_iovec(pv);
+                total += to_iovec(pv);
+            }
+        }
+        return throughput(t.elapsed(), total);
+    }
+
     static
     inline
     void
@@ -231,6 +299,19 @@ public:
             );
             log << std::endl;
         }
+        log << std::left << std::setw(24) << "nested buffers_cat" << " " <<
+            std::right << std::setw(15) << "iterate" <<
+            std::right << std::setw(15) << "flatten" <<
+            std::endl;
+        for(std::size_t fields : {4, 16, 48})
+        {
+            auto const s = std::string("fields=") + std::to_string(fields);
+            do_trials(s, trials,
+                 [&](){ return do_nested<false>(20000, fields); }
+                ,[&](){ return do_nested<true> (20000, fields); }
+            );
+        }
+        log << std::endl;
         pass();
     }
 };
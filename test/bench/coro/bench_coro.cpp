@@ -0,0 +1,374 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/_experimental/core/use_awaiter.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/spawn.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::size_t allocations = 0;
+
+} // (anon)
+
+void*
+operator new(std::size_t n)
+{
+    ++allocations;
+    if(auto p = std::malloc(n == 0 ? 1 : n))
+        return p;
+    throw std::bad_alloc{};
+}
+
+BOOST_NOINLINE
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+BOOST_NOINLINE
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace boost {
+namespace beast {
+
+/*  Loopback HTTP/1.1 keep-alive requests, with each end of each
+    connection served by a stackful coroutine started with spawn,
+    or by a C++20 coroutine awaiting operations given use_awaiter.
+
+    Reported are requests per second, the growth of the resident
+    set per connection while its server coroutine waits for the
+    first request, and calls to operator new per request.
+*/
+class coro_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+    using tcp = net::ip::tcp;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    inline
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        using namespace std::chrono;
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    static
+    std::size_t
+    resident()
+    {
+#ifdef __linux__
+        // Give memory freed by an earlier trial back
+        malloc_trim(0);
+        std::size_t size = 0;
+        std::size_t pages = 0;
+        std::ifstream f("/proc/self/statm");
+        f >> size >> pages;
+        return pages * static_cast<std::size_t>(
+            sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    struct result
+    {
+        size_type rate;
+        std::size_t memory;
+        double allocs;
+    };
+
+    //--------------------------------------------------------------------------
+
+    // Echoes each request body
+    static
+    void
+    stackful_server(tcp_stream& stream, net::yield_context yield)
+    {
+        error_code ec;
+        flat_buffer buffer;
+        for(;;)
+        {
+            http::request<http::string_body> req;
+            http::async_read(stream, buffer, req, yield[ec]);
+            if(ec)
+                return;
+            http::response<http::string_body> res{
+                http::status::ok, 11};
+            res.body() = std::move(req.body());
+            res.prepare_payload();
+            http::async_write(stream, res, yield[ec]);
+            if(ec)
+                return;
+        }
+    }
+
+    static
+    void
+    stackful_client(tcp_stream& stream, std::size_t body,
+        std::size_t repeat, size_type& done, net::yield_context yield)
+    {
+        error_code ec;
+        flat_buffer buffer;
+        http::request<http::string_body> req{
+            http::verb::post, "/", 11};
+        req.set(http::field::host, "localhost");
+        req.body() = std::string(body, '*');
+        req.prepare_payload();
+        while(repeat--)
+        {
+            http::async_write(stream, req, yield[ec]);
+            if(ec)
+                return;
+            http::response<http::string_body> res;
+            http::async_read(stream, buffer, res, yield[ec]);
+            if(ec)
+                return;
+            ++done;
+        }
+        stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+    }
+
+    struct stackful
+    {
+        void
+        server(net::io_context& ioc, tcp_stream& stream) const
+        {
+            net::spawn(ioc, std::bind(&stackful_server,
+                std::ref(stream), std::placeholders::_1));
+        }
+
+        void
+        client(net::io_context& ioc, tcp_stream& stream,
+            std::size_t body, std::size_t repeat, size_type& done) const
+        {
+            net::spawn(ioc, std::bind(&stackful_client,
+                std::ref(stream), body, repeat, std::ref(done),
+                    std::placeholders::_1));
+        }
+    };
+
+    //--------------------------------------------------------------------------
+
+#if BOOST_BEAST_HAS_CO_AWAIT
+    static
+    detached_task
+    awaiter_server(tcp_stream& stream)
+    {
+        error_code ec;
+        flat_buffer buffer;
+        for(;;)
+        {
+            http::request<http::string_body> req;
+            co_await http::async_read(
+                stream, buffer, req, use_awaiter[ec]);
+            if(ec)
+                co_return;
+            http::response<http::string_body> res{
+                http::status::ok, 11};
+            res.body() = std::move(req.body());
+            res.prepare_payload();
+            co_await http::async_write(stream, res, use_awaiter[ec]);
+            if(ec)
+                co_return;
+        }
+    }
+
+    static
+    detached_task
+    awaiter_client(tcp_stream& stream, std::size_t body,
+        std::size_t repeat, size_type& done)
+    {
+        error_code ec;
+        flat_buffer buffer;
+        http::request<http::string_body> req{
+            http::verb::post, "/", 11};
+        req.set(http::field::host, "localhost");
+        req.body() = std::string(body, '*');
+        req.prepare_payload();
+        while(repeat--)
+        {
+            co_await http::async_write(stream, req, use_awaiter[ec]);
+            if(ec)
+                co_return;
+            http::response<http::string_body> res;
+            co_await http::async_read(
+                stream, buffer, res, use_awaiter[ec]);
+            if(ec)
+                co_return;
+            ++done;
+        }
+        stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+    }
+
+    struct awaiting
+    {
+        void
+        server(net::io_context&, tcp_stream& stream) const
+        {
+            awaiter_server(stream);
+        }
+
+        void
+        client(net::io_context&, tcp_stream& stream,
+            std::size_t body, std::size_t repeat, size_type& done) const
+        {
+            awaiter_client(stream, body, repeat, done);
+        }
+    };
+#endif
+
+    //--------------------------------------------------------------------------
+
+    template<class Model>
+    result
+    do_requests(Model const& model, std::size_t connections,
+        std::size_t body, std::size_t repeat)
+    {
+        net::io_context ioc;
+        tcp::acceptor a(ioc, {net::ip::address_v4::loopback(), 0});
+        std::vector<std::unique_ptr<tcp_stream>> clients;
+        std::vector<std::unique_ptr<tcp_stream>> servers;
+        for(std::size_t i = 0; i < connections; ++i)
+        {
+            clients.emplace_back(new tcp_stream(ioc));
+            servers.emplace_back(new tcp_stream(ioc));
+            clients.back()->socket().connect(a.local_endpoint());
+            a.accept(servers.back()->socket());
+            clients.back()->socket().set_option(tcp::no_delay(true));
+            servers.back()->socket().set_option(tcp::no_delay(true));
+        }
+
+        // Each server waits for its first request
+        auto const rss = resident();
+        for(auto& s : servers)
+            model.server(ioc, *s);
+        ioc.poll();
+        auto const after = resident();
+        auto const grown = after > rss ? after - rss : 0;
+
+        size_type done = 0;
+        for(auto& c : clients)
+            model.client(ioc, *c, body, repeat, done);
+        auto const n = allocations;
+        timer t;
+        ioc.run();
+        auto const elapsed = t.elapsed();
+        BEAST_EXPECT(done == connections * repeat);
+        return result{
+            throughput(elapsed, done),
+            grown / connections,
+            static_cast<double>(allocations - n) / done};
+    }
+
+    template<class Model>
+    void
+    do_trials(string_view name, std::size_t trials,
+        Model const& model, std::size_t connections,
+        std::size_t body, std::size_t repeat)
+    {
+        // warm-up
+        do_requests(model, connections, body, repeat);
+        while(trials--)
+        {
+            auto const r = do_requests(
+                model, connections, body, repeat);
+            log <<
+                std::left << std::setw(24) << name <<
+                std::right << std::setw(12) << r.rate << " req/s" <<
+                std::right << std::setw(12) << r.memory << " B/conn" <<
+                std::right << std::setw(10) << std::fixed <<
+                    std::setprecision(2) << r.allocs << " new/req" <<
+                std::endl;
+        }
+    }
+
+    void
+    run() override
+    {
+        static std::size_t constexpr trials = 3;
+        static std::size_t constexpr requests = 20000;
+        log << std::endl;
+        for(auto const& param : {
+            std::make_pair(1, 64),
+            std::make_pair(100, 64),
+            std::make_pair(1000, 64) })
+        {
+            auto const name = std::to_string(param.first) + ", " +
+                std::to_string(param.second);
+            auto const n = requests / param.first;
+            log << "connections, body: " << name << std::endl;
+            do_trials("spawn", trials, stackful{},
+                param.first, param.second, n);
+#if BOOST_BEAST_HAS_CO_AWAIT
+            do_trials("use_awaiter", trials, awaiting{},
+                param.first, param.second, n);
+#endif
+            log << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,coro);
+
+} // beast
+} // boost
@@ -331,10 +331,70 @@ public:
         pass();
     }
 
+    // Many small chunks, as streamed by event sources
+    template<class Parser>
+    void
+    testChunks(std::size_t repeat,
+        flat_buffer const& b, bool coalesce)
+    {
+        while(repeat--)
+        {
+            Parser p;
+            p.eager(true);
+            p.coalesce_chunks(coalesce);
+            p.body_limit((std::numeric_limits<std::uint64_t>::max)());
+            error_code ec;
+            feed(b.data(), p, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                break;
+            BEAST_EXPECT(p.is_done());
+        }
+    }
+
+    void
+    testChunkSpeed()
+    {
+        static std::size_t constexpr Trials = 5;
+        static std::size_t constexpr Repeat = 100;
+        static std::size_t constexpr Chunks = 10000;
+
+        flat_buffer b;
+        ostream(b) <<
+            "HTTP/1.1 200 OK\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n";
+        std::string const event(512, '*');
+        for(std::size_t i = 0; i < Chunks; ++i)
+        {
+            // sizes from 1 to 400, in no particular order
+            auto const n = 1 + (i * 7919) % 400;
+            ostream(b) << std::hex << n << "\r\n" <<
+                event.substr(0, n) << "\r\n";
+        }
+        ostream(b) << "0\r\n\r\n";
+
+        testcase << "Chunk speed test, " <<
+            Repeat << " messages of " << Chunks << " chunks";
+
+        using parser_type = response_parser<string_body>;
+        timedTest(Trials, "chunk per callback",
+            [&]
+            {
+                testChunks<parser_type>(Repeat, b, false);
+            });
+        timedTest(Trials, "coalesce_chunks",
+            [&]
+            {
+                testChunks<parser_type>(Repeat, b, true);
+            });
+        pass();
+    }
+
     void run() override
     {
         pass();
         testSpeed();
+        testChunkSpeed();
     }
 };
 
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/*  Compares the serializer's default output, a sequence of
+    buffers per message, against the flattened output, one
+    buffer per message copied into the serializer's scratch.
+
+    For each body size this reports the number of buffers the
+    stream receives per message, and the rate at which whole
+    messages are written to a local socket.
+*/
+class serializer_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    struct count_lambda
+    {
+        std::size_t count = 0;
+        std::size_t size = 0;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            for(auto it = net::buffer_sequence_begin(buffers);
+                it != net::buffer_sequence_end(buffers); ++it)
+                ++count;
+            size = buffer_bytes(buffers);
+        }
+    };
+
+    static
+    response<string_body>
+    make_response(std::size_t size, bool chunked)
+    {
+        response<string_body> res{status::ok, 11};
+        res.set(field::server, "Beast");
+        res.set(field::date, "Thu, 01 Jan 1970 00:00:00 GMT");
+        res.set(field::content_type, "application/json");
+        res.set(field::cache_control, "no-cache");
+        res.body().assign(size, '*');
+        res.chunked(chunked);
+        res.prepare_payload();
+        return res;
+    }
+
+    // Returns the number of buffers handed to the stream
+    static
+    std::size_t
+    count_buffers(
+        response<string_body> const& res,
+        std::size_t flatten)
+    {
+        count_lambda visit;
+        error_code ec;
+        response_serializer<string_body> sr{res};
+        sr.flatten_limit(flatten);
+        do
+        {
+            sr.next(ec, visit);
+            sr.consume(visit.size);
+        }
+        while(! sr.is_done());
+        return visit.count;
+    }
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    // Returns messages per second
+    size_type
+    do_write(
+        response<string_body> const& res,
+        std::size_t flatten,
+        std::size_t repeat)
+    {
+        using socket_type =
+            net::local::stream_protocol::socket;
+        net::io_context ioc;
+        socket_type s1{ioc}, s2{ioc};
+        net::local::connect_pair(s1, s2);
+        std::thread t(
+            [&]
+            {
+                std::vector<char> v(65536);
+                error_code ec;
+                for(;;)
+                {
+                    s2.read_some(net::buffer(v), ec);
+                    if(ec)
+                        break;
+                }
+            });
+        timer tm;
+        for(auto i = repeat; i--;)
+        {
+            response_serializer<string_body> sr{res};
+            sr.flatten_limit(flatten);
+            write(s1, sr);
+        }
+        auto const elapsed = tm.elapsed();
+        s1.shutdown(socket_type::shutdown_send);
+        t.join();
+        return static_cast<size_type>(repeat /
+            std::chrono::duration<double>(elapsed).count());
+    }
+#endif
+
+    void
+    do_sizes(bool chunked)
+    {
+        static std::size_t constexpr repeat = 50000;
+        static std::size_t constexpr flatten = 65536;
+        log <<
+            std::left << std::setw(16) <<
+                (chunked ? "chunked body" : "body") <<
+            std::right << std::setw(12) << "buffers" <<
+            std::right << std::setw(12) << "flat" <<
+        #ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+            std::right << std::setw(14) << "msg/s" <<
+            std::right << std::setw(14) << "flat msg/s" <<
+        #endif
+            std::endl;
+        for(std::size_t size :
+            {0, 16, 64, 256, 1024, 4096, 16384, 65536 - 512})
+        {
+            auto const res = make_response(size, chunked);
+            log <<
+                std::left << std::setw(16) << size <<
+                std::right << std::setw(12) <<
+                    count_buffers(res, 0) <<
+                std::right << std::setw(12) <<
+                    count_buffers(res, flatten);
+            log.flush();
+        #ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+            log <<
+                std::right << std::setw(14) <<
+                    do_write(res, 0, repeat) <<
+                std::right << std::setw(14) <<
+                    do_write(res, flatten, repeat);
+        #endif
+            log << std::endl;
+        }
+        log << std::endl;
+    }
+
+    void
+    run() override
+    {
+        log << std::endl;
+        do_sizes(false);
+        do_sizes(true);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,serializer);
+
+} // http
+} // beast
+} // boost
@@ -0,0 +1,315 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/_experimental/core/uring_stream.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+/*  Loopback HTTP/1.1 keep-alive requests per second, with the
+    client and server on one io_context, using tcp_stream or
+    uring_stream for both ends.
+*/
+class uring_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+    using tcp = net::ip::tcp;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    inline
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        using namespace std::chrono;
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    // Echoes each request body
+    template<class Stream>
+    struct server_session
+        : std::enable_shared_from_this<server_session<Stream>>
+    {
+        Stream stream;
+        flat_buffer buffer;
+        http::request<http::string_body> req;
+        http::response<http::string_body> res;
+
+        explicit
+        server_session(net::io_context& ioc)
+            : stream(ioc)
+        {
+        }
+
+        void
+        do_read()
+        {
+            req = {};
+            http::async_read(stream, buffer, req,
+                bind_front_handler(&server_session::on_read,
+                    this->shared_from_this()));
+        }
+
+        void
+        on_read(error_code ec, std::size_t)
+        {
+            if(ec)
+                return;
+            res.result(http::status::ok);
+            res.version(11);
+            res.body() = std::move(req.body());
+            res.prepare_payload();
+            http::async_write(stream, res,
+                bind_front_handler(&server_session::on_write,
+                    this->shared_from_this()));
+        }
+
+        void
+        on_write(error_code ec, std::size_t)
+        {
+            if(! ec)
+                do_read();
+        }
+    };
+
+    template<class Stream>
+    struct client_session
+        : std::enable_shared_from_this<client_session<Stream>>
+    {
+        Stream stream;
+        flat_buffer buffer;
+        http::request<http::string_body> req;
+        http::response<http::string_body> res;
+        std::size_t left;
+        size_type& done;
+
+        client_session(net::io_context& ioc,
+            std::size_t body, std::size_t repeat, size_type& done_)
+            : stream(ioc)
+            , req(http::verb::post, "/", 11)
+            , left(repeat)
+            , done(done_)
+        {
+            req.set(http::field::host, "localhost");
+            req.body() = std::string(body, '*');
+            req.prepare_payload();
+        }
+
+        void
+        do_write()
+        {
+            http::async_write(stream, req,
+                bind_front_handler(&client_session::on_write,
+                    this->shared_from_this()));
+        }
+
+        void
+        on_write(error_code ec, std::size_t)
+        {
+            if(ec)
+                return;
+            res = {};
+            http::async_read(stream, buffer, res,
+                bind_front_handler(&client_session::on_read,
+                    this->shared_from_this()));
+        }
+
+        void
+        on_read(error_code ec, std::size_t)
+        {
+            if(ec)
+                return;
+            ++done;
+            if(--left > 0)
+                return do_write();
+            stream.socket().shutdown(
+                tcp::socket::shutdown_both, ec);
+        }
+    };
+
+    struct no_setup
+    {
+        template<class Stream>
+        void
+        operator()(Stream&) const
+        {
+        }
+    };
+
+    template<class Stream, class Setup>
+    size_type
+    do_requests(std::size_t connections,
+        std::size_t body, std::size_t repeat, Setup const& setup)
+    {
+        net::io_context ioc;
+        tcp::acceptor a(ioc, {net::ip::address_v4::loopback(), 0});
+        size_type done = 0;
+        std::vector<std::shared_ptr<client_session<Stream>>> v;
+        for(std::size_t i = 0; i < connections; ++i)
+        {
+            auto c = std::make_shared<client_session<Stream>>(
+                ioc, body, repeat, done);
+            auto s = std::make_shared<server_session<Stream>>(ioc);
+            c->stream.socket().connect(a.local_endpoint());
+            a.accept(s->stream.socket());
+            c->stream.socket().set_option(tcp::no_delay(true));
+            s->stream.socket().set_option(tcp::no_delay(true));
+            setup(c->stream);
+            setup(s->stream);
+            s->do_read();
+            v.emplace_back(std::move(c));
+        }
+        timer t;
+        for(auto& c : v)
+            c->do_write();
+        v.clear();
+        ioc.run();
+        BEAST_EXPECT(done == connections * repeat);
+        return throughput(t.elapsed(), done);
+    }
+
+    static
+    inline
+    void
+    do_trials_1(bool)
+    {
+    }
+
+    template<class F0, class... FN>
+    void
+    do_trials_1(bool print, F0&& f, FN... fn)
+    {
+        if(print)
+        {
+            log << std::right << std::setw(12) <<
+                f() << " req/s";
+            log.flush();
+        }
+        else
+        {
+            f();
+        }
+        do_trials_1(print, fn...);
+    }
+
+    template<class F0, class... FN>
+    void
+    do_trials(string_view name,
+        std::size_t trials, F0&& f0, FN... fn)
+    {
+        using namespace std::chrono;
+        // warm-up
+        do_trials_1(false, f0, fn...);
+        while(trials--)
+        {
+            timer t;
+            log << std::left << std::setw(24) << name << ":";
+            log.flush();
+            do_trials_1(true, f0, fn...);
+            log << "   " <<
+                duration_cast<milliseconds>(t.elapsed()).count() << "ms";
+            log << std::endl;
+        }
+    }
+
+    void
+    run() override
+    {
+#if BOOST_BEAST_HAS_IO_URING
+        try
+        {
+            net::io_context ioc;
+            uring_stream s(ioc);
+        }
+        catch(system_error const& e)
+        {
+            log << "io_uring unavailable: " << e.what() << std::endl;
+            pass();
+            return;
+        }
+
+        static std::size_t constexpr trials = 3;
+        static std::size_t constexpr repeat = 20000;
+        auto const none = no_setup{};
+        auto const multishot =
+            [](uring_stream& s)
+            {
+                s.multishot(true);
+            };
+        log << std::endl;
+        log << std::left << std::setw(24) << "connections, body" << " " <<
+            std::right << std::setw(18) << "tcp_stream" <<
+            std::right << std::setw(18) << "uring_stream" <<
+            std::right << std::setw(18) << "multishot" <<
+            std::endl;
+        for(auto const& param : {
+            std::make_pair(1, 64),
+            std::make_pair(16, 64),
+            std::make_pair(16, 16384) })
+        {
+            auto const name = std::to_string(param.first) + ", " +
+                std::to_string(param.second);
+            auto const n = repeat / param.first;
+            do_trials(name, trials,
+                 [&](){ return do_requests<tcp_stream>(
+                    param.first, param.second, n, none); }
+                ,[&](){ return do_requests<uring_stream>(
+                    param.first, param.second, n, none); }
+                ,[&](){ return do_requests<uring_stream>(
+                    param.first, param.second, n, multishot); }
+            );
+        }
+        log << std::endl;
+#endif
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,uring);
+
+} // beast
+} // boost
@@ -0,0 +1,442 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+//------------------------------------------------------------------------------
+//
+// bench-zlib-corpus
+//
+//  Compress a set of corpus files with Beast's zlib and with the reference
+//  zlib across a matrix of levels, window sizes and memory levels, and
+//  print speed, ratio and peak memory as CSV.
+//
+//  Usage: bench-zlib-corpus [options] <file>...
+//
+//  Pass a directory of corpus files as a glob, for example `corpus/*`.
+//
+//  Options:
+//      --level=<lo>[-<hi>]     Compression levels, default 1-9
+//      --wbits=<lo>[-<hi>]     Window bits, default 9-15
+//      --mem=<lo>[-<hi>]       Memory levels, default 1-9
+//      --time=<ms>             Minimum time per measurement, default 100
+//
+//------------------------------------------------------------------------------
+
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "zlib-1.2.11/zlib.h"
+
+namespace beast = boost::beast;         // from <boost/beast.hpp>
+namespace zlib = beast::zlib;           // from <boost/beast/zlib.hpp>
+
+namespace {
+
+//------------------------------------------------------------------------------
+//
+// Heap accounting
+//
+//  Every allocation, through operator new for Beast and through the
+//  zalloc hook for zlib, is counted so that the peak number of bytes
+//  in use by a stream can be reported.
+//
+//------------------------------------------------------------------------------
+
+std::size_t heap_current = 0;
+std::size_t heap_peak = 0;
+
+// Room for the size in front of each block, preserving alignment
+std::size_t constexpr heap_header = alignof(std::max_align_t);
+
+void*
+heap_alloc(std::size_t n)
+{
+    auto p = static_cast<char*>(std::malloc(n + heap_header));
+    if(! p)
+        return nullptr;
+    *reinterpret_cast<std::size_t*>(p) = n;
+    heap_current += n;
+    if(heap_peak < heap_current)
+        heap_peak = heap_current;
+    return p + heap_header;
+}
+
+void
+heap_free(void* p)
+{
+    if(! p)
+        return;
+    auto const h = static_cast<char*>(p) - heap_header;
+    heap_current -= *reinterpret_cast<std::size_t*>(h);
+    std::free(h);
+}
+
+// Start measuring the peak from the current usage
+void
+heap_mark()
+{
+    heap_peak = heap_current;
+}
+
+// Return the peak usage since the mark
+std::size_t
+heap_since(std::size_t base)
+{
+    return heap_peak - base;
+}
+
+voidpf
+zalloc_hook(voidpf, uInt items, uInt size)
+{
+    return heap_alloc(std::size_t{items} * size);
+}
+
+void
+zfree_hook(voidpf, voidpf p)
+{
+    heap_free(p);
+}
+
+} // (anon)
+
+void*
+operator new(std::size_t n)
+{
+    if(auto p = heap_alloc(n > 0 ? n : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+    heap_free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    heap_free(p);
+}
+
+namespace {
+
+//------------------------------------------------------------------------------
+
+struct range
+{
+    int lo;
+    int hi;
+};
+
+struct settings
+{
+    int level;
+    int wbits;
+    int mem;
+};
+
+struct result
+{
+    std::size_t out_size = 0;
+    double deflate_mbps = 0;
+    double inflate_mbps = 0;
+    std::size_t deflate_peak = 0;
+    std::size_t inflate_peak = 0;
+    bool ok = false;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+// Run f until at least `min_time` has passed,
+// returning the seconds per call.
+template<class F>
+double
+measure(F const& f, std::chrono::milliseconds min_time)
+{
+    std::size_t n = 0;
+    auto const start = clock_type::now();
+    clock_type::duration elapsed;
+    do
+    {
+        f();
+        ++n;
+        elapsed = clock_type::now() - start;
+    }
+    while(elapsed < min_time);
+    return std::chrono::duration<double>(elapsed).count() / n;
+}
+
+//------------------------------------------------------------------------------
+
+std::string
+beast_deflate(std::string const& in, settings const& s)
+{
+    zlib::deflate_stream ds;
+    ds.reset(s.level, s.wbits, s.mem, zlib::Strategy::normal);
+    std::string out;
+    out.resize(ds.upper_bound(in.size()));
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    zs.next_out = &out[0];
+    zs.avail_out = out.size();
+    beast::error_code ec;
+    ds.write(zs, zlib::Flush::finish, ec);
+    if(ec != zlib::error::end_of_stream)
+        throw beast::system_error{ec};
+    out.resize(zs.total_out);
+    return out;
+}
+
+void
+beast_inflate(
+    std::string const& in, std::string& out, settings const& s)
+{
+    zlib::inflate_stream is;
+    is.reset(s.wbits);
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    zs.next_out = &out[0];
+    zs.avail_out = out.size();
+    beast::error_code ec;
+    is.write(zs, zlib::Flush::finish, ec);
+    if(ec != zlib::error::end_of_stream)
+        throw beast::system_error{ec};
+    out.resize(zs.total_out);
+}
+
+std::string
+zlib_deflate(std::string const& in, settings const& s)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    zs.zalloc = &zalloc_hook;
+    zs.zfree = &zfree_hook;
+    if(deflateInit2(&zs, s.level, Z_DEFLATED,
+            -s.wbits, s.mem, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::logic_error{"deflateInit2 failed"};
+    std::string out;
+    out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = (Bytef*)&out[0];
+    zs.avail_out = static_cast<uInt>(out.size());
+    auto const result = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    if(result != Z_STREAM_END)
+        throw std::logic_error{"deflate failed"};
+    return out;
+}
+
+void
+zlib_inflate(
+    std::string const& in, std::string& out, settings const& s)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    zs.zalloc = &zalloc_hook;
+    zs.zfree = &zfree_hook;
+    if(inflateInit2(&zs, -s.wbits) != Z_OK)
+        throw std::logic_error{"inflateInit2 failed"};
+    zs.next_in = (Bytef*)in.data();
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = (Bytef*)&out[0];
+    zs.avail_out = static_cast<uInt>(out.size());
+    auto const result = inflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    inflateEnd(&zs);
+    if(result != Z_STREAM_END)
+        throw std::logic_error{"inflate failed"};
+}
+
+// The peaks include the size of the stream objects,
+// since Beast keeps much of its state inline.
+template<class Deflate, class Inflate>
+result
+run_one(
+    std::string const& in,
+    settings const& s,
+    std::chrono::milliseconds min_time,
+    Deflate const& def,
+    Inflate const& inf,
+    std::size_t deflate_object,
+    std::size_t inflate_object)
+{
+    result r;
+    std::string out;
+    std::string check;
+
+    auto base = heap_current;
+    heap_mark();
+    out = def(in, s);
+    r.deflate_peak =
+        heap_since(base) - out.capacity() + deflate_object;
+    r.out_size = out.size();
+
+    check.resize(in.size());
+    base = heap_current;
+    heap_mark();
+    inf(out, check, s);
+    r.inflate_peak = heap_since(base) + inflate_object;
+    r.ok = check == in;
+
+    auto const mb = in.size() / 1e6;
+    r.deflate_mbps = mb / measure(
+        [&]
+        {
+            out = def(in, s);
+        }, min_time);
+    r.inflate_mbps = mb / measure(
+        [&]
+        {
+            check.resize(in.size());
+            inf(out, check, s);
+        }, min_time);
+    return r;
+}
+
+void
+print(
+    std::string const& name,
+    char const* impl,
+    std::size_t size,
+    settings const& s,
+    result const& r)
+{
+    std::cout <<
+        name << ',' <<
+        impl << ',' <<
+        s.level << ',' <<
+        s.wbits << ',' <<
+        s.mem << ',' <<
+        size << ',' <<
+        r.out_size << ',' <<
+        (r.out_size ? double(size) / r.out_size : 0.) << ',' <<
+        r.deflate_mbps << ',' <<
+        r.inflate_mbps << ',' <<
+        r.deflate_peak << ',' <<
+        r.inflate_peak << ',' <<
+        (r.ok ? "ok" : "mismatch") <<
+        std::endl;
+}
+
+std::string
+read_file(char const* path)
+{
+    beast::error_code ec;
+    beast::file f;
+    f.open(path, beast::file_mode::scan, ec);
+    if(ec)
+        throw beast::system_error{ec, path};
+    std::string s;
+    s.resize(static_cast<std::size_t>(f.size(ec)));
+    if(! ec && ! s.empty())
+        f.read(&s[0], s.size(), ec);
+    if(ec)
+        throw beast::system_error{ec, path};
+    return s;
+}
+
+bool
+parse_range(beast::string_view arg, beast::string_view name, range& r)
+{
+    if(! arg.starts_with(name))
+        return false;
+    std::string const v(arg.substr(name.size()));
+    auto const dash = v.find('-');
+    r.lo = std::atoi(v.c_str());
+    r.hi = dash == std::string::npos ?
+        r.lo : std::atoi(v.c_str() + dash + 1);
+    return true;
+}
+
+} // (anon)
+
+int
+main(int argc, char** argv)
+{
+    range level{1, 9};
+    range wbits{9, 15};
+    range mem{1, 9};
+    std::chrono::milliseconds min_time{100};
+    std::vector<char const*> files;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        beast::string_view const arg = argv[i];
+        if( parse_range(arg, "--level=", level) ||
+            parse_range(arg, "--wbits=", wbits) ||
+            parse_range(arg, "--mem=", mem))
+            continue;
+        if(arg.starts_with("--time="))
+        {
+            min_time = std::chrono::milliseconds(
+                std::atoi(argv[i] + 7));
+            continue;
+        }
+        if(arg.starts_with("--"))
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+        files.push_back(argv[i]);
+    }
+    if( files.empty() ||
+        level.lo < 0 || level.hi > 9 || level.lo > level.hi ||
+        wbits.lo < 9 || wbits.hi > 15 || wbits.lo > wbits.hi ||
+        mem.lo < 1 || mem.hi > 9 || mem.lo > mem.hi)
+    {
+        std::cerr <<
+            "Usage: bench-zlib-corpus [--level=0-9] [--wbits=9-15] "
+            "[--mem=1-9] [--time=ms] <file>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        std::cout <<
+            "file,impl,level,wbits,memlevel,in_bytes,out_bytes,ratio,"
+            "deflate_mbps,inflate_mbps,deflate_peak_bytes,"
+            "inflate_peak_bytes,check" << std::endl;
+        for(auto const path : files)
+        {
+            auto const in = read_file(path);
+            for(settings s{level.lo, 0, 0}; s.level <= level.hi; ++s.level)
+            for(s.wbits = wbits.lo; s.wbits <= wbits.hi; ++s.wbits)
+            for(s.mem = mem.lo; s.mem <= mem.hi; ++s.mem)
+            {
+                print(path, "beast", in.size(), s, run_one(
+                    in, s, min_time, &beast_deflate, &beast_inflate,
+                    sizeof(zlib::deflate_stream),
+                    sizeof(zlib::inflate_stream)));
+                print(path, "zlib", in.size(), s, run_one(
+                    in, s, min_time, &zlib_deflate, &zlib_inflate,
+                    sizeof(z_stream), sizeof(z_stream)));
+            }
+        }
+    }
+    catch(std::exception const& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
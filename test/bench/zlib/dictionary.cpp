@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/test/throughput.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/*  Measures what a preset dictionary gains on short messages which
+    resemble each other, compressing each message on its own as
+    permessage-deflate does without context takeover.
+*/
+class dictionary_test : public beast::unit_test::suite
+{
+public:
+    // Small JSON documents with the same structure
+    static
+    std::vector<std::string>
+    corpus(std::size_t n)
+    {
+        static char const* const symbols[] = {
+            "BEAST", "ASIO", "BOOST", "HTTP", "ZLIB", "JSON" };
+        static char const* const sides[] = { "buy", "sell" };
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d0{0, 5};
+        std::uniform_int_distribution<int> d1{0, 1};
+        std::uniform_int_distribution<int> d2{1, 99999};
+        std::vector<std::string> v;
+        v.reserve(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v.push_back(
+                "{\"id\":" + std::to_string(1000000 + i) +
+                ",\"type\":\"trade\",\"symbol\":\"" + symbols[d0(g)] +
+                "\",\"side\":\"" + sides[d1(g)] +
+                "\",\"price\":" + std::to_string(d2(g)) +
+                ",\"size\":" + std::to_string(d2(g) % 1000) +
+                ",\"exchange\":\"example\",\"timestamp\":\"2019-06-" +
+                std::to_string(10 + d0(g)) + "T12:00:00.000Z\"}");
+        return v;
+    }
+
+    static
+    std::string
+    compress(
+        deflate_stream& ds,
+        std::string const& dict,
+        std::string const& in)
+    {
+        ds.reset();
+        error_code ec;
+        if(! dict.empty())
+            ds.set_dictionary(dict.data(), dict.size(), ec);
+        std::string out;
+        out.resize(ds.upper_bound(in.size()));
+        z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        ds.write(zs, Flush::finish, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    static
+    std::string
+    decompress(
+        inflate_stream& is,
+        std::string const& dict,
+        std::string const& in,
+        std::size_t size)
+    {
+        is.reset();
+        error_code ec;
+        if(! dict.empty())
+            is.set_dictionary(dict.data(), dict.size(), ec);
+        std::string out;
+        out.resize(size);
+        z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        is.write(zs, Flush::finish, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    void
+    doBench(
+        string_view name,
+        std::string const& dict,
+        std::vector<std::string> const& v)
+    {
+        deflate_stream ds;
+        inflate_stream is;
+        std::size_t in = 0;
+        std::size_t out = 0;
+        test::timer t;
+        for(auto const& s : v)
+        {
+            auto const c = compress(ds, dict, s);
+            BEAST_EXPECT(decompress(is, dict, c, s.size()) == s);
+            in += s.size();
+            out += c.size();
+        }
+        auto const elapsed = t.elapsed();
+        log <<
+            std::left << std::setw(14) << name <<
+            std::right << std::setw(10) << in <<
+            std::right << std::setw(10) << out <<
+            std::right << std::setw(10) << std::fixed <<
+                std::setprecision(2) << double(in) / out <<
+            std::right << std::setw(14) <<
+                test::throughput(elapsed, in) << " B/s" <<
+            std::endl;
+    }
+
+    void
+    run() override
+    {
+        auto const v = corpus(10000);
+        // The dictionary is a few sample messages,
+        // as an application would ship with both peers.
+        auto const samples = corpus(16);
+        std::string dict;
+        for(auto const& s : samples)
+            dict += s;
+
+        log <<
+            std::left << std::setw(14) << "" <<
+            std::right << std::setw(10) << "In" <<
+            std::right << std::setw(10) << "Out" <<
+            std::right << std::setw(10) << "Ratio" <<
+            std::endl;
+        doBench("none", {}, v);
+        doBench("1 message", samples.front(), v);
+        doBench("16 messages", dict, v);
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,zlib,dictionary);
+
+} // zlib
+} // beast
+} // boost
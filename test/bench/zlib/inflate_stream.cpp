@@ -15,6 +15,7 @@
 #include <iomanip>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "zlib-1.2.11/zlib.h"
 
@@ -222,6 +223,103 @@ public:
         log << std::endl;
     }
 
+    // Short JSON text messages of about n bytes each
+    static
+    std::vector<std::string>
+    messages(std::size_t n, std::size_t count)
+    {
+        static char const* const words[] = {
+            "\"id\":", "\"type\":\"update\",", "\"name\":\"beast\",",
+            "\"price\":", "\"size\":", "\"items\":[", "],",
+            "{", "}", "\"ok\":true,", "\"ok\":false," };
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d0{0, 10};
+        std::uniform_int_distribution<int> d1{0, 99999};
+        std::vector<std::string> v;
+        v.reserve(count);
+        while(v.size() < count)
+        {
+            std::string s;
+            while(s.size() < n)
+            {
+                s += words[d0(g)];
+                s += std::to_string(d1(g));
+                s += ',';
+            }
+            s.resize(n);
+            v.push_back(std::move(s));
+        }
+        return v;
+    }
+
+    /*  Inflates many short messages which were compressed one
+        at a time, reusing the stream as permessage-deflate does
+        without context takeover. Setting up the stream and the
+        tables of each block dominates, unlike in doCorpus.
+    */
+    void
+    doSmall(std::size_t size, std::size_t count)
+    {
+        std::size_t constexpr trials = 3;
+        auto const v = messages(size, count);
+        std::vector<std::string> in;
+        in.reserve(v.size());
+        for(auto const& s : v)
+            in.push_back(compress(s));
+        std::string out;
+        out.resize(size);
+        log <<
+            std::left << std::setw(10) << (std::to_string(size) + "B") <<
+            std::right << std::setw(12) << "Beast" << "     " <<
+            std::right << std::setw(12) << "ZLib" <<
+                std::endl;
+        for(std::size_t i = 0; i < trials; ++i)
+        {
+            log << std::left << std::setw(10) << "messages";
+            inflate_stream is;
+            test::timer t;
+            for(std::size_t j = 0; j < in.size(); ++j)
+            {
+                is.reset();
+                z_params zs;
+                zs.next_in = in[j].data();
+                zs.avail_in = in[j].size();
+                zs.next_out = &out[0];
+                zs.avail_out = out.size();
+                error_code ec;
+                is.write(zs, Flush::sync, ec);
+                BEAST_EXPECT(string_view(out.data(),
+                    zs.total_out) == v[j]);
+            }
+            auto const t1 =
+                test::throughput(t.elapsed(), size * count);
+            log << std::right << std::setw(12) << t1 << " B/s ";
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            inflateInit2(&zs, -15);
+            t = test::timer{};
+            for(std::size_t j = 0; j < in.size(); ++j)
+            {
+                inflateReset(&zs);
+                zs.next_in = (Bytef*)in[j].data();
+                zs.avail_in = static_cast<uInt>(in[j].size());
+                zs.next_out = (Bytef*)&out[0];
+                zs.avail_out = static_cast<uInt>(out.size());
+                inflate(&zs, Z_SYNC_FLUSH);
+                BEAST_EXPECT(string_view(out.data(),
+                    zs.total_out) == v[j]);
+            }
+            inflateEnd(&zs);
+            auto const t2 =
+                test::throughput(t.elapsed(), size * count);
+            log << std::right << std::setw(12) << t2 << " B/s";
+            log << std::right << std::setw(12) <<
+                int(double(t1)*100/t2-100) << "%";
+            log << std::endl;
+        }
+        log << std::endl;
+    }
+
     void
     doBench()
     {
@@ -234,6 +332,10 @@ public:
     run() override
     {
         doBench();
+        doSmall(   64, 200000);
+        doSmall(  256, 100000);
+        doSmall( 1024,  50000);
+        doSmall( 4096,  20000);
         pass();
     }
 };
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/zlib/detail/slide_hash.hpp>
+#include <boost/beast/test/throughput.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/*  Measures the cost of sliding the hash chains, which deflate_stream
+    does on every advance of its window, in isolation from the rest of
+    compression. The tables are sized as for memLevel 8: a 32K entry
+    head table plus one prev entry per byte of the window.
+*/
+class slide_hash_test : public beast::unit_test::suite
+{
+public:
+    // The loop deflate_stream used before slide_hash
+    static
+    void
+    slide_scalar(std::uint16_t* p, std::size_t n, std::uint16_t wsize)
+    {
+        p += n;
+        do
+        {
+            unsigned const m = *--p;
+            *p = (std::uint16_t)(m >= wsize ? m-wsize : 0);
+        }
+        while(--n);
+    }
+
+    template<class F>
+    double
+    ns_per_slide(
+        F const& f,
+        std::vector<std::uint16_t>& head,
+        std::vector<std::uint16_t>& prev,
+        std::uint16_t wsize,
+        std::size_t repeat)
+    {
+        test::timer t;
+        for(auto i = repeat; i--;)
+        {
+            f(head.data(), head.size(), wsize);
+            f(prev.data(), prev.size(), wsize);
+            // keep the next slide from working on zeros
+            head[i % head.size()] |= 0x8000;
+            prev[i % prev.size()] |= 0x8000;
+        }
+        return std::chrono::duration<double, std::nano>(
+            t.elapsed()).count() / repeat;
+    }
+
+    void
+    doBench(int windowBits)
+    {
+        std::size_t constexpr repeat = 20000;
+        std::size_t constexpr hash_size = 1 << 15;
+        auto const wsize =
+            static_cast<std::uint16_t>(1U << windowBits);
+
+        std::mt19937 g;
+        std::uniform_int_distribution<std::uint32_t> d{0, 65535};
+        std::vector<std::uint16_t> head(hash_size);
+        std::vector<std::uint16_t> prev(wsize);
+        for(auto& v : head)
+            v = static_cast<std::uint16_t>(d(g));
+        for(auto& v : prev)
+            v = static_cast<std::uint16_t>(d(g));
+
+        // Both must agree
+        {
+            auto h0 = head;
+            auto h1 = head;
+            slide_scalar(h0.data(), h0.size(), wsize);
+            detail::slide_hash(h1.data(), h1.size(), wsize);
+            BEAST_EXPECT(h0 == h1);
+        }
+
+        auto h0 = head;
+        auto p0 = prev;
+        auto const t0 = ns_per_slide(
+            &slide_scalar, h0, p0, wsize, repeat);
+        auto h1 = head;
+        auto p1 = prev;
+        auto const t1 = ns_per_slide(
+            &detail::slide_hash, h1, p1, wsize, repeat);
+        log <<
+            std::left << std::setw(12) <<
+                ("wbits=" + std::to_string(windowBits)) <<
+            std::right << std::setw(10) << std::fixed <<
+                std::setprecision(0) << t0 << " ns" <<
+            std::right << std::setw(10) << t1 << " ns" <<
+            std::right << std::setw(10) << std::setprecision(1) <<
+                t0 / t1 << "x" <<
+            std::endl;
+    }
+
+    // The instructions detail::slide_hash picks on this machine
+    static
+    char const*
+    path()
+    {
+#if BOOST_BEAST_CPU_DISPATCH
+        if(beast::detail::get_cpu_info().avx2)
+            return "AVX2";
+#endif
+#if defined(BOOST_BEAST_ZLIB_SLIDE_SSE2)
+        return "SSE2";
+#elif defined(BOOST_BEAST_ZLIB_SLIDE_NEON)
+        return "NEON";
+#else
+        return "scalar";
+#endif
+    }
+
+    void
+    run() override
+    {
+        log << "slide_hash uses " << path() << std::endl;
+        log <<
+            std::left << std::setw(12) << "" <<
+            std::right << std::setw(13) << "scalar" <<
+            std::right << std::setw(13) << "slide_hash" <<
+            std::endl;
+        for(int windowBits = 9; windowBits <= 15; ++windowBits)
+            doBench(windowBits);
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,zlib,slide_hash);
+
+} // zlib
+} // beast
+} // boost